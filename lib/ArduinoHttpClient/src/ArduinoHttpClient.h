@@ -6,6 +6,9 @@
 #define ArduinoHttpClient_h
 
 #include "HttpClient.h"
+#include "HttpConnectionPool.h"
+#include "HttpRangeDownloader.h"
+#include "HttpInflater.h"
 #include "WebSocketClient.h"
 #include "URLEncoder.h"
 
@@ -11,8 +11,8 @@ const char* HttpClient::kContentLengthPrefix = HTTP_HEADER_CONTENT_LENGTH ": ";
 const char* HttpClient::kTransferEncodingChunked = HTTP_HEADER_TRANSFER_ENCODING ": " HTTP_HEADER_VALUE_CHUNKED;
 
 HttpClient::HttpClient(Client& aClient, const char* aServerName, uint16_t aServerPort)
- : iClient(&aClient), iServerName(aServerName), iServerAddress(), iServerPort(aServerPort),
-   iConnectionClose(true), iSendDefaultRequestHeaders(true)
+ : iClient(&aClient), iPool(NULL), iServerName(aServerName), iServerAddress(), iServerPort(aServerPort),
+   iConnectionClose(true), iSendDefaultRequestHeaders(true), iInflater(NULL)
 {
   resetState();
 }
@@ -23,12 +23,32 @@ HttpClient::HttpClient(Client& aClient, const String& aServerName, uint16_t aSer
 }
 
 HttpClient::HttpClient(Client& aClient, const IPAddress& aServerAddress, uint16_t aServerPort)
- : iClient(&aClient), iServerName(NULL), iServerAddress(aServerAddress), iServerPort(aServerPort),
-   iConnectionClose(true), iSendDefaultRequestHeaders(true)
+ : iClient(&aClient), iPool(NULL), iServerName(NULL), iServerAddress(aServerAddress), iServerPort(aServerPort),
+   iConnectionClose(true), iSendDefaultRequestHeaders(true), iInflater(NULL)
 {
   resetState();
 }
 
+HttpClient::HttpClient(HttpConnectionPool& aPool, const char* aServerName, uint16_t aServerPort)
+ : iClient(NULL), iPool(&aPool), iServerName(aServerName), iServerAddress(), iServerPort(aServerPort),
+   iConnectionClose(false), iSendDefaultRequestHeaders(true), iInflater(NULL)
+{
+  resetState();
+}
+
+HttpClient::HttpClient(HttpConnectionPool& aPool, const String& aServerName, uint16_t aServerPort)
+ : HttpClient(aPool, aServerName.c_str(), aServerPort)
+{
+}
+
+HttpClient::~HttpClient()
+{
+  if (iPool)
+  {
+    releaseConnection();
+  }
+}
+
 void HttpClient::resetState()
 {
   iState = eIdle;
@@ -39,15 +59,41 @@ void HttpClient::resetState()
   iTransferEncodingChunkedPtr = kTransferEncodingChunked;
   iIsChunked = false;
   iChunkLength = 0;
+  iInChunkExtension = false;
+  iDecoding = false;
   iHttpResponseTimeout = kHttpResponseTimeout;
+  iReadAheadPos = 0;
+  iReadAheadLen = 0;
 }
 
 void HttpClient::stop()
 {
-  iClient->stop();
+  if (iPool)
+  {
+    releaseConnection();
+  }
+  else
+  {
+    iClient->stop();
+  }
   resetState();
 }
 
+void HttpClient::releaseConnection()
+{
+  if (!iClient)
+  {
+    return;
+  }
+  // Only a response read up to its known end leaves the connection
+  // ready for the next request
+  bool reusable = endOfHeadersReached() &&
+                  (iContentLength != kNoContentLengthHeader) &&
+                  (iBodyLengthConsumed >= iContentLength);
+  iPool->release(iClient, reusable);
+  iClient = NULL;
+}
+
 void HttpClient::connectionKeepAlive()
 {
   iConnectionClose = false;
@@ -60,6 +106,13 @@ void HttpClient::noDefaultRequestHeaders()
 
 void HttpClient::beginRequest()
 {
+  if (endOfHeadersReached())
+  {
+    // Keep-alive: drop what is left of the previous response first, as
+    // startRequest() would
+    flushClientRx();
+    resetState();
+  }
   iState = eRequestStarted;
 }
 
@@ -80,6 +133,18 @@ int HttpClient::startRequest(const char* aURLPath, const char* aHttpMethod,
         return HTTP_ERROR_API;
     }
 
+    if (iPool && !iClient)
+    {
+        iClient = iPool->lease(iServerName, iServerPort);
+        if (!iClient)
+        {
+#ifdef LOGGING
+            Serial.println("No free connection in pool");
+#endif
+            return HTTP_ERROR_CONNECTION_FAILED;
+        }
+    }
+
     if (iConnectionClose || !iClient->connected())
     {
         if (iServerName)
@@ -89,6 +154,10 @@ int HttpClient::startRequest(const char* aURLPath, const char* aHttpMethod,
 #ifdef LOGGING
                 Serial.println("Connection failed");
 #endif
+                if (iPool)
+                {
+                    releaseConnection();
+                }
                 return HTTP_ERROR_CONNECTION_FAILED;
             }
         }
@@ -172,6 +241,11 @@ int HttpClient::sendInitialHeaders(const char* aURLPath, const char* aHttpMethod
         sendHeader(HTTP_HEADER_USER_AGENT, kUserAgent);
     }
 
+    if (iInflater)
+    {
+        sendHeader(HTTP_HEADER_ACCEPT_ENCODING, "gzip, deflate");
+    }
+
     if (iConnectionClose)
     {
         // Tell the server to
@@ -186,11 +260,19 @@ int HttpClient::sendInitialHeaders(const char* aURLPath, const char* aHttpMethod
 
 void HttpClient::sendHeader(const char* aHeader)
 {
+    if (!iClient)
+    {
+        return;
+    }
     iClient->println(aHeader);
 }
 
 void HttpClient::sendHeader(const char* aHeaderName, const char* aHeaderValue)
 {
+    if (!iClient)
+    {
+        return;
+    }
     iClient->print(aHeaderName);
     iClient->print(": ");
     iClient->println(aHeaderValue);
@@ -198,6 +280,10 @@ void HttpClient::sendHeader(const char* aHeaderName, const char* aHeaderValue)
 
 void HttpClient::sendHeader(const char* aHeaderName, const int aHeaderValue)
 {
+    if (!iClient)
+    {
+        return;
+    }
     iClient->print(aHeaderName);
     iClient->print(": ");
     iClient->println(aHeaderValue);
@@ -205,6 +291,10 @@ void HttpClient::sendHeader(const char* aHeaderName, const int aHeaderValue)
 
 void HttpClient::sendBasicAuth(const char* aUser, const char* aPassword)
 {
+    if (!iClient)
+    {
+        return;
+    }
     // Send the initial part of this header line
     iClient->print("Authorization: Basic ");
     // Now Base64 encode "aUser:aPassword" and send that
@@ -254,18 +344,73 @@ void HttpClient::sendBasicAuth(const char* aUser, const char* aPassword)
 
 void HttpClient::finishHeaders()
 {
-    iClient->println();
+    if (iClient)
+    {
+        iClient->println();
+    }
     iState = eRequestSent;
 }
 
 void HttpClient::flushClientRx()
 {
-    while (iClient->available())
+    iReadAheadPos = 0;
+    iReadAheadLen = 0;
+    while (iClient && iClient->available())
     {
         iClient->read();
     }
 }
 
+int HttpClient::clientRead()
+{
+    if (iReadAheadPos < iReadAheadLen)
+    {
+        return iReadAhead[iReadAheadPos++];
+    }
+    return iClient ? iClient->read() : -1;
+}
+
+int HttpClient::clientRead(uint8_t *aBuffer, size_t aSize)
+{
+    size_t ret = 0;
+    if (iReadAheadPos < iReadAheadLen)
+    {
+        ret = min(aSize, (size_t)(iReadAheadLen - iReadAheadPos));
+        memcpy(aBuffer, iReadAhead + iReadAheadPos, ret);
+        iReadAheadPos += ret;
+    }
+    if (ret < aSize)
+    {
+        int got = iClient ? iClient->read(aBuffer + ret, aSize - ret) : -1;
+        if (got > 0)
+        {
+            ret += got;
+        }
+        else if (ret == 0)
+        {
+            return got;
+        }
+    }
+    return ret;
+}
+
+bool HttpClient::fillReadAhead()
+{
+    int avail = iClient ? iClient->available() : 0;
+    if (avail <= 0)
+    {
+        return false;
+    }
+    int got = iClient->read(iReadAhead, (avail > kReadAheadSize) ? kReadAheadSize : avail);
+    if (got <= 0)
+    {
+        return false;
+    }
+    iReadAheadPos = 0;
+    iReadAheadLen = got;
+    return true;
+}
+
 void HttpClient::endRequest()
 {
     beginBody();
@@ -504,8 +649,133 @@ int HttpClient::responseStatusCode()
     }
 }
 
+int HttpClient::readHeaders(HeaderCallback aCallback, void* aContext)
+{
+    if (endOfHeadersReached())
+    {
+        return HTTP_SUCCESS;
+    }
+    if (iState < eStatusCodeRead)
+    {
+        return HTTP_ERROR_API;
+    }
+
+    char line[kMaxHeaderLine];
+    int len = 0;
+    unsigned long timeoutStart = millis();
+    while (!endOfHeadersReached())
+    {
+        if (iReadAheadPos >= iReadAheadLen)
+        {
+            if (!fillReadAhead())
+            {
+                if ((millis() - timeoutStart) >= iHttpResponseTimeout)
+                {
+                    return HTTP_ERROR_TIMED_OUT;
+                }
+                delay(1);
+                continue;
+            }
+            timeoutStart = millis();
+        }
+
+        while ((iReadAheadPos < iReadAheadLen) && !endOfHeadersReached())
+        {
+            char c = iReadAhead[iReadAheadPos++];
+            if (c != '\n')
+            {
+                if ((c != '\r') && (len < kMaxHeaderLine - 1))
+                {
+                    line[len++] = c;
+                }
+                continue;
+            }
+            if (len == 0)
+            {
+                // Blank line: the body starts with the next byte
+                if (iIsChunked)
+                {
+                    iState = eReadingChunkLength;
+                    iChunkLength = 0;
+                }
+                else
+                {
+                    iState = eReadingBody;
+                }
+                break;
+            }
+            line[len] = '\0';
+            len = 0;
+
+            char* colon = strchr(line, ':');
+            if (!colon)
+            {
+                continue;
+            }
+            char* value = colon + 1;
+            // Trim the name's trailing and the value's surrounding whitespace
+            char* nameEnd = colon;
+            while ((nameEnd > line) && isSpace(nameEnd[-1]))
+            {
+                nameEnd--;
+            }
+            *nameEnd = '\0';
+            while (isSpace(*value))
+            {
+                value++;
+            }
+            char* valueEnd = value + strlen(value);
+            while ((valueEnd > value) && isSpace(valueEnd[-1]))
+            {
+                valueEnd--;
+            }
+            *valueEnd = '\0';
+
+            processHeader(line, value);
+            if (aCallback)
+            {
+                aCallback(aContext, line, value);
+            }
+        }
+    }
+    return HTTP_SUCCESS;
+}
+
+void HttpClient::processHeader(const char* aName, const char* aValue)
+{
+    if (strcasecmp(aName, HTTP_HEADER_CONTENT_LENGTH) == 0)
+    {
+        iContentLength = atoi(aValue);
+        iBodyLengthConsumed = 0;
+    }
+    else if ((strcasecmp(aName, HTTP_HEADER_TRANSFER_ENCODING) == 0) &&
+             (strcasecmp(aValue, HTTP_HEADER_VALUE_CHUNKED) == 0))
+    {
+        iIsChunked = true;
+    }
+    else if (iInflater && (strcasecmp(aName, HTTP_HEADER_CONTENT_ENCODING) == 0))
+    {
+        if ((strcasecmp(aValue, "gzip") == 0) || (strcasecmp(aValue, "x-gzip") == 0))
+        {
+            iDecoding = iInflater->begin(HttpInflater::eFormatGzip, readEncoded, this);
+        }
+        else if (strcasecmp(aValue, "deflate") == 0)
+        {
+            iDecoding = iInflater->begin(HttpInflater::eFormatDeflate, readEncoded, this);
+        }
+    }
+}
+
 int HttpClient::skipResponseHeaders()
 {
+    if ((iState == eStatusCodeRead) &&
+        (iContentLengthPtr == kContentLengthPrefix) &&
+        (iTransferEncodingChunkedPtr == kTransferEncodingChunked))
+    {
+        // At the start of a header line, so the block reader can take over
+        return readHeaders(NULL);
+    }
+
     // Just keep reading until we finish reading the headers or time out
     unsigned long timeoutStart = millis();
     // Whilst we haven't timed out & haven't reached the end of the headers
@@ -571,7 +841,8 @@ String HttpClient::responseBody()
     //  - we have a content length: body length equals consumed or no bytes
     //                              available
     //  - no content length:        no bytes are available
-    while (iBodyLengthConsumed != bodyLength)
+    //  - decoding:                 the compressed stream has ended
+    while (decoding() ? !endOfBodyReached() : (iBodyLengthConsumed != bodyLength))
     {
         int c = timedRead();
 
@@ -586,7 +857,13 @@ String HttpClient::responseBody()
         }
     }
 
-    if (bodyLength > 0 && (unsigned int)bodyLength != response.length()) {
+    if (decoding()) {
+        // The content length is that of the compressed data
+        if (!iInflater->finished()) {
+            return String((const char*)NULL);
+        }
+    }
+    else if (bodyLength > 0 && (unsigned int)bodyLength != response.length()) {
         // failure, we did not read in reponse content length bytes
         return String((const char*)NULL);
     }
@@ -596,6 +873,12 @@ String HttpClient::responseBody()
 
 bool HttpClient::endOfBodyReached()
 {
+    if (decoding())
+    {
+        // The stream ended, or broke, or all of it arrived without an end
+        bool received = (iContentLength != kNoContentLengthHeader) && (iBodyLengthConsumed >= iContentLength);
+        return iInflater->finished() || iInflater->failed() || (received && !iInflater->available());
+    }
     if (endOfHeadersReached() && (contentLength() != kNoContentLengthHeader))
     {
         // We've got to the body and we know how long it will be
@@ -604,63 +887,89 @@ bool HttpClient::endOfBodyReached()
     return false;
 }
 
-int HttpClient::available()
+bool HttpClient::readChunkLength()
 {
-    if (iState == eReadingChunkLength)
+    // The size lines are short, so they are scanned in the read-ahead
+    // block; any chunk data fetched with them is served from there
+    while (iState == eReadingChunkLength)
     {
-        while (iClient->available())
+        if ((iReadAheadPos >= iReadAheadLen) && !fillReadAhead())
+        {
+            return false;
+        }
+        while ((iReadAheadPos < iReadAheadLen) && (iState == eReadingChunkLength))
         {
-            char c = iClient->read();
+            char c = iReadAhead[iReadAheadPos++];
 
             if (c == '\n')
             {
                 iState = eReadingBodyChunk;
-                break;
+                iInChunkExtension = false;
             }
-            else if (c == '\r')
+            else if (c == ';')
             {
-                // no-op
+                iInChunkExtension = true;
             }
-            else if (isHexadecimalDigit(c))
+            else if (!iInChunkExtension && isHexadecimalDigit(c))
             {
-                char digit[2] = {c, '\0'};
-
-                iChunkLength = (iChunkLength * 16) + strtol(digit, NULL, 16);
+                iChunkLength = (iChunkLength * 16) + (isdigit(c) ? (c - '0') : ((c | 0x20) - 'a' + 10));
             }
         }
     }
+    return true;
+}
 
-    if (iState == eReadingBodyChunk && iChunkLength == 0)
+int HttpClient::available()
+{
+    if (decoding())
     {
-        iState = eReadingChunkLength;
+        return iInflater->available();
     }
-    
-    if (iState == eReadingChunkLength)
+    return bodyAvailable();
+}
+
+int HttpClient::bodyAvailable()
+{
+    // The CRLF after each chunk's data reads as an empty size line, i.e.
+    // a zero-length chunk; skip over those
+    while ((iState == eReadingChunkLength) ||
+           ((iState == eReadingBodyChunk) && (iChunkLength == 0)))
     {
-        return 0;
+        if (iState == eReadingBodyChunk)
+        {
+            iState = eReadingChunkLength;
+        }
+        if (!readChunkLength())
+        {
+            return 0;
+        }
     }
     
-    int clientAvailable = iClient->available();
+    int avail = clientAvailable();
 
     if (iState == eReadingBodyChunk)
     {
-        return min(clientAvailable, iChunkLength);
+        return min(avail, iChunkLength);
     }
     else
     {
-        return clientAvailable;
+        return avail;
     }
 }
 
 
 int HttpClient::read()
 {
-    if (iIsChunked && !available())
+    if (decoding())
+    {
+        return iInflater->read();
+    }
+    if (iIsChunked && !bodyAvailable())
     {
         return -1;
     }
 
-    int ret = iClient->read();
+    int ret = clientRead();
     if (ret >= 0)
     {
         if (endOfHeadersReached() && iContentLength > 0)
@@ -711,6 +1020,12 @@ bool HttpClient::headerAvailable()
         iHeaderLine += (char)c;
     }
 
+    if (iInflater && iHeaderLine.length() && (strcasecmp(readHeaderName().c_str(), HTTP_HEADER_CONTENT_ENCODING) == 0))
+    {
+        // readHeader() itself only looks out for Content-Length and chunked
+        processHeader(HTTP_HEADER_CONTENT_ENCODING, readHeaderValue().c_str());
+    }
+
     return (iHeaderLine.length() > 0);
 }
 
@@ -745,9 +1060,48 @@ String HttpClient::readHeaderValue()
     return iHeaderLine.substring(startIndex);
 }
 
+int HttpClient::readChunked(uint8_t *aBuffer, size_t aSize)
+{
+    size_t total = 0;
+    while (total < aSize)
+    {
+        // Parses any size lines in the way and bounds us to this chunk
+        int avail = bodyAvailable();
+        if (avail <= 0)
+        {
+            break;
+        }
+        int got = clientRead(aBuffer + total, min(aSize - total, (size_t)avail));
+        if (got <= 0)
+        {
+            break;
+        }
+        total += got;
+        iChunkLength -= got;
+        if (iChunkLength == 0)
+        {
+            iState = eReadingChunkLength;
+        }
+    }
+    return total ? (int)total : -1;
+}
+
 int HttpClient::read(uint8_t *buf, size_t size)
 {
-    int ret =iClient->read(buf, size);
+    if (decoding())
+    {
+        return iInflater->read(buf, size);
+    }
+    return bodyRead(buf, size);
+}
+
+int HttpClient::bodyRead(uint8_t *buf, size_t size)
+{
+    if (iIsChunked && endOfHeadersReached())
+    {
+        return readChunked(buf, size);
+    }
+    int ret = clientRead(buf, size);
     if (endOfHeadersReached() && iContentLength > 0)
     {
         // We're outputting the body now and we've seen a Content-Length header
@@ -760,6 +1114,44 @@ int HttpClient::read(uint8_t *buf, size_t size)
     return ret;
 }
 
+int HttpClient::peek()
+{
+    if (decoding())
+    {
+        return iInflater->peek();
+    }
+    if (iReadAheadPos < iReadAheadLen)
+    {
+        return iReadAhead[iReadAheadPos];
+    }
+    return iClient ? iClient->peek() : -1;
+}
+
+int HttpClient::readEncoded(void* aContext, uint8_t* aBuffer, size_t aSize)
+{
+    HttpClient* self = (HttpClient*)aContext;
+    if (self->iContentLength != kNoContentLengthHeader)
+    {
+        // Leave whatever follows the body, e.g. the next response, alone
+        int left = self->iContentLength - self->iBodyLengthConsumed;
+        if (left <= 0)
+        {
+            return 0;
+        }
+        if ((int)aSize > left)
+        {
+            aSize = left;
+        }
+    }
+    int avail = self->bodyAvailable();
+    if (avail <= 0)
+    {
+        return 0;
+    }
+    int got = self->bodyRead(aBuffer, ((int)aSize < avail) ? aSize : avail);
+    return (got > 0) ? got : 0;
+}
+
 int HttpClient::readHeader()
 {
     char c = read();
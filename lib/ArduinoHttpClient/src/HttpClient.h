@@ -8,6 +8,8 @@
 #include <Arduino.h>
 #include <IPAddress.h>
 #include "Client.h"
+#include "HttpConnectionPool.h"
+#include "HttpInflater.h"
 
 static const int HTTP_SUCCESS =0;
 // The end of the headers has been reached.  This consumes the '\n'
@@ -35,13 +37,24 @@ static const int HTTP_ERROR_INVALID_RESPONSE =-4;
 #define HTTP_HEADER_CONTENT_TYPE   "Content-Type"
 #define HTTP_HEADER_CONNECTION     "Connection"
 #define HTTP_HEADER_TRANSFER_ENCODING "Transfer-Encoding"
+#define HTTP_HEADER_CONTENT_ENCODING "Content-Encoding"
+#define HTTP_HEADER_ACCEPT_ENCODING "Accept-Encoding"
 #define HTTP_HEADER_USER_AGENT     "User-Agent"
 #define HTTP_HEADER_VALUE_CHUNKED  "chunked"
 
 class HttpClient : public Client
 {
 public:
+    /** Receives one response header from readHeaders().
+      aName and aValue are NUL-terminated views into a scratch buffer that
+      is reused for the next header, so copy anything you want to keep.
+      The value has surrounding whitespace removed.
+    */
+    typedef void (*HeaderCallback)(void* aContext, const char* aName, const char* aValue);
+
     static const int kNoContentLengthHeader =-1;
+    // Longest header line readHeaders() delivers whole; longer lines are cut
+    static const int kMaxHeaderLine = 256;
     static const int kHttpPort =80;
     static const char* kUserAgent;
 
@@ -51,6 +64,17 @@ public:
     HttpClient(Client& aClient, const char* aServerName, uint16_t aServerPort = kHttpPort);
     HttpClient(Client& aClient, const String& aServerName, uint16_t aServerPort = kHttpPort);
     HttpClient(Client& aClient, const IPAddress& aServerAddress, uint16_t aServerPort = kHttpPort);
+    /** Take connections from a shared pool instead of owning one client.
+        A connection is leased when a request starts and handed back by
+        stop(); it stays open for the next request to the same server if the
+        response body was fully read. Keep-alive is implied.
+    */
+    HttpClient(HttpConnectionPool& aPool, const char* aServerName, uint16_t aServerPort = kHttpPort);
+    HttpClient(HttpConnectionPool& aPool, const String& aServerName, uint16_t aServerPort = kHttpPort);
+    /** Hands a leased connection back to the pool, so a client going out
+        of scope mid-request doesn't keep its socket leased forever
+    */
+    ~HttpClient();
 
     /** Start a more complex request.
         Use this when you need to send additional headers in the request,
@@ -243,6 +267,17 @@ public:
     */
     int readHeader();
 
+    /** Read all response headers, calling aCallback for each of them.
+      Reads the socket in blocks and uses no heap. Content-Length and
+      chunked Transfer-Encoding are picked up as with skipResponseHeaders().
+      MUST be called after responseStatusCode() and before reading any
+      header with readHeader() / headerAvailable()
+      @param aCallback Called with each header, may be NULL
+      @param aContext Passed through to aCallback
+      @return HTTP_SUCCESS if successful, else an error code
+    */
+    int readHeaders(HeaderCallback aCallback, void* aContext = NULL);
+
     /** Skip any response headers to get to the body.
       Use this if you don't want to do any special processing of the headers
       returned in the response.  You can also use it after you've found all of
@@ -279,6 +314,20 @@ public:
     */
     int isResponseChunked() { return iIsChunked; }
 
+    /** Ask servers for gzip or deflate compressed responses, and decode them
+      with aInflater so that read() and available() deliver the original
+      bytes. contentLength() still reports the compressed length.
+      If the inflater can't allocate its window the body is passed through
+      as received; isResponseEncoded() tells which happened.
+      @param aInflater Decoder to use, or NULL to stop asking for compression
+    */
+    void acceptEncoding(HttpInflater* aInflater) { iInflater = aInflater; };
+
+    /** Returns if the response body is being decompressed
+      @return true if read() delivers decoded bytes, false otherwise
+    */
+    bool isResponseEncoded() { return iDecoding; }
+
     /** Return the response body as a String
       Also skips response headers if they have not been read already
       MUST be called after responseStatusCode()
@@ -297,8 +346,8 @@ public:
     // Inherited from Print
     // Note: 1st call to these indicates the user is sending the body, so if need
     // Note: be we should finish the header first
-    virtual size_t write(uint8_t aByte) { if (iState < eRequestSent) { finishHeaders(); }; return iClient-> write(aByte); };
-    virtual size_t write(const uint8_t *aBuffer, size_t aSize) { if (iState < eRequestSent) { finishHeaders(); }; return iClient->write(aBuffer, aSize); };
+    virtual size_t write(uint8_t aByte) { if (iState < eRequestSent) { finishHeaders(); }; return iClient ? iClient->write(aByte) : 0; };
+    virtual size_t write(const uint8_t *aBuffer, size_t aSize) { if (iState < eRequestSent) { finishHeaders(); }; return iClient ? iClient->write(aBuffer, aSize) : 0; };
     // Inherited from Stream
     virtual int available();
     /** Read the next byte from the server.
@@ -306,15 +355,15 @@ public:
     */
     virtual int read();
     virtual int read(uint8_t *buf, size_t size);
-    virtual int peek() { return iClient->peek(); };
-    virtual void flush() { iClient->flush(); };
+    virtual int peek();
+    virtual void flush() { if (iClient) { iClient->flush(); } };
 
     // Inherited from Client
-    virtual int connect(IPAddress ip, uint16_t port) { return iClient->connect(ip, port); };
-    virtual int connect(const char *host, uint16_t port) { return iClient->connect(host, port); };
+    virtual int connect(IPAddress ip, uint16_t port) { return iClient ? iClient->connect(ip, port) : 0; };
+    virtual int connect(const char *host, uint16_t port) { return iClient ? iClient->connect(host, port) : 0; };
     virtual void stop();
-    virtual uint8_t connected() { return iClient->connected(); };
-    virtual operator bool() { return bool(iClient); };
+    virtual uint8_t connected() { return iClient ? iClient->connected() : 0; };
+    virtual operator bool() { return iClient && bool(*iClient); };
     virtual uint32_t httpResponseTimeout() { return iHttpResponseTimeout; };
     virtual void setHttpResponseTimeout(uint32_t timeout) { iHttpResponseTimeout = timeout; };
 protected:
@@ -338,6 +387,40 @@ protected:
     */
     void flushClientRx();
 
+    /** Read from the client, serving bytes readHeaders() fetched beyond the
+      end of the headers first
+    */
+    int clientRead();
+    int clientRead(uint8_t *aBuffer, size_t aSize);
+    // Refills the read-ahead block from the client; false if nothing came
+    bool fillReadAhead();
+    int clientAvailable() { return (iReadAheadLen - iReadAheadPos) + (iClient ? iClient->available() : 0); };
+
+    /** Consume a chunk-size line of a chunked body
+      @return true once the next chunk's length is known
+    */
+    bool readChunkLength();
+
+    /** read(buf, size) for chunked bodies: copies whole runs of chunk data
+    */
+    int readChunked(uint8_t *aBuffer, size_t aSize);
+
+    // available() and read(buf, size) for the body as it is on the wire
+    int bodyAvailable();
+    int bodyRead(uint8_t *aBuffer, size_t aSize);
+    // Past the headers of a response that iInflater is decoding
+    bool decoding() { return iDecoding && endOfHeadersReached(); };
+    // HttpInflater::SourceFn handing it the raw body
+    static int readEncoded(void* aContext, uint8_t* aBuffer, size_t aSize);
+
+    // Applies what the built-in header handling cares about
+    void processHeader(const char* aName, const char* aValue);
+
+    /** Give a pooled connection back, keeping it open if the response
+      body has been read to the end
+    */
+    void releaseConnection();
+
     // Number of milliseconds that we wait each time there isn't any data
     // available to be read (during status code and header processing)
     static const int kHttpWaitForDataDelay = 1000;
@@ -360,8 +443,10 @@ protected:
         eReadingChunkLength,
         eReadingBodyChunk
     } tHttpState;
-    // Client we're using
+    // Client we're using, NULL while a pooled client isn't leased
     Client* iClient;
+    // Pool the client is leased from, if any
+    HttpConnectionPool* iPool;
     // Server we are connecting to
     const char* iServerName;
     IPAddress iServerAddress;
@@ -383,10 +468,20 @@ protected:
     bool iIsChunked;
     // Stores the value of the current chunk length, if present
     int iChunkLength;
+    // Inside a ";name=value" chunk extension, which is ignored
+    bool iInChunkExtension;
     uint32_t iHttpResponseTimeout;
     bool iConnectionClose;
     bool iSendDefaultRequestHeaders;
+    // Decoder for compressed responses, if they are accepted
+    HttpInflater* iInflater;
+    bool iDecoding;
     String iHeaderLine;
+    // Block read by readHeaders() that ran past the end of the headers
+    static const int kReadAheadSize = 64;
+    uint8_t iReadAhead[kReadAheadSize];
+    uint8_t iReadAheadPos;
+    uint8_t iReadAheadLen;
 };
 
 #endif
@@ -0,0 +1,145 @@
+// Pool of kept-alive connections shared between HttpClient objects
+// Released under Apache License, version 2.0
+
+#include "HttpConnectionPool.h"
+
+HttpConnectionPool::HttpConnectionPool()
+ : iCount(0), iMaxIdle(kDefaultMaxIdle), iReused(0), iOpened(0)
+{
+}
+
+bool HttpConnectionPool::addClient(Client& aClient)
+{
+    if (iCount >= kMaxConnections)
+    {
+        return false;
+    }
+    tConnection& conn = iConnections[iCount++];
+    conn.client = &aClient;
+    conn.host[0] = '\0';
+    conn.port = 0;
+    conn.leased = false;
+    conn.open = false;
+    conn.lastUsed = 0;
+    return true;
+}
+
+Client* HttpConnectionPool::lease(const char* aHost, uint16_t aPort)
+{
+    tConnection* fresh = NULL;
+    tConnection* oldest = NULL;
+    // A name that doesn't fit the slot can't be matched reliably
+    bool poolable = aHost && (strlen(aHost) < kMaxHostLength);
+
+    for (int i = 0; i < iCount; i++)
+    {
+        tConnection& conn = iConnections[i];
+        if (conn.leased)
+        {
+            continue;
+        }
+        if (conn.open && !isAlive(conn))
+        {
+            conn.client->stop();
+            conn.open = false;
+        }
+        if (conn.open)
+        {
+            if (poolable && (conn.port == aPort) && (strcmp(conn.host, aHost) == 0))
+            {
+                // Already connected to this server, no socket open needed
+                conn.leased = true;
+                iReused++;
+                return conn.client;
+            }
+            if (!oldest || (int32_t)(conn.lastUsed - oldest->lastUsed) < 0)
+            {
+                oldest = &conn;
+            }
+        }
+        else if (!fresh)
+        {
+            fresh = &conn;
+        }
+    }
+
+    if (!fresh && oldest)
+    {
+        // All sockets hold connections to other servers, recycle the stalest
+        oldest->client->stop();
+        oldest->open = false;
+        fresh = oldest;
+    }
+    if (!fresh)
+    {
+        return NULL;
+    }
+    if (poolable)
+    {
+        strcpy(fresh->host, aHost);
+    }
+    else
+    {
+        fresh->host[0] = '\0';
+    }
+    fresh->port = aPort;
+    fresh->leased = true;
+    iOpened++;
+    return fresh->client;
+}
+
+void HttpConnectionPool::release(Client* aClient, bool aReusable)
+{
+    tConnection* conn = find(aClient);
+    if (!conn)
+    {
+        return;
+    }
+    conn->leased = false;
+    conn->lastUsed = millis();
+    conn->open = aReusable && (conn->host[0] != '\0') && aClient->connected();
+    if (!conn->open)
+    {
+        aClient->stop();
+    }
+}
+
+void HttpConnectionPool::closeIdle()
+{
+    for (int i = 0; i < iCount; i++)
+    {
+        tConnection& conn = iConnections[i];
+        if (!conn.leased && conn.open)
+        {
+            conn.client->stop();
+            conn.open = false;
+        }
+    }
+}
+
+bool HttpConnectionPool::isAlive(tConnection& aConn)
+{
+    if ((millis() - aConn.lastUsed) > iMaxIdle)
+    {
+        return false;
+    }
+    // Bytes arriving on an idle connection are a stray response or the
+    // server's close; either way the stream is no longer in step
+    if (aConn.client->available())
+    {
+        return false;
+    }
+    return aConn.client->connected();
+}
+
+HttpConnectionPool::tConnection* HttpConnectionPool::find(Client* aClient)
+{
+    for (int i = 0; i < iCount; i++)
+    {
+        if (iConnections[i].client == aClient)
+        {
+            return &iConnections[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,77 @@
+// Pool of kept-alive connections shared between HttpClient objects
+// Released under Apache License, version 2.0
+
+#ifndef HttpConnectionPool_h
+#define HttpConnectionPool_h
+
+#include <Arduino.h>
+#include "Client.h"
+
+class HttpConnectionPool
+{
+public:
+    static const int kMaxConnections = 10;
+    static const int kMaxHostLength = 64;
+    // Most servers drop an idle keep-alive connection after 5-15 seconds
+    static const uint32_t kDefaultMaxIdle = 10*1000;
+
+    HttpConnectionPool();
+
+    /** Hand a socket to the pool, e.g. one GsmClient per modem mux.
+      The pool never creates or destroys clients itself.
+      @param aClient Client to add
+      @return true if added, false if the pool is full
+    */
+    bool addClient(Client& aClient);
+
+    /** Lease a client for a request to aHost:aPort.
+      An idle connection that is already open to that server is preferred;
+      otherwise a free (or the least recently used idle) client is returned
+      disconnected, ready for connect(). Host names of kMaxHostLength or
+      more are not pooled: their connection is closed on release.
+      @return Client to use, or NULL if every client is leased
+    */
+    Client* lease(const char* aHost, uint16_t aPort);
+
+    /** Return a leased client.
+      @param aClient Client from lease()
+      @param aReusable true if the response was fully consumed and the
+                       connection can carry another request; otherwise it
+                       is closed
+    */
+    void release(Client* aClient, bool aReusable);
+
+    /** Close every idle connection, e.g. before the modem powers down
+    */
+    void closeIdle();
+
+    /** Idle connections older than this are not reused
+    */
+    void setMaxIdle(uint32_t aMaxIdle) { iMaxIdle = aMaxIdle; };
+
+    // Leases served by an already open connection / by a fresh one
+    uint32_t reusedCount() const { return iReused; };
+    uint32_t openedCount() const { return iOpened; };
+
+protected:
+    typedef struct {
+        Client* client;
+        char host[kMaxHostLength];
+        uint16_t port;
+        bool leased;
+        bool open;
+        uint32_t lastUsed;
+    } tConnection;
+
+    // Cheap check that an idle connection can take another request
+    bool isAlive(tConnection& aConn);
+    tConnection* find(Client* aClient);
+
+    tConnection iConnections[kMaxConnections];
+    uint8_t iCount;
+    uint32_t iMaxIdle;
+    uint32_t iReused;
+    uint32_t iOpened;
+};
+
+#endif
@@ -0,0 +1,685 @@
+// Streaming decoder for gzip / deflate encoded HTTP bodies
+// Released under Apache License, version 2.0
+
+#include "HttpInflater.h"
+
+// Base values and extra bits of the length and distance codes (RFC 1951)
+static const uint16_t kLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t kLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t kDistanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577 };
+static const uint8_t kDistanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+// Order the code length code lengths are sent in
+static const uint8_t kCodeLengthOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+// CRC-32 a nibble at a time, to keep the table small
+static const uint32_t kCrcTable[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+    0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+    0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c };
+
+// Longest match, and so the window space one symbol may need
+static const uint16_t kMaxMatch = 258;
+static const uint32_t kAdlerBase = 65521;
+
+// gzip header flags
+static const uint8_t kGzipHeaderCrc = 0x02;
+static const uint8_t kGzipExtra = 0x04;
+static const uint8_t kGzipName = 0x08;
+static const uint8_t kGzipComment = 0x10;
+
+HttpInflater::HttpInflater(uint8_t* aWindow)
+ : iWindow(aWindow), iOwnWindow(false), iSource(NULL), iContext(NULL),
+   iFormat(eFormatGzip), iState(eDone), iZlib(false), iInputPos(0), iInputLen(0),
+   iBitBuf(0), iBitCount(0), iProduced(0), iConsumed(0), iTotalIn(0)
+{
+}
+
+HttpInflater::~HttpInflater()
+{
+    end();
+}
+
+bool HttpInflater::begin(tFormat aFormat, SourceFn aSource, void* aContext)
+{
+    if (!iWindow)
+    {
+#ifdef BOARD_HAS_PSRAM
+        iWindow = (uint8_t*)ps_malloc(kWindowSize);
+#endif
+        if (!iWindow)
+        {
+            iWindow = (uint8_t*)malloc(kWindowSize);
+        }
+        if (!iWindow)
+        {
+            iState = eError;
+            return false;
+        }
+        iOwnWindow = true;
+    }
+    iSource = aSource;
+    iContext = aContext;
+    iFormat = aFormat;
+    iState = (aFormat == eFormatGzip) ? eGzipHeader : eZlibHeader;
+    iZlib = false;
+    iInputPos = 0;
+    iInputLen = 0;
+    iBitBuf = 0;
+    iBitCount = 0;
+    iProduced = 0;
+    iConsumed = 0;
+    iTotalIn = 0;
+    iFinalBlock = false;
+    iGzipFlags = 0;
+    iIndex = 0;
+    iCheck = (aFormat == eFormatGzip) ? 0xffffffffUL : 1;
+    iCheck2 = 0;
+    return true;
+}
+
+void HttpInflater::end()
+{
+    if (iOwnWindow)
+    {
+        free(iWindow);
+        iWindow = NULL;
+        iOwnWindow = false;
+    }
+    iState = eDone;
+    iProduced = 0;
+    iConsumed = 0;
+}
+
+int HttpInflater::available()
+{
+    run();
+    return iProduced - iConsumed;
+}
+
+int HttpInflater::peek()
+{
+    if (!available())
+    {
+        return -1;
+    }
+    return iWindow[iConsumed & (kWindowSize - 1)];
+}
+
+int HttpInflater::read()
+{
+    if (!available())
+    {
+        return -1;
+    }
+    return iWindow[iConsumed++ & (kWindowSize - 1)];
+}
+
+int HttpInflater::read(uint8_t* aBuffer, size_t aSize)
+{
+    size_t ret = 0;
+    while (ret < aSize)
+    {
+        if ((iProduced == iConsumed) && !available())
+        {
+            break;
+        }
+        // Copy up to the end of the pending data or of the window
+        uint32_t pos = iConsumed & (kWindowSize - 1);
+        uint32_t n = iProduced - iConsumed;
+        if (n > kWindowSize - pos)
+        {
+            n = kWindowSize - pos;
+        }
+        if (n > aSize - ret)
+        {
+            n = aSize - ret;
+        }
+        memcpy(aBuffer + ret, iWindow + pos, n);
+        iConsumed += n;
+        ret += n;
+    }
+    return ret ? (int)ret : -1;
+}
+
+void HttpInflater::run()
+{
+    while ((iState != eDone) && (iState != eError))
+    {
+        fill();
+        // A step is all or nothing, so one that runs out of bits part way
+        // through is simply retried once more input has arrived
+        uint64_t bitBuf = iBitBuf;
+        uint8_t bitCount = iBitCount;
+        if (step())
+        {
+            continue;
+        }
+        iBitBuf = bitBuf;
+        iBitCount = bitCount;
+        // No step takes more bits than fill() leaves, so with input still
+        // buffered it was the window that was full
+        if (iInputPos < iInputLen)
+        {
+            break;
+        }
+        int got = iSource(iContext, iInput, kInputSize);
+        if (got <= 0)
+        {
+            break;
+        }
+        iInputPos = 0;
+        iInputLen = got;
+        iTotalIn += got;
+    }
+}
+
+void HttpInflater::fill()
+{
+    while ((iBitCount <= 56) && (iInputPos < iInputLen))
+    {
+        iBitBuf |= (uint64_t)iInput[iInputPos++] << iBitCount;
+        iBitCount += 8;
+    }
+}
+
+bool HttpInflater::bits(uint8_t aCount, uint32_t& aValue)
+{
+    if (iBitCount < aCount)
+    {
+        return false;
+    }
+    aValue = (uint32_t)(iBitBuf & ((1ULL << aCount) - 1));
+    iBitBuf >>= aCount;
+    iBitCount -= aCount;
+    return true;
+}
+
+bool HttpInflater::decode(const tHuffman& aTable, int& aSymbol)
+{
+    // Canonical codes of each length are consecutive, so walk the lengths
+    // keeping the first code and symbol index of each
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int len = 1; len < 16; len++)
+    {
+        if (!iBitCount)
+        {
+            return false;
+        }
+        code |= (int)(iBitBuf & 1);
+        iBitBuf >>= 1;
+        iBitCount--;
+        int count = aTable.count[len];
+        if (code - first < count)
+        {
+            aSymbol = aTable.symbol[index + (code - first)];
+            return true;
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    // No such code
+    aSymbol = -1;
+    return true;
+}
+
+bool HttpInflater::build(tHuffman& aTable, const uint8_t* aLengths, int aCount)
+{
+    memset(aTable.count, 0, sizeof(aTable.count));
+    for (int i = 0; i < aCount; i++)
+    {
+        aTable.count[aLengths[i]]++;
+    }
+    // Reject over-subscribed codes; incomplete ones just have gaps
+    int left = 1;
+    for (int len = 1; len < 16; len++)
+    {
+        left = (left << 1) - aTable.count[len];
+        if (left < 0)
+        {
+            return false;
+        }
+    }
+    uint16_t offset[16];
+    offset[1] = 0;
+    for (int len = 1; len < 15; len++)
+    {
+        offset[len + 1] = offset[len] + aTable.count[len];
+    }
+    for (int i = 0; i < aCount; i++)
+    {
+        if (aLengths[i])
+        {
+            aTable.symbol[offset[aLengths[i]]++] = i;
+        }
+    }
+    return true;
+}
+
+void HttpInflater::buildFixed()
+{
+    for (int i = 0; i < 288; i++)
+    {
+        iLengths[i] = (i < 144) ? 8 : (i < 256) ? 9 : (i < 280) ? 7 : 8;
+    }
+    build(iLit, iLengths, 288);
+    memset(iLengths, 5, 30);
+    build(iDist, iLengths, 30);
+}
+
+void HttpInflater::put(uint8_t aByte)
+{
+    iWindow[iProduced++ & (kWindowSize - 1)] = aByte;
+    if (iFormat == eFormatGzip)
+    {
+        iCheck ^= aByte;
+        iCheck = (iCheck >> 4) ^ kCrcTable[iCheck & 15];
+        iCheck = (iCheck >> 4) ^ kCrcTable[iCheck & 15];
+    }
+    else if (iZlib)
+    {
+        iCheck += aByte;
+        if (iCheck >= kAdlerBase)
+        {
+            iCheck -= kAdlerBase;
+        }
+        iCheck2 += iCheck;
+        if (iCheck2 >= kAdlerBase)
+        {
+            iCheck2 -= kAdlerBase;
+        }
+    }
+}
+
+void HttpInflater::nextGzipField()
+{
+    // The optional header fields follow in this order
+    if (iGzipFlags & kGzipExtra)
+    {
+        iGzipFlags &= ~kGzipExtra;
+        iState = eGzipExtraLength;
+    }
+    else if (iGzipFlags & kGzipName)
+    {
+        iGzipFlags &= ~kGzipName;
+        iState = eGzipName;
+    }
+    else if (iGzipFlags & kGzipComment)
+    {
+        iGzipFlags &= ~kGzipComment;
+        iState = eGzipComment;
+    }
+    else if (iGzipFlags & kGzipHeaderCrc)
+    {
+        iGzipFlags &= ~kGzipHeaderCrc;
+        iState = eGzipHeaderCrc;
+    }
+    else
+    {
+        iState = eBlockHeader;
+    }
+}
+
+void HttpInflater::endBlock()
+{
+    if (!iFinalBlock)
+    {
+        iState = eBlockHeader;
+        return;
+    }
+    // The trailer starts on a byte boundary
+    iBitBuf >>= (iBitCount & 7);
+    iBitCount -= (iBitCount & 7);
+    iIndex = 0;
+    iState = ((iFormat == eFormatGzip) || iZlib) ? eTrailer : eDone;
+}
+
+bool HttpInflater::step()
+{
+    uint32_t v;
+    int symbol;
+
+    switch (iState)
+    {
+    case eGzipHeader:
+        // ID1 ID2 CM FLG, then MTIME XFL OS which are of no interest
+        if (!bits(8, v))
+        {
+            return false;
+        }
+        if (((iIndex == 0) && (v != 0x1f)) ||
+            ((iIndex == 1) && (v != 0x8b)) ||
+            ((iIndex == 2) && (v != 8)))
+        {
+            iState = eError;
+        }
+        else if (iIndex == 3)
+        {
+            iGzipFlags = v;
+        }
+        if ((iState != eError) && (++iIndex == 10))
+        {
+            nextGzipField();
+        }
+        return true;
+
+    case eGzipExtraLength:
+        if (!bits(16, v))
+        {
+            return false;
+        }
+        iRemaining = v;
+        if (iRemaining)
+        {
+            iState = eGzipExtra;
+        }
+        else
+        {
+            nextGzipField();
+        }
+        return true;
+
+    case eGzipExtra:
+        if (!bits(8, v))
+        {
+            return false;
+        }
+        if (--iRemaining == 0)
+        {
+            nextGzipField();
+        }
+        return true;
+
+    case eGzipName:
+    case eGzipComment:
+        // NUL-terminated
+        if (!bits(8, v))
+        {
+            return false;
+        }
+        if (v == 0)
+        {
+            nextGzipField();
+        }
+        return true;
+
+    case eGzipHeaderCrc:
+        if (!bits(16, v))
+        {
+            return false;
+        }
+        nextGzipField();
+        return true;
+
+    case eZlibHeader:
+        {
+            // "deflate" is meant to be zlib-wrapped, but some servers send
+            // it raw; only a valid zlib header is taken as one
+            if (iBitCount < 16)
+            {
+                return false;
+            }
+            uint8_t cmf = iBitBuf & 0xff;
+            uint8_t flg = (iBitBuf >> 8) & 0xff;
+            if (((cmf & 0x0f) == 8) && ((cmf >> 4) <= 7) &&
+                ((((uint16_t)cmf << 8) | flg) % 31 == 0) && !(flg & 0x20))
+            {
+                bits(16, v);
+                iZlib = true;
+            }
+            iState = eBlockHeader;
+            return true;
+        }
+
+    case eBlockHeader:
+        if (!bits(3, v))
+        {
+            return false;
+        }
+        iFinalBlock = v & 1;
+        switch (v >> 1)
+        {
+        case 0:
+            // Stored: the lengths start on a byte boundary
+            iBitBuf >>= (iBitCount & 7);
+            iBitCount -= (iBitCount & 7);
+            iState = eStoredLength;
+            break;
+        case 1:
+            buildFixed();
+            iState = eCodes;
+            break;
+        case 2:
+            iState = eTableSizes;
+            break;
+        default:
+            iState = eError;
+            break;
+        }
+        return true;
+
+    case eStoredLength:
+        if (!bits(32, v))
+        {
+            return false;
+        }
+        // LEN then its one's complement NLEN
+        if ((v & 0xffff) != (~v >> 16))
+        {
+            iState = eError;
+            return true;
+        }
+        iRemaining = v & 0xffff;
+        if (iRemaining)
+        {
+            iState = eStored;
+        }
+        else
+        {
+            endBlock();
+        }
+        return true;
+
+    case eStored:
+        if (!space() || !bits(8, v))
+        {
+            return false;
+        }
+        put(v);
+        if (--iRemaining == 0)
+        {
+            endBlock();
+        }
+        return true;
+
+    case eTableSizes:
+        if (!bits(14, v))
+        {
+            return false;
+        }
+        iLitCodes = (v & 0x1f) + 257;
+        iDistCodes = ((v >> 5) & 0x1f) + 1;
+        iCodeLengthCodes = (v >> 10) + 4;
+        if ((iLitCodes > 286) || (iDistCodes > 30))
+        {
+            iState = eError;
+            return true;
+        }
+        memset(iLengths, 0, 19);
+        iIndex = 0;
+        iState = eCodeLengthCodes;
+        return true;
+
+    case eCodeLengthCodes:
+        if (!bits(3, v))
+        {
+            return false;
+        }
+        iLengths[kCodeLengthOrder[iIndex]] = v;
+        if (++iIndex == iCodeLengthCodes)
+        {
+            // The code length code lives in iLit until the real tables are
+            // built from iLengths
+            iIndex = 0;
+            iState = build(iLit, iLengths, 19) ? eCodeLengths : eError;
+        }
+        return true;
+
+    case eCodeLengths:
+        {
+            uint8_t length = 0;
+            uint8_t repeat = 1;
+            if (!decode(iLit, symbol))
+            {
+                return false;
+            }
+            if (symbol < 0)
+            {
+                iState = eError;
+                return true;
+            }
+            if (symbol < 16)
+            {
+                length = symbol;
+            }
+            else if (symbol == 16)
+            {
+                // Repeat the previous length 3-6 times
+                if (!bits(2, v))
+                {
+                    return false;
+                }
+                if (iIndex == 0)
+                {
+                    iState = eError;
+                    return true;
+                }
+                length = iLengths[iIndex - 1];
+                repeat = 3 + v;
+            }
+            else
+            {
+                // Runs of zeros, 3-10 or 11-138 long
+                if (!bits((symbol == 17) ? 3 : 7, v))
+                {
+                    return false;
+                }
+                repeat = (symbol == 17) ? 3 + v : 11 + v;
+            }
+            if (iIndex + repeat > iLitCodes + iDistCodes)
+            {
+                iState = eError;
+                return true;
+            }
+            while (repeat--)
+            {
+                iLengths[iIndex++] = length;
+            }
+            if (iIndex == iLitCodes + iDistCodes)
+            {
+                // The end-of-block code must be there
+                bool ok = iLengths[256] &&
+                          build(iLit, iLengths, iLitCodes) &&
+                          build(iDist, iLengths + iLitCodes, iDistCodes);
+                iState = ok ? eCodes : eError;
+            }
+            return true;
+        }
+
+    case eCodes:
+        {
+            if (space() < kMaxMatch)
+            {
+                return false;
+            }
+            if (!decode(iLit, symbol))
+            {
+                return false;
+            }
+            if (symbol < 256)
+            {
+                if (symbol < 0)
+                {
+                    iState = eError;
+                    return true;
+                }
+                put(symbol);
+                return true;
+            }
+            if (symbol == 256)
+            {
+                endBlock();
+                return true;
+            }
+            symbol -= 257;
+            if (symbol >= 29)
+            {
+                iState = eError;
+                return true;
+            }
+            if (!bits(kLengthExtra[symbol], v))
+            {
+                return false;
+            }
+            uint16_t length = kLengthBase[symbol] + v;
+            if (!decode(iDist, symbol))
+            {
+                return false;
+            }
+            if ((symbol < 0) || (symbol >= 30))
+            {
+                iState = eError;
+                return true;
+            }
+            if (!bits(kDistanceExtra[symbol], v))
+            {
+                return false;
+            }
+            uint32_t distance = kDistanceBase[symbol] + v;
+            if (distance > iProduced)
+            {
+                iState = eError;
+                return true;
+            }
+            while (length--)
+            {
+                put(iWindow[(iProduced - distance) & (kWindowSize - 1)]);
+            }
+            return true;
+        }
+
+    case eTrailer:
+        if (!bits(32, v))
+        {
+            return false;
+        }
+        if (iFormat == eFormatGzip)
+        {
+            // CRC-32 of the data, then its length modulo 2^32
+            bool ok = (iIndex == 0) ? (v == (iCheck ^ 0xffffffffUL)) : (v == iProduced);
+            iState = !ok ? eError : (++iIndex == 2) ? eDone : eTrailer;
+        }
+        else
+        {
+            // Adler-32, most significant byte first
+            v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+            iState = (v == ((iCheck2 << 16) | iCheck)) ? eDone : eError;
+        }
+        return true;
+
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,137 @@
+// Streaming decoder for gzip / deflate encoded HTTP bodies
+// Released under Apache License, version 2.0
+
+#ifndef HttpInflater_h
+#define HttpInflater_h
+
+#include <Arduino.h>
+
+class HttpInflater
+{
+public:
+    // Deflate refers back up to 32KB, so the window must hold that much
+    static const uint32_t kWindowSize = 32*1024;
+    static const int kInputSize = 128;
+
+    typedef enum {
+        eFormatGzip,
+        // zlib-wrapped, or raw deflate as some servers send it
+        eFormatDeflate
+    } tFormat;
+
+    /** Supplies compressed bytes.
+      @return number of bytes copied to aBuffer, 0 if none are waiting
+    */
+    typedef int (*SourceFn)(void* aContext, uint8_t* aBuffer, size_t aSize);
+
+    /** @param aWindow Buffer of kWindowSize bytes for history and pending
+      output, e.g. in PSRAM. If NULL, begin() allocates one, from PSRAM
+      where the board has it.
+    */
+    HttpInflater(uint8_t* aWindow = NULL);
+    ~HttpInflater();
+
+    /** Start decoding a new stream
+      @return false if no window could be allocated
+    */
+    bool begin(tFormat aFormat, SourceFn aSource, void* aContext);
+
+    /** Free the window, if begin() allocated it
+    */
+    void end();
+
+    /** Decode as far as the input and the free window space allow
+      @return number of decompressed bytes ready to read
+    */
+    int available();
+    int read();
+    int read(uint8_t* aBuffer, size_t aSize);
+    int peek();
+
+    // The stream ended, its checksum matched and all output has been read
+    bool finished() const { return (iState == eDone) && (iProduced == iConsumed); };
+    // The data is corrupt; no more output will come
+    bool failed() const { return iState == eError; };
+
+    // Compressed bytes taken from the source / decompressed bytes produced
+    uint32_t totalIn() const { return iTotalIn; };
+    uint32_t totalOut() const { return iProduced; };
+
+protected:
+    typedef enum {
+        eGzipHeader,
+        eGzipExtraLength,
+        eGzipExtra,
+        eGzipName,
+        eGzipComment,
+        eGzipHeaderCrc,
+        eZlibHeader,
+        eBlockHeader,
+        eStoredLength,
+        eStored,
+        eTableSizes,
+        eCodeLengthCodes,
+        eCodeLengths,
+        eCodes,
+        eTrailer,
+        eDone,
+        eError
+    } tState;
+
+    // Canonical Huffman code: number of codes per length, symbols in order
+    typedef struct {
+        uint16_t count[16];
+        uint16_t symbol[288];
+    } tHuffman;
+
+    // Decodes until input or window space runs out
+    void run();
+    // One indivisible unit of work; false if it needs more input or space
+    bool step();
+    // Moves input bytes into the bit buffer
+    void fill();
+    bool bits(uint8_t aCount, uint32_t& aValue);
+    bool decode(const tHuffman& aTable, int& aSymbol);
+    static bool build(tHuffman& aTable, const uint8_t* aLengths, int aCount);
+    void buildFixed();
+    void nextGzipField();
+    void endBlock();
+    void put(uint8_t aByte);
+    uint32_t space() const { return kWindowSize - (iProduced - iConsumed); };
+
+    uint8_t* iWindow;
+    bool iOwnWindow;
+    SourceFn iSource;
+    void* iContext;
+    tFormat iFormat;
+    tState iState;
+    // A deflate stream came with the zlib header and Adler-32 trailer
+    bool iZlib;
+
+    uint8_t iInput[kInputSize];
+    uint8_t iInputPos;
+    uint8_t iInputLen;
+    uint64_t iBitBuf;
+    uint8_t iBitCount;
+
+    // Window positions, as running totals
+    uint32_t iProduced;
+    uint32_t iConsumed;
+    uint32_t iTotalIn;
+
+    bool iFinalBlock;
+    uint8_t iGzipFlags;
+    uint16_t iRemaining;
+    uint16_t iLitCodes;
+    uint16_t iDistCodes;
+    uint16_t iCodeLengthCodes;
+    uint16_t iIndex;
+    uint8_t iLengths[320];
+    tHuffman iLit;
+    tHuffman iDist;
+    // CRC-32 for gzip; Adler-32 sums for zlib
+    uint32_t iCheck;
+    uint32_t iCheck2;
+};
+
+#endif
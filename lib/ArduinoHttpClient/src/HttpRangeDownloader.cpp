@@ -0,0 +1,345 @@
+// Download one file over several connections using HTTP Range requests
+// Released under Apache License, version 2.0
+
+#include "HttpRangeDownloader.h"
+
+HttpRangeDownloader::HttpRangeDownloader(const char* aServerName, uint16_t aServerPort)
+ : iServerName(aServerName), iServerPort(aServerPort), iURLPath(NULL), iSink(NULL), iContext(NULL),
+   iCount(0), iSegmentSize(kDefaultSegmentSize), iProbeSize(kDefaultProbeSize), iLinkCapacity(0),
+   iMaxRetries(kDefaultMaxRetries), iTotalLength(0), iRangeSupported(false), iConnectionsUsed(0),
+   iProbeRate(0), iRangeStart(-1), iRangeTotal(-1)
+{
+}
+
+HttpRangeDownloader::~HttpRangeDownloader()
+{
+    for (int i = 0; i < iCount; i++)
+    {
+        delete iWorkers[i].http;
+    }
+}
+
+bool HttpRangeDownloader::addClient(Client& aClient)
+{
+    if (iCount >= kMaxConnections)
+    {
+        return false;
+    }
+    HttpClient* http = new HttpClient(aClient, iServerName, iServerPort);
+    if (!http)
+    {
+        return false;
+    }
+    // Each connection carries several segments
+    http->connectionKeepAlive();
+    iWorkers[iCount].http = http;
+    iWorkers[iCount].state = eIdle;
+    iCount++;
+    return true;
+}
+
+int HttpRangeDownloader::download(const char* aURLPath, SinkFn aSink, void* aContext)
+{
+    iURLPath = aURLPath;
+    iSink = aSink;
+    iContext = aContext;
+    iTotalLength = 0;
+    iRangeSupported = false;
+    iConnectionsUsed = 0;
+    iProbeRate = 0;
+
+    if (!iCount || !aSink || !iSegmentSize || !iProbeSize)
+    {
+        return HTTP_ERROR_API;
+    }
+    for (int i = 0; i < iCount; i++)
+    {
+        iWorkers[i].state = eIdle;
+        iWorkers[i].retries = 0;
+    }
+
+    // Probe with a single connection: learns the size, whether Range is
+    // honoured, and what one connection achieves
+    tWorker& first = iWorkers[0];
+    first.offset = 0;
+    first.end = iProbeSize - 1;
+    uint32_t probeStart = millis();
+    int ret = sendRangeRequest(first);
+    if (ret != HTTP_SUCCESS)
+    {
+        return ret;
+    }
+    while (!first.http->available())
+    {
+        if ((millis() - first.lastActivity) > first.http->httpResponseTimeout())
+        {
+            first.http->stop();
+            return HTTP_ERROR_TIMED_OUT;
+        }
+        delay(1);
+    }
+    int status = readResponseHead(first);
+    if (status == 200)
+    {
+        // Range was ignored: the whole file is on its way already
+        iConnectionsUsed = 1;
+        return fetchWhole(first, 0);
+    }
+    if ((status != 206) || (iRangeStart != 0) || (iRangeTotal <= 0))
+    {
+        first.http->stop();
+        return (status < 0) ? status : HTTP_ERROR_INVALID_RESPONSE;
+    }
+    iRangeSupported = true;
+    iTotalLength = iRangeTotal;
+    if (first.end >= iTotalLength)
+    {
+        first.end = iTotalLength - 1;
+    }
+    first.state = eReceiving;
+
+    uint32_t next = first.end + 1;
+    int active = 1;
+    bool probing = true;
+    iConnectionsUsed = 1;
+    ret = HTTP_SUCCESS;
+
+    while (ret == HTTP_SUCCESS)
+    {
+        bool busy = false;
+        for (int i = 0; (i < active) && (ret == HTTP_SUCCESS); i++)
+        {
+            tWorker& w = iWorkers[i];
+            if ((w.state == eIdle) && (next < iTotalLength))
+            {
+                w.offset = next;
+                w.end = min(next + iSegmentSize, iTotalLength) - 1;
+                next = w.end + 1;
+                w.retries = 0;
+                if ((sendRangeRequest(w) != HTTP_SUCCESS) && !retry(w))
+                {
+                    ret = HTTP_ERROR_CONNECTION_FAILED;
+                    break;
+                }
+            }
+            if ((w.state == eWaitingForResponse) && w.http->available())
+            {
+                status = readResponseHead(w);
+                if ((status == 206) && (iRangeStart == (long)w.offset))
+                {
+                    w.state = eReceiving;
+                }
+                else if (!retry(w))
+                {
+                    ret = (status < 0) ? status : HTTP_ERROR_INVALID_RESPONSE;
+                    break;
+                }
+            }
+            if ((w.state == eReceiving) && !pump(w))
+            {
+                ret = HTTP_ERROR_API;
+                break;
+            }
+            if (w.state == eIdle)
+            {
+                if (probing && (i == 0))
+                {
+                    // Probe finished: size the pool from its rate
+                    probing = false;
+                    uint32_t elapsed = millis() - probeStart;
+                    iProbeRate = (uint32_t)(((uint64_t)(first.end + 1) * 1000) / (elapsed ? elapsed : 1));
+                    active = chooseConnections(iTotalLength - next);
+                    iConnectionsUsed = active;
+                }
+                continue;
+            }
+            busy = true;
+            bool stalled = (millis() - w.lastActivity) > w.http->httpResponseTimeout();
+            bool dropped = !w.http->connected() && !w.http->available();
+            if ((stalled || dropped) && !retry(w))
+            {
+                ret = stalled ? HTTP_ERROR_TIMED_OUT : HTTP_ERROR_CONNECTION_FAILED;
+            }
+        }
+        if (!busy && (next >= iTotalLength))
+        {
+            break;
+        }
+        delay(1);
+    }
+
+    for (int i = 0; i < iCount; i++)
+    {
+        iWorkers[i].http->stop();
+        iWorkers[i].state = eIdle;
+    }
+    return ret;
+}
+
+int HttpRangeDownloader::sendRangeRequest(tWorker& aWorker)
+{
+    HttpClient& http = *aWorker.http;
+    http.beginRequest();
+    int ret = http.get(iURLPath);
+    if (ret != HTTP_SUCCESS)
+    {
+        aWorker.state = eFailed;
+        return ret;
+    }
+    char range[32];
+    snprintf(range, sizeof(range), "bytes=%lu-%lu", (unsigned long)aWorker.offset, (unsigned long)aWorker.end);
+    http.sendHeader("Range", range);
+    http.endRequest();
+    aWorker.state = eWaitingForResponse;
+    aWorker.lastActivity = millis();
+    return HTTP_SUCCESS;
+}
+
+int HttpRangeDownloader::readResponseHead(tWorker& aWorker)
+{
+    HttpClient& http = *aWorker.http;
+    iRangeStart = -1;
+    iRangeTotal = -1;
+
+    int status = http.responseStatusCode();
+    if (status < 0)
+    {
+        return status;
+    }
+
+    int ret = http.readHeaders(onHeader, this);
+    if (ret != HTTP_SUCCESS)
+    {
+        return ret;
+    }
+    aWorker.lastActivity = millis();
+    return status;
+}
+
+void HttpRangeDownloader::onHeader(void* aContext, const char* aName, const char* aValue)
+{
+    HttpRangeDownloader* self = (HttpRangeDownloader*)aContext;
+    // Content-Range: bytes <first>-<last>/<total>
+    if (strcasecmp(aName, "Content-Range") != 0)
+    {
+        return;
+    }
+    if (strncasecmp(aValue, "bytes", 5) == 0)
+    {
+        aValue += 5;
+    }
+    char* e;
+    self->iRangeStart = strtol(aValue, &e, 10);
+    const char* slash = strchr(e, '/');
+    if (slash && isdigit(slash[1]))
+    {
+        self->iRangeTotal = strtol(slash + 1, NULL, 10);
+    }
+}
+
+bool HttpRangeDownloader::pump(tWorker& aWorker)
+{
+    HttpClient& http = *aWorker.http;
+    int avail = http.available();
+    if (avail <= 0)
+    {
+        return true;
+    }
+    uint32_t want = aWorker.end - aWorker.offset + 1;
+    size_t n = (avail > kBufferSize) ? kBufferSize : avail;
+    if (n > want)
+    {
+        n = want;
+    }
+    int got = http.read(iBuffer, n);
+    if (got <= 0)
+    {
+        return true;
+    }
+    if (!iSink(iContext, aWorker.offset, iBuffer, got))
+    {
+        return false;
+    }
+    aWorker.offset += got;
+    aWorker.lastActivity = millis();
+    if ((aWorker.offset - 1) == aWorker.end)
+    {
+        // Segment complete; the connection stays open for the next one
+        aWorker.state = eIdle;
+    }
+    return true;
+}
+
+int HttpRangeDownloader::fetchWhole(tWorker& aWorker, uint32_t aOffset)
+{
+    HttpClient& http = *aWorker.http;
+    int length = http.contentLength();
+    aWorker.offset = aOffset;
+    aWorker.end = (length > 0) ? (uint32_t)length - 1 : 0xFFFFFFFFUL;
+    aWorker.state = (length == 0) ? eIdle : eReceiving;
+
+    int ret = HTTP_SUCCESS;
+    while (aWorker.state == eReceiving)
+    {
+        if (!pump(aWorker))
+        {
+            ret = HTTP_ERROR_API;
+            break;
+        }
+        if (!http.connected() && !http.available())
+        {
+            // Without a Content-Length the body ends when the server closes
+            if (length > 0)
+            {
+                ret = HTTP_ERROR_CONNECTION_FAILED;
+            }
+            break;
+        }
+        if ((millis() - aWorker.lastActivity) > http.httpResponseTimeout())
+        {
+            ret = HTTP_ERROR_TIMED_OUT;
+            break;
+        }
+    }
+    iTotalLength = aWorker.offset;
+    http.stop();
+    aWorker.state = eIdle;
+    return ret;
+}
+
+int HttpRangeDownloader::chooseConnections(uint32_t aRemaining)
+{
+    int n = iCount;
+    if (iLinkCapacity && iProbeRate)
+    {
+        // Enough connections for their sum to fill the link, no more
+        n = (iLinkCapacity + iProbeRate - 1) / iProbeRate;
+    }
+    uint32_t segments = (aRemaining + iSegmentSize - 1) / iSegmentSize;
+    if ((uint32_t)n > segments)
+    {
+        n = segments;
+    }
+    if (n > iCount)
+    {
+        n = iCount;
+    }
+    return (n < 1) ? 1 : n;
+}
+
+bool HttpRangeDownloader::retry(tWorker& aWorker)
+{
+    // Resume the segment from the first byte not yet delivered
+    aWorker.http->stop();
+    while (aWorker.retries < iMaxRetries)
+    {
+        aWorker.retries++;
+        if (sendRangeRequest(aWorker) == HTTP_SUCCESS)
+        {
+            return true;
+        }
+        aWorker.http->stop();
+    }
+    aWorker.state = eFailed;
+    return false;
+}
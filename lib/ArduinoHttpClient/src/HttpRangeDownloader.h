@@ -0,0 +1,117 @@
+// Download one file over several connections using HTTP Range requests
+// Released under Apache License, version 2.0
+
+#ifndef HttpRangeDownloader_h
+#define HttpRangeDownloader_h
+
+#include <Arduino.h>
+#include "HttpClient.h"
+
+class HttpRangeDownloader
+{
+public:
+    static const int kMaxConnections = 8;
+    static const uint32_t kDefaultSegmentSize = 128*1024;
+    static const uint32_t kDefaultProbeSize = 32*1024;
+    static const int kDefaultMaxRetries = 3;
+    static const int kBufferSize = 1024;
+
+    /** Receives body data; segments arrive interleaved, so aOffset jumps
+      around. Return false to abort the download.
+    */
+    typedef bool (*SinkFn)(void* aContext, uint32_t aOffset, const uint8_t* aData, size_t aLength);
+
+    HttpRangeDownloader(const char* aServerName, uint16_t aServerPort = HttpClient::kHttpPort);
+    ~HttpRangeDownloader();
+
+    /** Add a socket the downloader may use, e.g. one GsmClient per modem mux.
+      The first client carries the initial probe request.
+      @return true if added, false if kMaxConnections are in use
+    */
+    bool addClient(Client& aClient);
+
+    /** Bytes requested per Range request (the last one may be shorter)
+    */
+    void setSegmentSize(uint32_t aSize) { iSegmentSize = aSize; };
+
+    /** Size of the first request, used to measure a single connection
+    */
+    void setProbeSize(uint32_t aSize) { iProbeSize = aSize; };
+
+    /** Throughput the link as a whole can carry, in bytes per second.
+      The number of connections is chosen so their combined rate, measured
+      on the probe, just reaches it; 0 uses every client.
+      For a modem behind a UART this is about baudrate / 10.
+    */
+    void setLinkCapacity(uint32_t aBytesPerSecond) { iLinkCapacity = aBytesPerSecond; };
+
+    void setMaxRetries(int aRetries) { iMaxRetries = aRetries; };
+
+    /** Fetch aURLPath, handing every byte to aSink.
+      Servers that ignore Range get the whole body over one connection.
+      @return HTTP_SUCCESS, or an HTTP_ERROR_* code
+    */
+    int download(const char* aURLPath, SinkFn aSink, void* aContext);
+
+    // Results of the last download()
+    uint32_t totalLength() const { return iTotalLength; };
+    bool rangeSupported() const { return iRangeSupported; };
+    int connectionsUsed() const { return iConnectionsUsed; };
+    // Single-connection rate measured on the probe, bytes per second
+    uint32_t probeRate() const { return iProbeRate; };
+
+protected:
+    typedef enum {
+        eIdle,
+        eWaitingForResponse,
+        eReceiving,
+        eFailed
+    } tWorkerState;
+
+    typedef struct {
+        HttpClient* http;
+        tWorkerState state;
+        // Next byte expected and last byte of the current segment
+        uint32_t offset;
+        uint32_t end;
+        uint32_t lastActivity;
+        int retries;
+    } tWorker;
+
+    int sendRangeRequest(tWorker& aWorker);
+    // Reads the status line and headers; fills iRangeStart/iRangeTotal
+    int readResponseHead(tWorker& aWorker);
+    static void onHeader(void* aContext, const char* aName, const char* aValue);
+    // Moves whatever body data is waiting to the sink; false on sink abort
+    bool pump(tWorker& aWorker);
+    int fetchWhole(tWorker& aWorker, uint32_t aOffset);
+    int chooseConnections(uint32_t aRemaining);
+    bool retry(tWorker& aWorker);
+
+    const char* iServerName;
+    uint16_t iServerPort;
+    const char* iURLPath;
+    SinkFn iSink;
+    void* iContext;
+
+    tWorker iWorkers[kMaxConnections];
+    int iCount;
+
+    uint32_t iSegmentSize;
+    uint32_t iProbeSize;
+    uint32_t iLinkCapacity;
+    int iMaxRetries;
+
+    uint32_t iTotalLength;
+    bool iRangeSupported;
+    int iConnectionsUsed;
+    uint32_t iProbeRate;
+
+    // From the last Content-Range header
+    long iRangeStart;
+    long iRangeTotal;
+
+    uint8_t iBuffer[kBufferSize];
+};
+
+#endif
@@ -8,6 +8,7 @@
 WebSocketClient::WebSocketClient(Client& aClient, const char* aServerName, uint16_t aServerPort)
  : HttpClient(aClient, aServerName, aServerPort),
    iTxStarted(false),
+   iTxStreaming(false),
    iRxSize(0)
 {
 }
@@ -15,6 +16,7 @@ WebSocketClient::WebSocketClient(Client& aClient, const char* aServerName, uint1
 WebSocketClient::WebSocketClient(Client& aClient, const String& aServerName, uint16_t aServerPort) 
  : HttpClient(aClient, aServerName, aServerPort),
    iTxStarted(false),
+   iTxStreaming(false),
    iRxSize(0)
 {
 }
@@ -22,6 +24,7 @@ WebSocketClient::WebSocketClient(Client& aClient, const String& aServerName, uin
 WebSocketClient::WebSocketClient(Client& aClient, const IPAddress& aServerAddress, uint16_t aServerPort)
  : HttpClient(aClient, aServerAddress, aServerPort),
    iTxStarted(false),
+   iTxStreaming(false),
    iRxSize(0)
 {
 }
@@ -81,12 +84,26 @@ int WebSocketClient::beginMessage(int aType)
     }
 
     iTxStarted = true;
+    iTxStreaming = false;
     iTxMessageType = (aType & 0xf);
     iTxSize = 0;
 
     return 0;
 }
 
+int WebSocketClient::beginStream(int aType)
+{
+    int ret = beginMessage(aType);
+
+    if (ret == 0)
+    {
+        iTxStreaming = true;
+        iTxFragmented = false;
+    }
+
+    return ret;
+}
+
 int WebSocketClient::endMessage()
 {
     if (!iTxStarted)
@@ -95,54 +112,132 @@ int WebSocketClient::endMessage()
         return 1;
     }
 
-    // send FIN + the message type (opcode)
-    HttpClient::write(0x80 | iTxMessageType);
+    int ret;
+
+    if (iTxStreaming)
+    {
+        // an empty frame carries the FIN bit
+        ret = writeFrame(iTxFragmented ? TYPE_CONTINUATION : iTxMessageType, true, NULL, 0);
+    }
+    else
+    {
+        ret = writeFrame(iTxMessageType, true, iTxBuffer, iTxSize);
+    }
+
+    iTxStarted = false;
+    iTxStreaming = false;
+    iTxSize = 0;
+
+    return ret;
+}
+
+int WebSocketClient::writeFrame(uint8_t aOpCode, bool aFinal, const uint8_t* aData, size_t aSize)
+{
+    // Word aligned, for mask(); the header shares the first write with the
+    // start of the payload, so small frames go out in one send
+    uint32_t block[(kTxBlockSize + 16) / 4];
+    uint8_t* out = (uint8_t*)block;
+    size_t len = 0;
+
+    // FIN + the opcode
+    out[len++] = (aFinal ? 0x80 : 0x00) | aOpCode;
 
     // the message is masked (0x80)
     // send the length
-    if (iTxSize < 126)
+    if (aSize < 126)
     {
-        HttpClient::write(0x80 | (uint8_t)iTxSize);
+        out[len++] = 0x80 | (uint8_t)aSize;
     }
-    else if (iTxSize < 0xffff)
+    else if (aSize <= 0xffff)
     {
-        HttpClient::write(0x80 | 126);
-        HttpClient::write((iTxSize >> 8) & 0xff);
-        HttpClient::write((iTxSize >> 0) & 0xff);
+        out[len++] = 0x80 | 126;
+        out[len++] = (aSize >> 8) & 0xff;
+        out[len++] = (aSize >> 0) & 0xff;
     }
     else
     {
-        HttpClient::write(0x80 | 127);
-        HttpClient::write((iTxSize >> 56) & 0xff);
-        HttpClient::write((iTxSize >> 48) & 0xff);
-        HttpClient::write((iTxSize >> 40) & 0xff);
-        HttpClient::write((iTxSize >> 32) & 0xff);
-        HttpClient::write((iTxSize >> 24) & 0xff);
-        HttpClient::write((iTxSize >> 16) & 0xff);
-        HttpClient::write((iTxSize >> 8) & 0xff);
-        HttpClient::write((iTxSize >> 0) & 0xff);
+        out[len++] = 0x80 | 127;
+        for (int shift = 56; shift >= 0; shift -= 8)
+        {
+            out[len++] = ((uint64_t)aSize >> shift) & 0xff;
+        }
     }
 
     uint8_t maskKey[4];
 
-    // create a random mask for the data and send
+    // create a random mask for the data
     for (int i = 0; i < (int)sizeof(maskKey); i++)
     {
         maskKey[i] = random(0xff);
     }
-    HttpClient::write(maskKey, sizeof(maskKey));
+    memcpy(out + len, maskKey, sizeof(maskKey));
+    len += sizeof(maskKey);
+
+    // mask the data a block at a time and send
+    size_t sent = 0;
+    do
+    {
+        size_t n = aSize - sent;
+        if (n > sizeof(block) - len)
+        {
+            n = sizeof(block) - len;
+        }
+        if (n)
+        {
+            memcpy(out + len, aData + sent, n);
+            mask(out + len, n, maskKey, sent);
+        }
+        len += n;
+        sent += n;
+
+        if (HttpClient::write(out, len) != len)
+        {
+            return 1;
+        }
+        len = 0;
+    } while (sent < aSize);
+
+    return 0;
+}
 
-    // mask the data and send
-    for (int i = 0; i < (int)iTxSize; i++) {
-        iTxBuffer[i] ^= maskKey[i % sizeof(maskKey)];
+void WebSocketClient::mask(uint8_t* aData, size_t aSize, const uint8_t aMaskKey[4], size_t aOffset)
+{
+    // GCC may not assume these don't alias the bytes they are made from
+    typedef uint32_t __attribute__((__may_alias__)) tWord;
+    size_t i = 0;
+
+    // byte-wise up to a word boundary, as not all CPUs allow unaligned words
+    while ((i < aSize) && ((uintptr_t)(aData + i) & 3))
+    {
+        aData[i] ^= aMaskKey[(aOffset + i) & 3];
+        i++;
     }
 
-    size_t txSize = iTxSize;
+    if (aSize - i >= 4)
+    {
+        // the mask as it lines up with the words from here on
+        uint8_t rotated[4];
+        for (int k = 0; k < 4; k++)
+        {
+            rotated[k] = aMaskKey[(aOffset + i + k) & 3];
+        }
+        tWord key;
+        memcpy(&key, rotated, sizeof(key));
 
-    iTxStarted = false;
-    iTxSize = 0;
+        tWord* words = (tWord*)(aData + i);
+        for (size_t n = (aSize - i) / 4; n > 0; n--)
+        {
+            *words++ ^= key;
+        }
+        i += (aSize - i) & ~(size_t)3;
+    }
 
-    return (HttpClient::write(iTxBuffer, txSize) == txSize) ? 0 : 1;
+    // and the tail
+    while (i < aSize)
+    {
+        aData[i] ^= aMaskKey[(aOffset + i) & 3];
+        i++;
+    }
 }
 
 size_t WebSocketClient::write(uint8_t aByte)
@@ -164,10 +259,25 @@ size_t WebSocketClient::write(const uint8_t *aBuffer, size_t aSize)
         return 0;
     }
 
+    if (iTxStreaming)
+    {
+        if (aSize == 0)
+        {
+            return 0;
+        }
+        if (writeFrame(iTxFragmented ? TYPE_CONTINUATION : iTxMessageType, false, aBuffer, aSize) != 0)
+        {
+            return 0;
+        }
+        iTxFragmented = true;
+        iTxSize += aSize;
+        return aSize;
+    }
+
     // check if the write size, fits in the buffer
     if ((iTxSize + aSize) > sizeof(iTxBuffer))
     {
-        aSize = sizeof(iTxSize) - iTxSize;
+        aSize = sizeof(iTxBuffer) - iTxSize;
     }
 
     // copy data into the buffer
@@ -246,12 +356,19 @@ int WebSocketClient::parseMessage()
     }
     else if (TYPE_PING == messageType())
     {
-        beginMessage(TYPE_PONG);
+        // Sent as a frame of its own: control frames may come between the
+        // fragments of a message that beginStream() has open
+        uint8_t pongData[125];
+        size_t pongSize = 0;
         while(available())
         {
-            write(read());
+            int c = read();
+            if (pongSize < sizeof(pongData))
+            {
+                pongData[pongSize++] = c;
+            }
         }
-        endMessage();
+        writeFrame(TYPE_PONG, true, pongData, pongSize);
 
         iRxSize = 0;
     }
@@ -302,9 +419,8 @@ int WebSocketClient::ping()
         pingData[i] = random(0xff);
     }
 
-    beginMessage(TYPE_PING);
-    write(pingData, sizeof(pingData));
-    return endMessage();
+    // Leaves any message being sent alone, see parseMessage()
+    return writeFrame(TYPE_PING, true, pingData, sizeof(pingData));
 }
 
 int WebSocketClient::available()
@@ -331,6 +447,12 @@ int WebSocketClient::read()
 
 int WebSocketClient::read(uint8_t *aBuffer, size_t aSize)
 {
+    if ((iState >= eReadingBody) && (aSize > iRxSize))
+    {
+        // stop at the end of this frame
+        aSize = iRxSize;
+    }
+
     int readCount = HttpClient::read(aBuffer, aSize);
 
     if (readCount > 0)
@@ -340,10 +462,8 @@ int WebSocketClient::read(uint8_t *aBuffer, size_t aSize)
         // unmask the RX data if needed
         if (iRxMasked)
         {
-            for (int i = 0; i < (int)aSize; i++, iRxMaskIndex++)
-            {
-                aBuffer[i] ^= iRxMaskKey[iRxMaskIndex % sizeof(iRxMaskKey)];
-            }
+            mask(aBuffer, readCount, iRxMaskKey, iRxMaskIndex);
+            iRxMaskIndex += readCount;
         }
     }
 
@@ -37,7 +37,16 @@ public:
     */
     int beginMessage(int aType);
 
-    /** Completes sending of a message started by beginMessage
+    /** Begin to send a message of any size as a series of frames.
+        Each write() goes out at once as its own frame, masked on the way
+        from the caller's buffer rather than collected first, so write in
+        blocks rather than bytes. endMessage() sends the final frame.
+      @param aType TYPE_TEXT or TYPE_BINARY
+      @return 0 if successful, else error
+    */
+    int beginStream(int aType);
+
+    /** Completes sending of a message started by beginMessage or beginStream
       @return 0 if successful, else error
     */
     int endMessage();
@@ -82,9 +91,20 @@ public:
 
 private:
     void flushRx();
+    // Sends one masked frame; 0 if successful
+    int writeFrame(uint8_t aOpCode, bool aFinal, const uint8_t* aData, size_t aSize);
+    // XORs aData with the mask, aOffset being aData's position in the payload
+    static void mask(uint8_t* aData, size_t aSize, const uint8_t aMaskKey[4], size_t aOffset);
 
 private:
+    // Payload bytes masked per write to the client when sending a frame
+    static const int kTxBlockSize = 256;
+
     bool iTxStarted;
+    // Sending frames straight from write(), see beginStream()
+    bool iTxStreaming;
+    // A frame of the current streamed message has gone out already
+    bool iTxFragmented;
     uint8_t iTxMessageType;
     uint8_t iTxBuffer[128];
     uint64_t iTxSize;
@@ -0,0 +1,125 @@
+/*
+  RadioLib LoRaWAN Multicast Example
+
+  This example joins a LoRaWAN network as a class C device,
+  listens to a multicast group and rebuilds files sent to the group
+  with the Fragmented Data Block Transport package (TS004).
+  The network sends a file once to all devices in the group;
+  fragments lost by a device are recovered from coded fragments,
+  so no retransmissions are needed.
+
+  Before you start, register the device as in the Starter example,
+  enable class C for it and create a multicast group on the
+  network server. Copy the group address and keys to config.h.
+
+  Running this examples REQUIRES you to check "Resets DevNonces"
+  on your LoRaWAN dashboard. Refer to the network's
+  documentation on how to do this.
+
+  For default module settings, see the wiki page
+  https://github.com/jgromes/RadioLib/wiki/Default-configuration
+
+  For full API reference, see the GitHub Pages
+  https://jgromes.github.io/RadioLib/
+
+  For LoRaWAN details, see the wiki page
+  https://github.com/jgromes/RadioLib/wiki/LoRaWAN
+
+*/
+
+#include "config.h"
+
+// buffer for the file, plus some bookkeeping of the fragmentation session
+uint8_t fileBuffer[RADIOLIB_LORAWAN_FRAG_BUFFER_SIZE(FILE_FRAGMENTS_MAX, FILE_FRAGMENT_SIZE)];
+LoRaWANFragSession frag(fileBuffer, sizeof(fileBuffer));
+
+uint32_t lastUplink = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  delay(5000);  // Give time to switch to the serial monitor
+  Serial.println(F("\nSetup ... "));
+
+  Serial.println(F("Initialise the radio"));
+  int16_t state = radio.begin();
+  debug(state != RADIOLIB_ERR_NONE, F("Initialise radio failed"), state, true);
+
+  // Setup the OTAA session information
+  state = node.beginOTAA(joinEUI, devEUI, nwkKey, appKey);
+  debug(state != RADIOLIB_ERR_NONE, F("Initialise node failed"), state, true);
+
+  // Class C: listen whenever the device is not transmitting
+  state = node.setClass(RADIOLIB_LORAWAN_CLASS_C);
+  debug(state != RADIOLIB_ERR_NONE, F("Setting class C failed"), state, true);
+
+  Serial.println(F("Join ('login') the LoRaWAN Network"));
+  state = node.activateOTAA();
+  debug(state != RADIOLIB_LORAWAN_NEW_SESSION, F("Join failed"), state, true);
+
+  // Listen to the multicast group as well
+  state = node.addMulticastGroup(0, mcAddr, mcAppSKey, mcNwkSKey);
+  debug(state != RADIOLIB_ERR_NONE, F("Adding multicast group failed"), state, true);
+
+  Serial.println(F("Ready!\n"));
+}
+
+void loop() {
+  uint8_t downlinkPayload[255];
+  size_t downlinkSize = 0;
+  LoRaWANEvent_t downlinkDetails;
+
+  // Check for a downlink that was received in between uplinks
+  int16_t state = node.getDownlinkClassC(downlinkPayload, &downlinkSize, &downlinkDetails);
+  debug(state < RADIOLIB_ERR_NONE, F("Error in getDownlinkClassC"), state, false);
+
+  if(state > 0) {
+    Serial.print(F("Received a downlink on FPort "));
+    Serial.print(downlinkDetails.fPort);
+    if(downlinkDetails.multicast != RADIOLIB_LORAWAN_MULTICAST_NONE) {
+      Serial.print(F(" for multicast group "));
+      Serial.print(downlinkDetails.multicast);
+    }
+    Serial.println();
+
+    if(downlinkDetails.fPort == RADIOLIB_LORAWAN_FPORT_TS004) {
+      // pass it to the fragmentation session, it may have an answer for the server
+      uint8_t answer[16];
+      size_t answerSize = 0;
+      bool wasComplete = frag.isComplete();
+      state = frag.handle(downlinkPayload, downlinkSize, answer, &answerSize);
+      debug(state != RADIOLIB_ERR_NONE, F("Error in fragmentation session"), state, false);
+
+      if(answerSize > 0) {
+        // answers to a multicast request are spread out, so that not all devices answer at once
+        if(downlinkDetails.multicast != RADIOLIB_LORAWAN_MULTICAST_NONE) {
+          delay(radio.random(frag.getAnswerDelayMax()));
+        }
+        node.sendReceive(answer, answerSize, RADIOLIB_LORAWAN_FPORT_TS004);
+      }
+
+      if(frag.isComplete() && !wasComplete) {
+        Serial.print(F("File complete: "));
+        Serial.print(frag.getFileSize());
+        Serial.println(F(" bytes"));
+        // This is the place to use the file, e.g. store it to flash
+        arrayDump(fileBuffer, 16);
+      }
+    }
+  }
+
+  if((lastUplink == 0) || (millis() - lastUplink > uplinkIntervalSeconds * 1000UL)) {
+    Serial.println(F("Sending uplink"));
+    lastUplink = millis();
+
+    // Report how much of the file is still missing
+    uint16_t missing = frag.getMissing();
+    uint8_t uplinkPayload[2];
+    uplinkPayload[0] = highByte(missing);
+    uplinkPayload[1] = lowByte(missing);
+
+    // Perform an uplink, the device returns to class C listening afterwards
+    state = node.sendReceive(uplinkPayload, sizeof(uplinkPayload));
+    debug(state < RADIOLIB_ERR_NONE, F("Error in sendReceive"), state, false);
+  }
+}
@@ -0,0 +1,147 @@
+/*
+  RadioLib LoRaWAN Persistence Example
+
+  This example joins a LoRaWAN network and sends uplinks like
+  the Starter example, but keeps the session in flash.
+  After a reset or deep sleep, the session is restored
+  instead of joining again, and the frame counters continue
+  where they left off, as LoRaWAN 1.0.4/1.1 requires.
+
+  The session is saved after every uplink. Only the bytes that
+  changed are appended to a journal (typically 14 bytes per
+  uplink), so a 4 kB flash sector lasts for hundreds of uplinks
+  before it has to be erased, and the erases are spread over
+  all sectors of the journal.
+
+  This example is for ESP32 and keeps the journal in the first
+  sectors of the "spiffs" data partition. If your sketch uses
+  SPIFFS, add a dedicated data partition and change the lookup
+  in setup() instead.
+
+  Before you start, complete the Starter example and read its notes.
+
+  For default module settings, see the wiki page
+  https://github.com/jgromes/RadioLib/wiki/Default-configuration
+
+  For full API reference, see the GitHub Pages
+  https://jgromes.github.io/RadioLib/
+
+  For LoRaWAN details, see the wiki page
+  https://github.com/jgromes/RadioLib/wiki/LoRaWAN
+
+*/
+
+#include "config.h"
+#include <esp_partition.h>
+
+// number of flash sectors used by the journal
+#define STORE_SECTORS   (4)
+
+// LoRaWANStorage backed by an ESP32 flash partition
+class PartitionStorage : public LoRaWANStorage {
+  public:
+    PartitionStorage(const esp_partition_t* part)
+      : LoRaWANStorage(SPI_FLASH_SEC_SIZE, STORE_SECTORS), part(part) {}
+
+    int16_t read(uint32_t addr, uint8_t* data, size_t len) override {
+      return(esp_partition_read(part, addr, data, len) == ESP_OK ? RADIOLIB_ERR_NONE : RADIOLIB_ERR_STORE_FAILED);
+    }
+
+    int16_t write(uint32_t addr, const uint8_t* data, size_t len) override {
+      return(esp_partition_write(part, addr, data, len) == ESP_OK ? RADIOLIB_ERR_NONE : RADIOLIB_ERR_STORE_FAILED);
+    }
+
+    int16_t erase(uint8_t sector) override {
+      return(esp_partition_erase_range(part, sector * sectorSize, sectorSize) == ESP_OK ? RADIOLIB_ERR_NONE : RADIOLIB_ERR_STORE_FAILED);
+    }
+
+  private:
+    const esp_partition_t* part;
+};
+
+PartitionStorage* storage;
+LoRaWANSessionStore* store;
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  delay(5000);  // Give time to switch to the serial monitor
+  Serial.println(F("\nSetup ... "));
+
+  const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, NULL);
+  if(!part || (part->size < STORE_SECTORS * SPI_FLASH_SEC_SIZE)) {
+    Serial.println(F("No suitable flash partition found"));
+    while(true) { delay(1); }
+  }
+  storage = new PartitionStorage(part);
+  store = new LoRaWANSessionStore(storage);
+
+  Serial.println(F("Initialise the radio"));
+  int16_t state = radio.begin();
+  debug(state != RADIOLIB_ERR_NONE, F("Initialise radio failed"), state, true);
+
+  // Setup the OTAA session information
+  state = node.beginOTAA(joinEUI, devEUI, nwkKey, appKey);
+  debug(state != RADIOLIB_ERR_NONE, F("Initialise node failed"), state, true);
+
+  // Restore the session from flash, if there is one
+  state = store->restore(&node);
+  debug((state != RADIOLIB_ERR_NONE) && (state != RADIOLIB_ERR_STORE_EMPTY), F("Restoring session failed"), state, false);
+
+  Serial.println(F("Join ('login') the LoRaWAN Network"));
+  state = RADIOLIB_ERR_NETWORK_NOT_JOINED;
+  while(state != RADIOLIB_LORAWAN_NEW_SESSION && state != RADIOLIB_LORAWAN_SESSION_RESTORED) {
+    state = node.activateOTAA();
+
+    // Save after every attempt, the DevNonce must never be used twice
+    int16_t stateStore = store->save(&node);
+    debug(stateStore != RADIOLIB_ERR_NONE, F("Saving session failed"), stateStore, false);
+
+    if(state != RADIOLIB_LORAWAN_NEW_SESSION && state != RADIOLIB_LORAWAN_SESSION_RESTORED) {
+      debug(true, F("Join failed, retrying in a minute"), state, false);
+      delay(60000UL);
+    }
+  }
+  Serial.println(state == RADIOLIB_LORAWAN_SESSION_RESTORED ? F("Session restored") : F("Joined"));
+
+  Serial.println(F("Ready!\n"));
+}
+
+void loop() {
+  Serial.println(F("Sending uplink"));
+
+  // This is the place to gather the sensor inputs
+  // Instead of reading any real sensor, we just generate some random numbers as example
+  uint8_t value1 = radio.random(100);
+  uint16_t value2 = radio.random(2000);
+
+  // Build payload byte array
+  uint8_t uplinkPayload[3];
+  uplinkPayload[0] = value1;
+  uplinkPayload[1] = highByte(value2);   // See notes for high/lowByte functions
+  uplinkPayload[2] = lowByte(value2);
+  
+  // Perform an uplink
+  int16_t state = node.sendReceive(uplinkPayload, sizeof(uplinkPayload));    
+  debug(state < RADIOLIB_ERR_NONE, F("Error in sendReceive"), state, false);
+
+  // Save the new frame counters (and anything else that changed)
+  int16_t stateStore = store->save(&node);
+  debug(stateStore != RADIOLIB_ERR_NONE, F("Saving session failed"), stateStore, false);
+
+  // Check if a downlink was received 
+  // (state 0 = no downlink, state 1/2 = downlink in window Rx1/Rx2)
+  if(state > 0) {
+    Serial.println(F("Received a downlink"));
+  } else {
+    Serial.println(F("No downlink received"));
+  }
+
+  Serial.print(F("Next uplink in "));
+  Serial.print(uplinkIntervalSeconds);
+  Serial.println(F(" seconds\n"));
+  
+  // Wait until next uplink - observing legal & TTN FUP constraints
+  // After a reset during this time, the session is restored from flash
+  delay(uplinkIntervalSeconds * 1000UL);  // delay needs milli-seconds
+}
@@ -0,0 +1,105 @@
+/*
+  RadioLib LoRaWAN Uplink Queue Example
+
+  This example joins a LoRaWAN network and takes a measurement
+  every minute, but instead of sending each one in its own uplink,
+  it queues them in a LoRaWANUplinkQueue. The queue packs as many
+  records as fit into one uplink at the current datarate, and sends
+  the frame once it is full or once the oldest record has waited
+  long enough - never earlier than the duty cycle allows.
+  An occasional alarm record has a higher priority and is sent
+  right away, taking any waiting records on the same port along.
+
+  Each record is type-length-value encoded, so that the records
+  in one uplink can be told apart by the decoder on the server.
+
+  Running this examples REQUIRES you to check "Resets DevNonces"
+  on your LoRaWAN dashboard. Refer to the network's 
+  documentation on how to do this.
+
+  For default module settings, see the wiki page
+  https://github.com/jgromes/RadioLib/wiki/Default-configuration
+
+  For full API reference, see the GitHub Pages
+  https://jgromes.github.io/RadioLib/
+
+  For LoRaWAN details, see the wiki page
+  https://github.com/jgromes/RadioLib/wiki/LoRaWAN
+
+*/
+
+#include "config.h"
+
+// record types
+#define RECORD_TEMPERATURE  (0x01)
+#define RECORD_ALARM        (0x02)
+
+LoRaWANUplinkQueue queue(&node);
+
+uint32_t lastSample = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while(!Serial);
+  delay(5000);  // Give time to switch to the serial monitor
+  Serial.println(F("\nSetup ... "));
+
+  Serial.println(F("Initialise the radio"));
+  int16_t state = radio.begin();
+  debug(state != RADIOLIB_ERR_NONE, F("Initialise radio failed"), state, true);
+
+  // Setup the OTAA session information
+  state = node.beginOTAA(joinEUI, devEUI, nwkKey, appKey);
+  debug(state != RADIOLIB_ERR_NONE, F("Initialise node failed"), state, true);
+
+  Serial.println(F("Join ('login') the LoRaWAN Network"));
+  state = node.activateOTAA();
+  debug(state != RADIOLIB_LORAWAN_NEW_SESSION, F("Join failed"), state, true);
+
+  // The queue waits for the duty cycle instead of sending too early
+  node.setDutyCycle(true);
+
+  Serial.println(F("Ready!\n"));
+}
+
+void loop() {
+  if((lastSample == 0) || (millis() - lastSample >= sampleIntervalSeconds * 1000UL)) {
+    lastSample = millis();
+
+    // This is the place to gather the sensor inputs
+    // Instead of reading any real sensor, we just generate some random numbers as example
+    int16_t temperature = radio.random(-100, 400);   // 0.1 degrees C
+    uint8_t record[4] = { RECORD_TEMPERATURE, 2, highByte(temperature), lowByte(temperature) };
+    int16_t state = queue.enqueue(record, sizeof(record), 1, 0, maxLatencySeconds * 1000UL);
+    debug(state != RADIOLIB_ERR_NONE, F("Error in enqueue"), state, false);
+
+    // Every now and then, something needs attention right away
+    if(radio.random(20) == 0) {
+      uint8_t alarm[3] = { RECORD_ALARM, 1, 0x01 };
+      state = queue.enqueue(alarm, sizeof(alarm), 1, 1, 0);
+      debug(state != RADIOLIB_ERR_NONE, F("Error in enqueue"), state, false);
+    }
+
+    Serial.print(queue.getPending());
+    Serial.println(F(" records queued"));
+  }
+
+  // Send a frame if one is due and allowed
+  int16_t state = queue.process();
+  if(state >= RADIOLIB_ERR_NONE) {
+    Serial.print(F("Sent an uplink of "));
+    Serial.print(node.getLastToA());
+    Serial.println(F(" ms on air"));
+    if(state > 0) {
+      Serial.println(F("Received a downlink"));
+    }
+  } else if(state != RADIOLIB_ERR_UPLINK_UNAVAILABLE && state != RADIOLIB_ERR_UPLINK_QUEUE_EMPTY) {
+    debug(true, F("Error in process"), state, false);
+  }
+
+  // Wait until the next frame is due, or the next measurement - whichever comes first
+  // This is where a low-power device would go to sleep
+  RadioLibTime_t untilSample = sampleIntervalSeconds * 1000UL - (millis() - lastSample);
+  RadioLibTime_t untilUplink = queue.timeUntilUplink();
+  delay(min(untilSample, untilUplink));
+}
@@ -0,0 +1,9 @@
+#!/bin/bash
+
+set -e
+mkdir -p build
+cd build
+cmake -G "CodeBlocks - Unix Makefiles" ..
+make
+cd ..
+./build/radiolib-simulator
@@ -0,0 +1,123 @@
+/*
+   RadioLib Non-Arduino CRC Test
+
+   Compares the table-driven CRC path of RadioLibCRC against the bitwise one
+   for the configurations used by the drivers, over buffers of every length
+   from 0 to 300 bytes. Both paths are also checked against the published
+   check values (CRC of "123456789"), and the time taken by each is printed.
+*/
+
+// access to the private checksum paths; only the CRC header is included,
+// RadioLib.h would warn about god mode
+#define RADIOLIB_GODMODE (1)
+
+// include the library
+#include <utils/CRC.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+struct CrcVector_t {
+  const char* name;
+  uint8_t size;
+  uint32_t poly;
+  uint32_t init;
+  uint32_t out;
+  bool refIn;
+  bool refOut;
+
+  // checksum of "123456789"
+  uint32_t check;
+};
+
+static const CrcVector_t vectors[] = {
+  { "CRC-8",              8,  0x07,       0x00,       0x00,       false, false, 0xF4 },
+  { "CRC-16/IBM-3740",    16, 0x1021,     0xFFFF,     0x0000,     false, false, 0x29B1 },
+  { "CRC-16/X-25",        16, 0x1021,     0xFFFF,     0xFFFF,     true,  true,  0x906E },
+  { "CRC-16/KERMIT",      16, 0x1021,     0x0000,     0x0000,     true,  true,  0x2189 },
+  { "CRC-16/GENIBUS",     16, 0x1021,     0xFFFF,     0xFFFF,     false, false, 0xD64E },
+  { "CRC-24/BLE",         24, 0x00065B,   0x555555,   0x000000,   true,  true,  0xC25A56 },
+  { "CRC-32/ISO-HDLC",    32, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true,  true,  0xCBF43926 },
+  { "CRC-32/BZIP2",       32, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, false, false, 0xFC891918 },
+};
+
+#define MAX_LEN     (300)
+#define BENCH_RUNS  (2000)
+
+static void configure(RadioLibCRC& crc, const CrcVector_t& vec) {
+  crc.size = vec.size;
+  crc.poly = vec.poly;
+  crc.init = vec.init;
+  crc.out = vec.out;
+  crc.refIn = vec.refIn;
+  crc.refOut = vec.refOut;
+}
+
+static bool runVector(const CrcVector_t& vec) {
+  RadioLibCRC crc;
+  configure(crc, vec);
+
+  const uint8_t check[] = "123456789";
+  uint32_t res = crc.checksumBitwise(check, 9);
+  if(res != vec.check) {
+    printf("bitwise check value 0x%lX, expected 0x%lX\n", (unsigned long)res, (unsigned long)vec.check);
+    return(false);
+  }
+
+#if RADIOLIB_CRC_TABLE
+  crc.buildTable();
+  res = crc.checksumTable(check, 9);
+  if(res != vec.check) {
+    printf("table check value 0x%lX, expected 0x%lX\n", (unsigned long)res, (unsigned long)vec.check);
+    return(false);
+  }
+
+  static uint8_t buff[MAX_LEN];
+  for(size_t i = 0; i < MAX_LEN; i++) {
+    buff[i] = (i*151 + 17) & 0xFF;
+  }
+  for(size_t len = 0; len <= MAX_LEN; len++) {
+    uint32_t bit = crc.checksumBitwise(buff, len);
+    uint32_t tab = crc.checksumTable(buff, len);
+    if(bit != tab) {
+      printf("%d bytes: table 0x%lX, bitwise 0x%lX\n", (int)len, (unsigned long)tab, (unsigned long)bit);
+      return(false);
+    }
+  }
+
+  // the timings are only informative, the test does not fail on them
+  clock_t start = clock();
+  volatile uint32_t sink = 0;
+  for(int i = 0; i < BENCH_RUNS; i++) {
+    sink = sink + crc.checksumBitwise(buff, MAX_LEN);
+  }
+  double bitUs = (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC / BENCH_RUNS;
+  start = clock();
+  for(int i = 0; i < BENCH_RUNS; i++) {
+    sink = sink + crc.checksumTable(buff, MAX_LEN);
+  }
+  double tabUs = (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC / BENCH_RUNS;
+  printf("%d bytes: bitwise %.2f us, table %.2f us ... ", MAX_LEN, bitUs, tabUs);
+#endif
+
+  return(true);
+}
+
+// the entry point for the program
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+
+  int failed = 0;
+  for(size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+    printf("[%s] ", vectors[i].name);
+    if(runVector(vectors[i])) {
+      printf("success!\n");
+    } else {
+      failed++;
+    }
+  }
+
+  return(failed ? 1 : 0);
+}
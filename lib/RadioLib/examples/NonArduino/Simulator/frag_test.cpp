@@ -0,0 +1,128 @@
+/*
+   RadioLib Non-Arduino TS004 Fragmentation Test
+
+   Known-answer test of the LoRaWAN fragmented data block transport decoder.
+   The coded fragments below were produced by a transcription of the reference
+   encoder in TS004 v1.0.0 chapter 7 (matrix_line), independently of RadioLib.
+   Some uncoded fragments are dropped and the file has to be rebuilt from the
+   coded ones, which only works if the decoder generates the same parity lines.
+
+   Fragment i of the file holds the bytes (i*37 + j*11 + 5) & 0xFF, j = 0 .. 3.
+*/
+
+// include the library
+#include <RadioLib.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define FRAG_SIZE   (4)
+
+struct FragVector_t {
+  // number of uncoded fragments, M in TS004
+  uint16_t nbFrag;
+
+  // uncoded fragments that are not delivered
+  uint8_t lost[4];
+  uint8_t nbLost;
+
+  // coded fragments N = 1, 2, ... as sent by the reference encoder
+  uint8_t coded[8][FRAG_SIZE];
+  uint8_t nbCoded;
+};
+
+static const FragVector_t vectors[] = {
+  // power of 2, the generator uses modulo M + 1
+  { 16, { 0, 3, 7, 12 }, 4, {
+    { 0xe6, 0x5a, 0x72, 0xb6 },
+    { 0xb9, 0xe8, 0xcf, 0xc6 },
+    { 0x1d, 0xf8, 0xdb, 0x2e },
+    { 0x6f, 0x55, 0x53, 0xad },
+    { 0x91, 0xfb, 0xf9, 0x17 },
+    { 0x4f, 0x1e, 0xa5, 0x6c },
+  }, 6 },
+  { 10, { 2, 5, 8 }, 3, {
+    { 0xf1, 0x93, 0xb1, 0xaf },
+    { 0x3f, 0x7a, 0x6d, 0x40 },
+    { 0x0b, 0x7e, 0xf9, 0x2c },
+    { 0xf9, 0xdb, 0x91, 0xa7 },
+    { 0xef, 0x9d, 0x03, 0x2d },
+  }, 5 },
+};
+
+static uint8_t fileByte(uint16_t frag, uint8_t i) {
+  return((frag*37 + i*11 + 5) & 0xFF);
+}
+
+static void sendFragment(LoRaWANFragSession& session, uint16_t n, const uint8_t* data) {
+  uint8_t msg[3 + FRAG_SIZE] = { RADIOLIB_LORAWAN_FRAG_DATA_FRAGMENT, (uint8_t)(n & 0xFF), (uint8_t)((n >> 8) & 0x3F) };
+  memcpy(&msg[3], data, FRAG_SIZE);
+  uint8_t ans[16];
+  size_t ansLen = 0;
+  session.handle(msg, sizeof(msg), ans, &ansLen);
+}
+
+static bool runVector(const FragVector_t& vec) {
+  static uint8_t buff[RADIOLIB_LORAWAN_FRAG_BUFFER_SIZE(16, FRAG_SIZE)];
+  LoRaWANFragSession session(buff, sizeof(buff));
+
+  uint8_t setup[] = { RADIOLIB_LORAWAN_FRAG_SESSION_SETUP_REQ, 0x00,
+                      (uint8_t)(vec.nbFrag & 0xFF), (uint8_t)(vec.nbFrag >> 8), FRAG_SIZE,
+                      RADIOLIB_LORAWAN_FRAG_ALGO_PARITY, 0x00, 0x00, 0x00, 0x00, 0x00 };
+  uint8_t ans[16];
+  size_t ansLen = 0;
+  session.handle(setup, sizeof(setup), ans, &ansLen);
+  if((ansLen < 2) || (ans[1] != 0)) {
+    printf("session setup failed\n");
+    return(false);
+  }
+
+  // uncoded fragments are numbered from 1
+  for(uint16_t i = 0; i < vec.nbFrag; i++) {
+    if(memchr(vec.lost, i, vec.nbLost)) {
+      continue;
+    }
+    uint8_t data[FRAG_SIZE];
+    for(uint8_t j = 0; j < FRAG_SIZE; j++) {
+      data[j] = fileByte(i, j);
+    }
+    sendFragment(session, i + 1, data);
+  }
+
+  // coded fragment N follows the uncoded ones
+  for(uint8_t n = 0; n < vec.nbCoded; n++) {
+    sendFragment(session, vec.nbFrag + n + 1, vec.coded[n]);
+  }
+
+  if(!session.isComplete()) {
+    printf("file not rebuilt, %d fragments missing\n", session.getMissing());
+    return(false);
+  }
+  for(uint16_t i = 0; i < vec.nbFrag; i++) {
+    for(uint8_t j = 0; j < FRAG_SIZE; j++) {
+      if(buff[i*FRAG_SIZE + j] != fileByte(i, j)) {
+        printf("fragment %d rebuilt wrong\n", i);
+        return(false);
+      }
+    }
+  }
+  return(true);
+}
+
+// the entry point for the program
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+
+  int failed = 0;
+  for(size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+    printf("[TS004] %d fragments, %d lost ... ", vectors[i].nbFrag, vectors[i].nbLost);
+    if(runVector(vectors[i])) {
+      printf("success!\n");
+    } else {
+      failed++;
+    }
+  }
+
+  return(failed ? 1 : 0);
+}
@@ -0,0 +1,145 @@
+/*
+   RadioLib Non-Arduino Simulator Example
+
+   This example shows how to run RadioLib on a desktop machine
+   against simulated radio modules instead of hardware.
+   An SX1278 and an SX1262 share one simulated medium,
+   exchange packets and are then run over a lossy link.
+
+   All time in the simulation is virtual, so runs are repeatable
+   and the printed timing does not depend on the host machine.
+   This makes the simulator useful to test and benchmark protocol
+   code (PhysicalLayer users, LoRaWAN etc.) before moving to hardware.
+
+   For full API reference, see the GitHub Pages
+   https://jgromes.github.io/RadioLib/
+*/
+
+// include the library
+#include <RadioLib.h>
+
+// include the simulated hardware abstraction layer and radio models
+#include "hal/Sim/SimHal.h"
+#include "hal/Sim/SimSX127x.h"
+#include "hal/Sim/SimSX126x.h"
+
+// the medium both radios live in, it also keeps the virtual time
+SimAir air;
+
+// every node gets its own HAL, just like it would have its own MCU
+SimHal* hal1 = new SimHal(air);
+SimHal* hal2 = new SimHal(air);
+
+// the simulated chips
+SimSX127x chip1(air);
+SimSX126x chip2(air);
+
+// RadioLib drivers, pin numbers only have to match those passed to SimHal::attach
+// NSS pin:   10
+// IRQ pin:   2 (DIO0 on SX1278, DIO1 on SX1262)
+// NRST pin:  9
+// GPIO pin:  3 (DIO1 on SX1278, BUSY on SX1262)
+SX1278 radio1 = new Module(hal1, 10, 2, 9, 3);
+SX1262 radio2 = new Module(hal2, 10, 2, 9, 3);
+
+// flag set by the receiver interrupt
+volatile bool receivedFlag = false;
+
+void setFlag(void) {
+  receivedFlag = true;
+}
+
+// send one packet from tx to rx, which has to be in receive mode already
+static int transfer(PhysicalLayer& tx, PhysicalLayer& rx, const char* str, bool verbose) {
+  receivedFlag = false;
+  int state = tx.transmit(str);
+  if(state != RADIOLIB_ERR_NONE) {
+    printf("transmit failed, code %d\n", state);
+    return(state);
+  }
+
+  // the receiver interrupt fired while the transmitter was waiting for its packet to go out
+  if(!receivedFlag) {
+    return(RADIOLIB_ERR_RX_TIMEOUT);
+  }
+
+  uint8_t buff[256];
+  size_t len = rx.getPacketLength();
+  state = rx.readData(buff, len);
+  if(verbose && (state == RADIOLIB_ERR_NONE)) {
+    buff[len] = '\0';
+    printf("received \"%s\", RSSI %.1f dBm, SNR %.1f dB\n", (char*)buff, rx.getRSSI(), rx.getSNR());
+  }
+  rx.startReceive();
+  return(state);
+}
+
+// the entry point for the program
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+
+  // connect the chips to the pins used by the drivers
+  hal1->attach(chip1, 10, 2, 9, 3);
+  hal2->attach(chip2, 10, 2, 9, 3);
+
+  // initialize just like with Arduino
+  printf("[SX1278] Initializing ... ");
+  int state = radio1.begin();
+  if(state != RADIOLIB_ERR_NONE) {
+    printf("failed, code %d\n", state);
+    return(1);
+  }
+  printf("success!\n");
+
+  printf("[SX1262] Initializing ... ");
+  state = radio2.begin();
+  if(state != RADIOLIB_ERR_NONE) {
+    printf("failed, code %d\n", state);
+    return(1);
+  }
+  printf("success!\n");
+
+  // SX1278 to SX1262
+  radio2.setPacketReceivedAction(setFlag);
+  radio2.startReceive();
+  printf("[SX1278 -> SX1262] ");
+  if(transfer(radio1, radio2, "Hello from SX1278!", true) != RADIOLIB_ERR_NONE) {
+    return(1);
+  }
+  radio2.clearPacketReceivedAction();
+  radio2.standby();
+
+  // SX1262 to SX1278
+  radio1.setPacketReceivedAction(setFlag);
+  radio1.startReceive();
+  printf("[SX1262 -> SX1278] ");
+  if(transfer(radio2, radio1, "Hello from SX1262!", true) != RADIOLIB_ERR_NONE) {
+    return(1);
+  }
+
+  // now run a number of packets over a lossy link and measure
+  const int count = 100;
+  air.setLoss(0.2);
+  air.setLink(-110, -5.25);
+  uint64_t start = air.now();
+  uint32_t spiStart = chip2.stats.spiTransactions;
+  int received = 0;
+  for(int i = 0; i < count; i++) {
+    char str[32];
+    snprintf(str, sizeof(str), "Packet #%d", i);
+    if(transfer(radio2, radio1, str, false) == RADIOLIB_ERR_NONE) {
+      received++;
+    }
+  }
+  uint64_t elapsed = air.now() - start;
+
+  printf("[Link] %d of %d packets received over 20 %% loss\n", received, count);
+  printf("[Link] %.3f s of virtual time, %.1f ms per packet\n", elapsed / 1000000.0, elapsed / 1000.0 / count);
+  printf("[SX1262] %.1f SPI transactions per packet, %.3f s on air\n",
+    (chip2.stats.spiTransactions - spiStart) / (float)count, chip2.stats.txTimeUs / 1000000.0);
+  printf("[SX1278] %lu received, %lu dropped, %.3f s in receive mode\n",
+    (unsigned long)chip1.stats.rxPackets, (unsigned long)chip1.stats.rxDropped, chip1.stats.rxTimeUs / 1000000.0);
+
+  return(0);
+}
@@ -0,0 +1,117 @@
+/*
+  RadioLib PhysicalLayer Event Loop Example
+
+  This example shows how to drive two radios at the same time
+  using RadioLibEventLoop, without polling or blocking on either.
+  It works as a simple repeater: everything received by the SX1278
+  is forwarded by the SX1262 after checking that the channel is free.
+
+  The interrupts only count events, all SPI access happens in loop().
+  Each operation is finished by the event loop, which then calls
+  the handler, where the next operation can be started right away.
+
+  For full API reference, see the GitHub Pages
+  https://jgromes.github.io/RadioLib/
+*/
+
+// include the library
+#include <RadioLib.h>
+
+// SX1278 has the following connections:
+// NSS pin:   10
+// DIO0 pin:  2
+// NRST pin:  9
+// DIO1 pin:  3
+SX1278 radioIn = new Module(10, 2, 9, 3);
+
+// SX1262 has the following connections:
+// NSS pin:   5
+// DIO1 pin:  4
+// NRST pin:  8
+// BUSY pin:  7
+SX1262 radioOut = new Module(5, 4, 8, 7);
+
+RadioLibEventLoop events;
+
+// IDs of the radios within the event loop
+int idIn = -1;
+int idOut = -1;
+
+// packet that is being forwarded
+uint8_t packet[64];
+size_t packetLen = 0;
+
+// called by events.poll() for every finished operation
+void onEvent(uint8_t id, uint8_t event, int16_t state, void* ctx) {
+  (void)ctx;
+
+  if((id == idIn) && (event == RADIOLIB_EVENT_RX_DONE)) {
+    if(state == RADIOLIB_ERR_NONE) {
+      packetLen = events.getPacketLength(id);
+      Serial.print(F("[SX1278] Received "));
+      Serial.print(packetLen);
+      Serial.println(F(" bytes"));
+
+      // check the channel before forwarding
+      events.startChannelScan(idOut);
+    } else {
+      Serial.print(F("[SX1278] Reception failed, code "));
+      Serial.println(state);
+      events.startReceive(idIn, packet, sizeof(packet));
+    }
+
+  } else if((id == idOut) && (event == RADIOLIB_EVENT_CAD_DONE)) {
+    if(state == RADIOLIB_CHANNEL_FREE) {
+      events.startTransmit(idOut, packet, packetLen);
+    } else {
+      // somebody is transmitting, try again
+      events.startChannelScan(idOut);
+    }
+
+  } else if((id == idOut) && (event == RADIOLIB_EVENT_TX_DONE)) {
+    Serial.print(F("[SX1262] Forwarded, code "));
+    Serial.println(state);
+
+    // the packet buffer is free again
+    events.startReceive(idIn, packet, sizeof(packet));
+
+  }
+}
+
+void setup() {
+  Serial.begin(9600);
+
+  Serial.print(F("[SX1278] Initializing ... "));
+  int state = radioIn.begin(434.0);
+  if (state == RADIOLIB_ERR_NONE) {
+    Serial.println(F("success!"));
+  } else {
+    Serial.print(F("failed, code "));
+    Serial.println(state);
+    while (true) { delay(10); }
+  }
+
+  Serial.print(F("[SX1262] Initializing ... "));
+  state = radioOut.begin(868.0);
+  if (state == RADIOLIB_ERR_NONE) {
+    Serial.println(F("success!"));
+  } else {
+    Serial.print(F("failed, code "));
+    Serial.println(state);
+    while (true) { delay(10); }
+  }
+
+  // attach both radios, this takes over their interrupt actions
+  idIn = events.attach(&radioIn, onEvent);
+  idOut = events.attach(&radioOut, onEvent);
+
+  // start the chain
+  events.startReceive(idIn, packet, sizeof(packet));
+}
+
+void loop() {
+  // finish whatever the radios have done and call the handler
+  events.poll();
+
+  // nothing else is blocked by the radios, so other work can be done here
+}
@@ -0,0 +1,143 @@
+/*
+  RadioLib nRF24 Burst Transmit Example
+
+  This example streams packets using nRF24 2.4 GHz radio module
+  as fast as the radio allows. The transmitter is kept enabled
+  for the whole burst, and up to three packets wait in the Tx FIFO,
+  so the next packet is uploaded while the current one is on air.
+
+  The result of each packet is reported in the order the packets
+  were added, once the packet was acknowledged by the receiver,
+  or dropped after all retransmissions failed.
+
+  For default module settings, see the wiki page
+  https://github.com/jgromes/RadioLib/wiki/Default-configuration#nrf24
+
+  For full API reference, see the GitHub Pages
+  https://jgromes.github.io/RadioLib/
+*/
+
+// include the library
+#include <RadioLib.h>
+
+// nRF24 has the following connections:
+// CS pin:    10
+// IRQ pin:   2
+// CE pin:    3
+nRF24 radio = new Module(10, 2, 3);
+
+// or detect the pinout automatically using RadioBoards
+// https://github.com/radiolib-org/RadioBoards
+/*
+#define RADIO_BOARD_AUTO
+#include <RadioBoards.h>
+Radio radio = new RadioModule();
+*/
+
+// number of packets in each burst
+#define NUM_PACKETS   100
+
+// counters of packets that were sent or dropped
+int sent = 0;
+int dropped = 0;
+
+// this function is called from checkBurst()
+// for every packet of the burst
+void burstResult(uint32_t seq, int16_t state, void* ctx) {
+  if(state == RADIOLIB_ERR_NONE) {
+    sent++;
+  } else {
+    // the packet could be added again here
+    dropped++;
+  }
+}
+
+void setup() {
+  Serial.begin(9600);
+
+  // initialize nRF24 with default settings
+  Serial.print(F("[nRF24] Initializing ... "));
+  int state = radio.begin();
+  if(state == RADIOLIB_ERR_NONE) {
+    Serial.println(F("success!"));
+  } else {
+    Serial.print(F("failed, code "));
+    Serial.println(state);
+    while (true) { delay(10); }
+  }
+
+  // 2 Mbps gives the highest throughput
+  radio.setBitRate(2000);
+
+  // set transmit address
+  // NOTE: address width in bytes MUST be equal to the
+  //       width set in begin() or setAddressWidth()
+  //       methods (5 by default)
+  byte addr[] = {0x01, 0x23, 0x45, 0x67, 0x89};
+  Serial.print(F("[nRF24] Setting transmit pipe ... "));
+  state = radio.setTransmitPipe(addr);
+  if(state == RADIOLIB_ERR_NONE) {
+    Serial.println(F("success!"));
+  } else {
+    Serial.print(F("failed, code "));
+    Serial.println(state);
+    while (true) { delay(10); }
+  }
+}
+
+void loop() {
+  Serial.print(F("[nRF24] Sending burst ... "));
+  sent = 0;
+  dropped = 0;
+  unsigned long start = millis();
+
+  // start the burst with acknowledged packets
+  // NOTE: with startBurst(false, burstResult), packets are not
+  //       acknowledged, which is faster still
+  int state = radio.startBurst(true, burstResult);
+  if(state != RADIOLIB_ERR_NONE) {
+    Serial.print(F("failed, code "));
+    Serial.println(state);
+    delay(1000);
+    return;
+  }
+
+  byte packet[32];
+  for(int i = 0; i < NUM_PACKETS;) {
+    // fill the packet with its number
+    memset(packet, i, sizeof(packet));
+
+    // add it to the burst, this only fails
+    // while all three levels of the Tx FIFO are occupied
+    if(radio.addBurst(packet, sizeof(packet)) == RADIOLIB_ERR_NONE) {
+      i++;
+    }
+
+    // process packets that were sent in the meantime
+    radio.checkBurst();
+  }
+
+  // wait for the rest of the packets
+  state = radio.finishBurst();
+  unsigned long elapsed = millis() - start;
+
+  if(state == RADIOLIB_ERR_NONE) {
+    Serial.println(F("success!"));
+  } else if(state == RADIOLIB_ERR_ACK_NOT_RECEIVED) {
+    Serial.println(F("some packets were not acknowledged!"));
+  } else {
+    Serial.print(F("failed, code "));
+    Serial.println(state);
+  }
+
+  Serial.print(F("[nRF24] Sent "));
+  Serial.print(sent);
+  Serial.print(F(" packets, dropped "));
+  Serial.print(dropped);
+  Serial.print(F(" in "));
+  Serial.print(elapsed);
+  Serial.println(F(" ms"));
+
+  // wait for a second before the next burst
+  delay(1000);
+}
@@ -452,6 +452,105 @@
   #define RADIOLIB_EXCLUDE_STM32WLX (1)
 #endif
 
+/*
+ * Table-driven CRC calculation in RadioLibCRC, one byte per step instead of one bit.
+ * Costs 1 kB of RAM for the table, so it is disabled by default on low-end platforms.
+ */
+#if !defined(RADIOLIB_CRC_TABLE)
+  #if defined(RADIOLIB_LOWEND_PLATFORM)
+    #define RADIOLIB_CRC_TABLE  (0)
+  #else
+    #define RADIOLIB_CRC_TABLE  (1)
+  #endif
+#endif
+
+/*
+ * 32-bit lookup table (T-table) AES-128 encryption in RadioLibAES128, instead of the byte-oriented reference.
+ * Costs 1 kB of program storage, so it is disabled by default on low-end platforms.
+ */
+#if !defined(RADIOLIB_AES_TTABLE)
+  #if defined(RADIOLIB_LOWEND_PLATFORM)
+    #define RADIOLIB_AES_TTABLE  (0)
+  #else
+    #define RADIOLIB_AES_TTABLE  (1)
+  #endif
+#endif
+
+/*
+ * Run RadioLibAES128 blocks on the ESP32 AES peripheral, through mbedTLS.
+ * Disabled by default: for single blocks, acquiring the peripheral costs about as much as the T-table cipher.
+ */
+#if !defined(RADIOLIB_AES_ESP32_HW)
+  #define RADIOLIB_AES_ESP32_HW  (0)
+#endif
+
+/*
+ * Number of registers a Module can hold in a batch of writes (see Module::SPIbeginBatch).
+ * Each one costs 8 bytes of RAM per module; set to 0 to disable batching, SPIsetRegValue then always writes immediately.
+ */
+#if !defined(RADIOLIB_SPI_BATCH_SIZE)
+  #if defined(RADIOLIB_LOWEND_PLATFORM)
+    #define RADIOLIB_SPI_BATCH_SIZE  (8)
+  #else
+    #define RADIOLIB_SPI_BATCH_SIZE  (32)
+  #endif
+#endif
+
+/*
+ * Number of multicast groups a LoRaWANNode can listen to at the same time (TS005 allows up to 4).
+ * Each one costs about 50 bytes of RAM per node.
+ */
+#if !defined(RADIOLIB_LORAWAN_MULTICAST_GROUPS)
+  #if defined(RADIOLIB_LOWEND_PLATFORM)
+    #define RADIOLIB_LORAWAN_MULTICAST_GROUPS  (1)
+  #else
+    #define RADIOLIB_LORAWAN_MULTICAST_GROUPS  (4)
+  #endif
+#endif
+
+/*
+ * Maximum number of lost fragments a LoRaWANFragSession can recover from coded fragments.
+ * The decoding matrix costs N*N/8 + 2*N bytes of RAM per session; must be a multiple of 8.
+ */
+#if !defined(RADIOLIB_LORAWAN_FRAG_MAX_MISSING)
+  #if defined(RADIOLIB_LOWEND_PLATFORM)
+    #define RADIOLIB_LORAWAN_FRAG_MAX_MISSING  (16)
+  #else
+    #define RADIOLIB_LORAWAN_FRAG_MAX_MISSING  (128)
+  #endif
+#endif
+
+/*
+ * Capacity of a LoRaWANUplinkQueue: bytes of queued application records,
+ * and the number of records (each costs 12 bytes of RAM on top of its data).
+ */
+#if !defined(RADIOLIB_LORAWAN_UPLINK_QUEUE_SIZE)
+  #if defined(RADIOLIB_LOWEND_PLATFORM)
+    #define RADIOLIB_LORAWAN_UPLINK_QUEUE_SIZE  (64)
+  #else
+    #define RADIOLIB_LORAWAN_UPLINK_QUEUE_SIZE  (512)
+  #endif
+#endif
+
+#if !defined(RADIOLIB_LORAWAN_UPLINK_QUEUE_RECORDS)
+  #if defined(RADIOLIB_LOWEND_PLATFORM)
+    #define RADIOLIB_LORAWAN_UPLINK_QUEUE_RECORDS  (4)
+  #else
+    #define RADIOLIB_LORAWAN_UPLINK_QUEUE_RECORDS  (32)
+  #endif
+#endif
+
+/*
+ * Number of radios a RadioLibEventLoop can drive at the same time (at most 8).
+ */
+#if !defined(RADIOLIB_EVENT_LOOP_RADIOS)
+  #if defined(RADIOLIB_LOWEND_PLATFORM)
+    #define RADIOLIB_EVENT_LOOP_RADIOS  (2)
+  #else
+    #define RADIOLIB_EVENT_LOOP_RADIOS  (4)
+  #endif
+#endif
+
 // if verbose assert is enabled, enable basic debug too
 #if RADIOLIB_VERBOSE_ASSERT
   #define RADIOLIB_DEBUG  (1)
@@ -51,6 +51,16 @@ int16_t Module::SPIgetRegValue(uint32_t reg, uint8_t msb, uint8_t lsb) {
     return(RADIOLIB_ERR_INVALID_BIT_RANGE);
   }
 
+  #if RADIOLIB_SPI_BATCH_SIZE
+  // registers changed in the current batch have not been written yet
+  if(this->batchDepth > 0) {
+    SPIbatchEntry_t* entry = this->SPIfindBatchEntry(reg, false);
+    if(entry) {
+      return(entry->value & ((0b11111111 << lsb) & (0b11111111 >> (7 - msb))));
+    }
+  }
+  #endif
+
   uint8_t rawValue = SPIreadRegister(reg);
   uint8_t maskedValue = rawValue & ((0b11111111 << lsb) & (0b11111111 >> (7 - msb)));
   return(maskedValue);
@@ -61,9 +71,27 @@ int16_t Module::SPIsetRegValue(uint32_t reg, uint8_t value, uint8_t msb, uint8_t
     return(RADIOLIB_ERR_INVALID_BIT_RANGE);
   }
 
+  uint8_t mask = ~((0b11111111 << (msb + 1)) | (0b11111111 >> (8 - lsb)));
+
+  #if RADIOLIB_SPI_BATCH_SIZE
+  // in a batch, only update the shadow copy
+  if(this->batchDepth > 0) {
+    SPIbatchEntry_t* entry = this->SPIfindBatchEntry(reg, true);
+    uint8_t newValue = (entry->value & ~mask) | (value & mask);
+    if((newValue != entry->value) || force) {
+      entry->dirty = true;
+    }
+    entry->value = newValue;
+    entry->checkMask &= checkMask;
+    if(checkInterval > this->batchCheckInterval) {
+      this->batchCheckInterval = checkInterval;
+    }
+    return(RADIOLIB_ERR_NONE);
+  }
+  #endif
+
   // read the current value
   uint8_t currentValue = SPIreadRegister(reg);
-  uint8_t mask = ~((0b11111111 << (msb + 1)) | (0b11111111 >> (8 - lsb)));
 
   // check if we actually need to update the register
   if((currentValue & mask) == (value & mask) && !force) {
@@ -108,6 +136,158 @@ int16_t Module::SPIsetRegValue(uint32_t reg, uint8_t value, uint8_t msb, uint8_t
   #endif
 }
 
+void Module::SPIbeginBatch() {
+  #if RADIOLIB_SPI_BATCH_SIZE
+  this->batchDepth++;
+  #endif
+}
+
+int16_t Module::SPIcommitBatch() {
+  #if RADIOLIB_SPI_BATCH_SIZE
+  if(this->batchDepth == 0) {
+    return(RADIOLIB_ERR_NONE);
+  }
+
+  // only the outermost batch goes to the module
+  this->batchDepth--;
+  if(this->batchDepth > 0) {
+    return(RADIOLIB_ERR_NONE);
+  }
+
+  int16_t state = this->SPIflushBatch();
+
+  // report failures of any partial flush, too
+  if(this->batchState != RADIOLIB_ERR_NONE) {
+    state = this->batchState;
+    this->batchState = RADIOLIB_ERR_NONE;
+  }
+  return(state);
+  #else
+  return(RADIOLIB_ERR_NONE);
+  #endif
+}
+
+#if RADIOLIB_SPI_BATCH_SIZE
+Module::SPIbatchEntry_t* Module::SPIfindBatchEntry(uint32_t reg, bool add) {
+  // entries are kept sorted by address
+  size_t pos = 0;
+  while((pos < this->batchLen) && (this->batch[pos].reg < reg)) {
+    pos++;
+  }
+  if((pos < this->batchLen) && (this->batch[pos].reg == reg)) {
+    return(&this->batch[pos]);
+  }
+  if(!add) {
+    return(NULL);
+  }
+
+  // out of space, write out what we have so far and start over
+  if(this->batchLen == RADIOLIB_SPI_BATCH_SIZE) {
+    int16_t state = this->SPIflushBatch();
+    if(state != RADIOLIB_ERR_NONE) {
+      this->batchState = state;
+    }
+    pos = 0;
+  }
+
+  memmove(&this->batch[pos + 1], &this->batch[pos], (this->batchLen - pos) * sizeof(SPIbatchEntry_t));
+  this->batchLen++;
+  SPIbatchEntry_t* entry = &this->batch[pos];
+  entry->reg = reg;
+  entry->value = SPIreadRegister(reg);
+  entry->checkMask = 0xFF;
+  entry->dirty = false;
+  return(entry);
+}
+
+int16_t Module::SPIflushBatch() {
+  uint8_t data[RADIOLIB_SPI_BATCH_SIZE];
+
+  // write runs of adjacent registers from their first to their last changed one,
+  // unchanged registers in between are written back as they were read
+  size_t i = 0;
+  while(i < this->batchLen) {
+    if(!this->batch[i].dirty) {
+      i++;
+      continue;
+    }
+    size_t last = i;
+    for(size_t j = i + 1; (j < this->batchLen) && (this->batch[j].reg == this->batch[j - 1].reg + 1); j++) {
+      if(this->batch[j].dirty) {
+        last = j;
+      }
+    }
+
+    size_t len = last - i + 1;
+    for(size_t j = 0; j < len; j++) {
+      this->batch[i + j].dirty = true;
+      data[j] = this->batch[i + j].value;
+    }
+    if(len == 1) {
+      SPIwriteRegister(this->batch[i].reg, data[0]);
+    } else {
+      SPIwriteRegisterBurst(this->batch[i].reg | this->spiConfig.cmds[RADIOLIB_MODULE_SPI_COMMAND_BURST], data, len);
+    }
+    i = last + 1;
+  }
+
+  int16_t state = RADIOLIB_ERR_NONE;
+  #if RADIOLIB_SPI_PARANOID
+    // read back everything that was written, until it all matches or the longest check interval is reached
+    RadioLibTime_t start = this->hal->micros();
+    SPIbatchEntry_t* failed = NULL;
+    #if RADIOLIB_DEBUG_SPI
+    uint8_t readValue = 0x00;
+    #endif
+    do {
+      failed = NULL;
+      i = 0;
+      while((i < this->batchLen) && !failed) {
+        if(!this->batch[i].dirty) {
+          i++;
+          continue;
+        }
+        size_t len = 1;
+        while((i + len < this->batchLen) && this->batch[i + len].dirty && (this->batch[i + len].reg == this->batch[i].reg + len)) {
+          len++;
+        }
+
+        if(len == 1) {
+          data[0] = SPIreadRegister(this->batch[i].reg);
+        } else {
+          SPIreadRegisterBurst(this->batch[i].reg | this->spiConfig.cmds[RADIOLIB_MODULE_SPI_COMMAND_BURST], len, data);
+        }
+        for(size_t j = 0; j < len; j++) {
+          SPIbatchEntry_t* entry = &this->batch[i + j];
+          if((data[j] & entry->checkMask) != (entry->value & entry->checkMask)) {
+            failed = entry;
+            #if RADIOLIB_DEBUG_SPI
+            readValue = data[j];
+            #endif
+            break;
+          }
+        }
+        i += len;
+      }
+    } while(failed && (this->hal->micros() - start < (this->batchCheckInterval * 1000)));
+
+    if(failed) {
+      // check failed, print debug info
+      RADIOLIB_DEBUG_SPI_PRINTLN();
+      RADIOLIB_DEBUG_SPI_PRINTLN("address:\t0x%X", failed->reg);
+      RADIOLIB_DEBUG_SPI_PRINTLN("new:\t\t0x%X", failed->value);
+      RADIOLIB_DEBUG_SPI_PRINTLN("mask:\t\t0x%X", failed->checkMask);
+      RADIOLIB_DEBUG_SPI_PRINTLN("read:\t\t0x%X", readValue);
+      state = RADIOLIB_ERR_SPI_WRITE_FAILED;
+    }
+  #endif
+
+  this->batchLen = 0;
+  this->batchCheckInterval = 0;
+  return(state);
+}
+#endif
+
 void Module::SPIreadRegisterBurst(uint32_t reg, size_t numBytes, uint8_t* inBytes) {
   if(!this->spiConfig.stream) {
     SPItransfer(this->spiConfig.cmds[RADIOLIB_MODULE_SPI_COMMAND_READ], reg, NULL, inBytes, numBytes);
@@ -43,6 +43,9 @@
 /*! \def RADIOLIB_MODULE_SPI_COMMAND_STATUS Position of the status command. */
 #define RADIOLIB_MODULE_SPI_COMMAND_STATUS                      (3)
 
+/*! \def RADIOLIB_MODULE_SPI_COMMAND_BURST Position of the flag added to register address for burst access. */
+#define RADIOLIB_MODULE_SPI_COMMAND_BURST                       (4)
+
 /*!
   \}
 */
@@ -192,7 +195,7 @@ class Module {
       int16_t err;
 
       /*! \brief SPI commands */
-      uint16_t cmds[4];
+      uint16_t cmds[5];
 
       /*! \brief Bit widths of SPI addresses, commands and status bytes */
       BitWidth_t widths[3];
@@ -214,7 +217,7 @@ class Module {
     SPIConfig_t spiConfig = {
       .stream = false,
       .err = RADIOLIB_ERR_UNKNOWN,
-      .cmds = { 0x00, 0x80, 0x00, 0x00 },
+      .cmds = { 0x00, 0x80, 0x00, 0x00, 0x00 },
       .widths = { Module::BITS_8, Module::BITS_0, Module::BITS_8 },
       .statusPos = 0,
       .parseStatusCb = nullptr,
@@ -277,6 +280,22 @@ class Module {
     */
     int16_t SPIsetRegValue(uint32_t reg, uint8_t value, uint8_t msb = 7, uint8_t lsb = 0, uint8_t checkInterval = 2, uint8_t checkMask = 0xFF, bool force = false);
 
+    /*!
+      \brief Start a batch of register writes. Until the matching SPIcommitBatch call, SPIsetRegValue only updates
+      a shadow copy of the registers it touches (each register is read from the module once), and SPIgetRegValue
+      returns values from that copy. Batches may be nested, only the outermost commit writes to the module.
+      Registers are written in order of their addresses, so writes whose order matters (e.g. operating mode changes)
+      must be done outside of a batch. SPIreadRegister and SPIwriteRegister always bypass the batch.
+    */
+    void SPIbeginBatch();
+
+    /*!
+      \brief Write all registers changed since SPIbeginBatch, merging adjacent addresses into burst transfers,
+      and verify them with a single read pass (if RADIOLIB_SPI_PARANOID is enabled).
+      \returns \ref status_codes
+    */
+    int16_t SPIcommitBatch();
+
     /*!
       \brief SPI burst read method.
       \param reg Address of SPI register to read.
@@ -536,6 +555,24 @@ class Module {
     #if RADIOLIB_INTERRUPT_TIMING
     uint32_t prevTimingLen = 0;
     #endif
+
+    #if RADIOLIB_SPI_BATCH_SIZE
+    // shadow copies of registers touched by the current batch
+    struct SPIbatchEntry_t {
+      uint32_t reg;
+      uint8_t value;
+      uint8_t checkMask;
+      bool dirty;
+    };
+    SPIbatchEntry_t batch[RADIOLIB_SPI_BATCH_SIZE];
+    size_t batchLen = 0;
+    uint8_t batchDepth = 0;
+    uint8_t batchCheckInterval = 0;
+    int16_t batchState = RADIOLIB_ERR_NONE;
+
+    SPIbatchEntry_t* SPIfindBatchEntry(uint32_t reg, bool add);
+    int16_t SPIflushBatch();
+    #endif
 };
 
 #endif
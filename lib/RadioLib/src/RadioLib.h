@@ -27,7 +27,7 @@
     - 4-FSK (FSK4Client)
     - APRS (APRSClient)
     - POCSAG (PagerClient)
-    - LoRaWAN (LoRaWANNode)
+    - LoRaWAN (LoRaWANNode, LoRaWANFragSession, LoRaWANSessionStore, LoRaWANUplinkQueue)
 
   \par Quick Links
   Documentation for most common methods can be found in its reference page (see the list above).\n
@@ -115,9 +115,13 @@
 #include "protocols/Print/Print.h"
 #include "protocols/BellModem/BellModem.h"
 #include "protocols/LoRaWAN/LoRaWAN.h"
+#include "protocols/LoRaWAN/LoRaWANFrag.h"
+#include "protocols/LoRaWAN/LoRaWANStore.h"
+#include "protocols/LoRaWAN/LoRaWANQueue.h"
 
 // utilities
 #include "utils/CRC.h"
 #include "utils/Cryptography.h"
+#include "utils/EventLoop.h"
 
 #endif
@@ -255,6 +255,21 @@
 */
 #define RADIOLIB_ERR_INVALID_IRQ                               (-29)
 
+/*!
+  \brief All radio slots of the event loop are in use, see RADIOLIB_EVENT_LOOP_RADIOS.
+*/
+#define RADIOLIB_ERR_EVENT_LOOP_FULL                           (-30)
+
+/*!
+  \brief The radio is not attached to the event loop.
+*/
+#define RADIOLIB_ERR_EVENT_LOOP_INVALID_RADIO                  (-31)
+
+/*!
+  \brief The radio is still busy with another operation started by the event loop.
+*/
+#define RADIOLIB_ERR_EVENT_LOOP_BUSY                           (-32)
+
 // RF69-specific status codes
 
 /*!
@@ -380,6 +395,16 @@
 */
 #define RADIOLIB_ERR_ACK_NOT_RECEIVED                          (-504)
 
+/*!
+  \brief All three levels of the Tx FIFO are occupied by packets of the burst that were not sent yet.
+*/
+#define RADIOLIB_ERR_BURST_FIFO_FULL                           (-505)
+
+/*!
+  \brief No burst transmission is running, it has to be started by startBurst first.
+*/
+#define RADIOLIB_ERR_BURST_NOT_STARTED                         (-506)
+
 // CC1101-specific status codes
 
 /*!
@@ -598,6 +623,31 @@
 */
 #define RADIOLIB_ERR_INVALID_MODE                               (-1121)
 
+/*!
+  \brief The multicast group ID or its frame counter range is invalid.
+*/
+#define RADIOLIB_ERR_INVALID_MULTICAST_GROUP                    (-1122)
+
+/*!
+  \brief No LoRaWAN session was found in the session store.
+*/
+#define RADIOLIB_ERR_STORE_EMPTY                                (-1123)
+
+/*!
+  \brief The storage of the session store failed, or is unsuitable (too small or misaligned).
+*/
+#define RADIOLIB_ERR_STORE_FAILED                               (-1124)
+
+/*!
+  \brief The uplink queue has no records to send.
+*/
+#define RADIOLIB_ERR_UPLINK_QUEUE_EMPTY                         (-1125)
+
+/*!
+  \brief The uplink queue has no space left for the record.
+*/
+#define RADIOLIB_ERR_UPLINK_QUEUE_FULL                          (-1126)
+
 // LR11x0-specific status codes
 
 /*!
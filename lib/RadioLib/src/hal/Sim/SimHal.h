@@ -0,0 +1,806 @@
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+// include RadioLib
+#include <RadioLib.h>
+
+#include <string.h>
+#include <math.h>
+
+// host-side simulation of radio modules, for testing and benchmarking drivers
+// and protocols without hardware - all time is virtual, so runs are repeatable
+
+#define SIM_INPUT         (0)
+#define SIM_OUTPUT        (1)
+#define SIM_LOW           (0)
+#define SIM_HIGH          (1)
+#define SIM_RISING        (1)
+#define SIM_FALLING       (2)
+
+// maximum number of radios on one medium, or attached to one HAL
+#if !defined(RADIOLIB_SIM_MAX_RADIOS)
+  #define RADIOLIB_SIM_MAX_RADIOS         (8)
+#endif
+
+// maximum number of transmissions in the air at the same time
+#if !defined(RADIOLIB_SIM_MAX_TRANSMISSIONS)
+  #define RADIOLIB_SIM_MAX_TRANSMISSIONS  (8)
+#endif
+
+// pins are numbered from 0 to this value - 1
+#if !defined(RADIOLIB_SIM_MAX_PINS)
+  #define RADIOLIB_SIM_MAX_PINS           (64)
+#endif
+
+// timestamp used for "no event scheduled"
+#define RADIOLIB_SIM_NEVER                (0xFFFFFFFFFFFFFFFFULL)
+
+// number of preamble symbols a receiver needs to see to lock onto a packet
+#define RADIOLIB_SIM_PREAMBLE_LOCK        (5)
+
+class SimRadio;
+class SimHal;
+
+/*!
+  \struct SimLoRaConfig_t
+  \brief LoRa settings of a simulated radio, as decoded from its registers.
+*/
+struct SimLoRaConfig_t {
+  /*! \brief Carrier frequency in Hz. */
+  uint32_t freq;
+
+  /*! \brief Bandwidth in Hz. */
+  uint32_t bw;
+
+  /*! \brief Spreading factor, 5 to 12. */
+  uint8_t sf;
+
+  /*! \brief Coding rate denominator minus 4, i.e. 1 for 4/5 up to 4 for 4/8. */
+  uint8_t cr;
+
+  /*! \brief Preamble length in symbols. */
+  uint16_t preamble;
+
+  /*! \brief Whether the implicit (fixed length) header mode is used. */
+  bool implicitHeader;
+
+  /*! \brief Whether payload CRC is appended. */
+  bool crc;
+
+  /*! \brief Whether low data rate optimization is enabled. */
+  bool ldro;
+
+  /*! \brief Whether IQ inversion is enabled. */
+  bool invertIq;
+
+  /*! \brief Sync word in the SX127x single-byte format (SX126x words are converted). */
+  uint8_t syncWord;
+};
+
+/*!
+  \struct SimTransmission_t
+  \brief One packet on the simulated medium.
+*/
+struct SimTransmission_t {
+  /*! \brief Unique ID of this transmission, never 0. */
+  uint32_t id;
+
+  /*! \brief Radio that transmitted the packet. */
+  SimRadio* sender;
+
+  /*! \brief Settings the packet was sent with. */
+  SimLoRaConfig_t cfg;
+
+  /*! \brief Start and end of the transmission in virtual microseconds. */
+  uint64_t start;
+  uint64_t end;
+
+  /*! \brief Another transmission overlapped this one on the same channel. */
+  bool collided;
+
+  /*! \brief Payload. */
+  uint8_t data[256];
+  size_t len;
+
+  /*! \brief Whether this slot is in use. */
+  bool active;
+};
+
+/*!
+  \struct SimStats_t
+  \brief Counters kept for every simulated radio, for benchmarking.
+*/
+struct SimStats_t {
+  /*! \brief Number of SPI transactions and bytes clocked over them. */
+  uint32_t spiTransactions;
+  uint32_t spiBytes;
+
+  /*! \brief Number of packets transmitted, received and missed due to loss or collision. */
+  uint32_t txPackets;
+  uint32_t rxPackets;
+  uint32_t rxDropped;
+
+  /*! \brief Time spent transmitting and receiving in microseconds. */
+  uint64_t txTimeUs;
+  uint64_t rxTimeUs;
+};
+
+/*!
+  \class SimAir
+  \brief Shared medium and virtual clock for a group of simulated radios.
+  All radios and HALs created with the same SimAir see the same time and can hear each other,
+  subject to matching settings, configurable packet loss and collisions.
+*/
+class SimAir {
+  public:
+    /*!
+      \brief Default constructor.
+      \param seed Seed of the pseudo-random generator used for packet loss and random registers.
+    */
+    explicit SimAir(uint32_t seed = 1) {
+      // spread the seed over all bits, small seeds would give small numbers for a while
+      this->rngState = (seed ^ 0x5DEECE66UL) * 0x9E3779B1UL;
+      if(this->rngState == 0) {
+        this->rngState = 1;
+      }
+    }
+
+    /*!
+      \brief Current virtual time in microseconds.
+    */
+    uint64_t now() const {
+      return(this->time);
+    }
+
+    /*!
+      \brief Move the clock forward, running all events that fall into the interval.
+      \param us Number of microseconds to advance.
+    */
+    void advance(uint64_t us) {
+      this->runUntil(this->time + us);
+    }
+
+    /*!
+      \brief Move the clock to an absolute time, running all events up to it.
+      \param until Target time in microseconds; times in the past are ignored.
+    */
+    void runUntil(uint64_t until);
+
+    /*!
+      \brief Set probability that a packet is lost for a given receiver.
+      \param probability Loss probability from 0 (none) to 1 (all packets lost).
+    */
+    void setLoss(float probability) {
+      // 1.0f * 4294967295.0f rounds to 2^32, which doesn't fit uint32_t
+      this->loss = probability >= 1.0f ? 0xFFFFFFFFUL : probability <= 0.0f ? 0 : (uint32_t)(probability * 4294967295.0);
+    }
+
+    /*!
+      \brief Set the link quality reported by receivers.
+      \param rssi Received signal strength in dBm.
+      \param snr Signal-to-noise ratio in dB.
+    */
+    void setLink(float rssi, float snr) {
+      this->rssi = rssi;
+      this->snr = snr;
+    }
+
+    /*!
+      \brief Enable or disable collisions between overlapping packets on the same channel.
+      \param enable Whether overlapping packets should be dropped, enabled by default.
+    */
+    void setCollisions(bool enable) {
+      this->collisions = enable;
+    }
+
+    /*!
+      \brief Get the next pseudo-random number.
+    */
+    uint32_t random() {
+      // xorshift32
+      uint32_t x = this->rngState;
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      this->rngState = x;
+      return(x);
+    }
+
+    /*!
+      \brief Duration of one LoRa symbol in microseconds.
+    */
+    static float getSymbolTime(const SimLoRaConfig_t& cfg) {
+      return((float)(1UL << cfg.sf) * 1000000.0f / (float)cfg.bw);
+    }
+
+    /*!
+      \brief LoRa time-on-air of a packet, using the formula from Semtech AN1200.13.
+      \param cfg Modulation and packet settings.
+      \param len Payload length in bytes.
+      \returns Time-on-air in microseconds.
+    */
+    static uint64_t getTimeOnAir(const SimLoRaConfig_t& cfg, size_t len) {
+      float sym = getSymbolTime(cfg);
+      int de = cfg.ldro ? 1 : 0;
+      int num = 8*(int)len - 4*cfg.sf + 28 + (cfg.crc ? 16 : 0) - (cfg.implicitHeader ? 20 : 0);
+      int den = 4*(cfg.sf - 2*de);
+      int payloadSymb = 8;
+      if(num > 0) {
+        payloadSymb += ((num + den - 1) / den) * (cfg.cr + 4);
+      }
+      return((uint64_t)((cfg.preamble + 4.25f + payloadSymb) * sym));
+    }
+
+    /*!
+      \brief Whether a receiver with one configuration can demodulate packets sent with another.
+    */
+    static bool matches(const SimLoRaConfig_t& rx, const SimLoRaConfig_t& tx) {
+      // LoRa tolerates a carrier offset of up to a quarter of the bandwidth
+      uint32_t df = (rx.freq > tx.freq) ? rx.freq - tx.freq : tx.freq - rx.freq;
+      return((df <= rx.bw / 4) && (rx.bw == tx.bw) && (rx.sf == tx.sf) &&
+             (rx.syncWord == tx.syncWord) && (rx.invertIq == tx.invertIq));
+    }
+
+    /*! \brief Number of packets sent, collided and lost since the medium was created. */
+    uint32_t packetsSent = 0;
+    uint32_t packetsCollided = 0;
+    uint32_t packetsLost = 0;
+
+#if !RADIOLIB_GODMODE
+  private:
+#endif
+    friend class SimRadio;
+    friend class SimHal;
+
+    uint64_t time = 0;
+    uint32_t rngState;
+    uint32_t loss = 0;
+    float rssi = -60.0f;
+    float snr = 9.5f;
+    bool collisions = true;
+    bool running = false;
+    uint32_t lastId = 0;
+
+    SimRadio* radios[RADIOLIB_SIM_MAX_RADIOS] = { NULL };
+    size_t numRadios = 0;
+    SimHal* hals[RADIOLIB_SIM_MAX_RADIOS] = { NULL };
+    size_t numHals = 0;
+    SimTransmission_t air[RADIOLIB_SIM_MAX_TRANSMISSIONS] = {};
+
+    void addRadio(SimRadio* radio) {
+      if(this->numRadios < RADIOLIB_SIM_MAX_RADIOS) {
+        this->radios[this->numRadios++] = radio;
+      }
+    }
+
+    void addHal(SimHal* hal) {
+      if(this->numHals < RADIOLIB_SIM_MAX_RADIOS) {
+        this->hals[this->numHals++] = hal;
+      }
+    }
+
+    // put a packet on the air, returns the time it will end or RADIOLIB_SIM_NEVER if the medium is full
+    uint64_t transmit(SimRadio* sender, const SimLoRaConfig_t& cfg, const uint8_t* data, size_t len);
+
+    // abort transmission from this radio (e.g. when it is put to standby mid-packet)
+    void abort(SimRadio* sender);
+
+    // ID of a packet whose preamble the radio is detecting right now, 0 if there is none
+    uint32_t preambleDetected(const SimRadio* radio) const;
+
+    // whether a CAD with this configuration would see a preamble or payload right now
+    bool channelActive(const SimLoRaConfig_t& cfg) const;
+
+    // time of the next pending event
+    uint64_t nextEvent() const;
+
+    // tell all HALs pin levels may have changed
+    void notify();
+
+    bool canHear(const SimRadio* radio, const SimTransmission_t& tx) const;
+    void finish(SimTransmission_t& tx);
+};
+
+/*!
+  \class SimRadio
+  \brief Base class of simulated radio modules.
+  The chip models implement SPI decoding and pin levels, this class keeps the parts shared by all models.
+*/
+class SimRadio {
+  public:
+    /*! \brief Counters for benchmarking. */
+    SimStats_t stats;
+
+    /*!
+      \brief Default constructor.
+      \param air Medium this radio transmits to and receives from.
+    */
+    explicit SimRadio(SimAir& air) : air(&air) {
+      memset(&this->stats, 0, sizeof(this->stats));
+      air.addRadio(this);
+    }
+
+    virtual ~SimRadio() {}
+
+#if !RADIOLIB_GODMODE
+  protected:
+#endif
+    friend class SimAir;
+    friend class SimHal;
+
+    SimAir* air;
+
+    // pending internal event of the model, e.g. Rx timeout or end of CAD
+    uint64_t timer = RADIOLIB_SIM_NEVER;
+
+    // receiver state
+    bool receiving = false;
+    SimLoRaConfig_t rxConfig = {};
+    uint64_t rxSince = 0;
+    uint32_t lockId = 0;
+
+    // full-duplex SPI transfer of one transaction (CS low to CS high)
+    virtual void spiTransfer(const uint8_t* out, uint8_t* in, size_t len) = 0;
+
+    // reset pin was released
+    virtual void reset() = 0;
+
+    // levels of the pins passed to Module as "irq" and "gpio"
+    virtual bool irqLevel() = 0;
+    virtual bool gpioLevel() = 0;
+
+    // the model timer expired
+    virtual void onTimer() = 0;
+
+    // own transmission finished
+    virtual void onTxDone() = 0;
+
+    // a packet this radio was listening for ended; ok is false if it was lost or collided
+    virtual void onRxDone(const SimTransmission_t& tx, bool ok) = 0;
+
+    void startRx(const SimLoRaConfig_t& cfg) {
+      this->stopRx();
+      this->receiving = true;
+      this->rxConfig = cfg;
+      this->rxSince = this->air->now();
+      this->lockId = 0;
+    }
+
+    void stopRx() {
+      if(this->receiving) {
+        this->stats.rxTimeUs += this->air->now() - this->rxSince;
+      }
+      this->receiving = false;
+      this->lockId = 0;
+    }
+
+    bool startTx(const SimLoRaConfig_t& cfg, const uint8_t* data, size_t len) {
+      this->stopRx();
+      uint64_t end = this->air->transmit(this, cfg, data, len);
+      if(end == RADIOLIB_SIM_NEVER) {
+        return(false);
+      }
+      this->stats.txPackets++;
+      this->stats.txTimeUs += end - this->air->now();
+      return(true);
+    }
+
+    void stopTx() {
+      this->air->abort(this);
+    }
+
+    // ID of a packet whose preamble this radio is detecting right now, 0 if there is none
+    uint32_t preambleDetected() const {
+      return(this->air->preambleDetected(this));
+    }
+
+    bool channelActive(const SimLoRaConfig_t& cfg) const {
+      return(this->air->channelActive(cfg));
+    }
+
+    uint32_t random() {
+      return(this->air->random());
+    }
+
+    // link quality seen by receivers
+    float linkRssi() const {
+      return(this->air->rssi);
+    }
+
+    float linkSnr() const {
+      return(this->air->snr);
+    }
+};
+
+/*!
+  \class SimHal
+  \brief RadioLib HAL connected to simulated radios instead of hardware.
+  SPI transfers are routed to the radio whose chip select is low, delays and polling advance the virtual clock
+  and interrupts are called when the simulated DIO pins change.
+*/
+class SimHal : public RadioLibHal {
+  public:
+    /*!
+      \brief Default constructor.
+      \param air Medium (and clock) this HAL lives in.
+      \param spiSpeed Simulated SPI clock in Hz, used to account for the time spent on transfers.
+    */
+    explicit SimHal(SimAir& air, uint32_t spiSpeed = 8000000)
+      : RadioLibHal(SIM_INPUT, SIM_OUTPUT, SIM_LOW, SIM_HIGH, SIM_RISING, SIM_FALLING),
+      air(&air),
+      spiSpeed(spiSpeed) {
+      memset(this->levels, SIM_HIGH, sizeof(this->levels));
+      air.addHal(this);
+    }
+
+    /*!
+      \brief Connect a simulated radio to this HAL, using the same pins that are passed to Module.
+      \param radio Radio model to attach.
+      \param cs Chip select pin.
+      \param irq Interrupt pin (DIO0 on SX127x, DIO1 on SX126x).
+      \param rst Reset pin.
+      \param gpio GPIO pin (DIO1 on SX127x, BUSY on SX126x).
+    */
+    void attach(SimRadio& radio, uint32_t cs, uint32_t irq, uint32_t rst, uint32_t gpio = RADIOLIB_NC) {
+      if(this->numPorts >= RADIOLIB_SIM_MAX_RADIOS) {
+        return;
+      }
+      SimPort_t* port = &this->ports[this->numPorts++];
+      port->radio = &radio;
+      port->cs = cs;
+      port->irq = irq;
+      port->rst = rst;
+      port->gpio = gpio;
+      port->irqLast = radio.irqLevel();
+      port->gpioLast = radio.gpioLevel();
+    }
+
+    /*!
+      \brief Set how far the clock moves on each call to yield().
+      Busy-wait loops in the drivers call yield(), so this is the resolution of polled events.
+      \param us Step in microseconds, 100 us by default.
+    */
+    void setYieldStep(uint32_t us) {
+      this->yieldStep = us;
+    }
+
+    void pinMode(uint32_t pin, uint32_t mode) override {
+      (void)pin;
+      (void)mode;
+    }
+
+    void digitalWrite(uint32_t pin, uint32_t value) override {
+      if((pin == RADIOLIB_NC) || (pin >= RADIOLIB_SIM_MAX_PINS)) {
+        return;
+      }
+
+      uint8_t prev = this->levels[pin];
+      this->levels[pin] = value ? SIM_HIGH : SIM_LOW;
+
+      // rising edge on reset releases the radio
+      if((prev == SIM_LOW) && (value != SIM_LOW)) {
+        for(size_t i = 0; i < this->numPorts; i++) {
+          if(this->ports[i].rst == pin) {
+            this->ports[i].radio->reset();
+          }
+        }
+        this->update();
+      }
+    }
+
+    uint32_t digitalRead(uint32_t pin) override {
+      if((pin == RADIOLIB_NC) || (pin >= RADIOLIB_SIM_MAX_PINS)) {
+        return(SIM_LOW);
+      }
+
+      for(size_t i = 0; i < this->numPorts; i++) {
+        if(this->ports[i].irq == pin) {
+          return(this->ports[i].radio->irqLevel() ? SIM_HIGH : SIM_LOW);
+        }
+        if(this->ports[i].gpio == pin) {
+          return(this->ports[i].radio->gpioLevel() ? SIM_HIGH : SIM_LOW);
+        }
+      }
+      return(this->levels[pin]);
+    }
+
+    void attachInterrupt(uint32_t interruptNum, void (*interruptCb)(void), uint32_t mode) override {
+      if((interruptNum == RADIOLIB_NC) || (interruptNum >= RADIOLIB_SIM_MAX_PINS)) {
+        return;
+      }
+      this->interruptCallbacks[interruptNum] = interruptCb;
+      this->interruptModes[interruptNum] = mode;
+    }
+
+    void detachInterrupt(uint32_t interruptNum) override {
+      if((interruptNum == RADIOLIB_NC) || (interruptNum >= RADIOLIB_SIM_MAX_PINS)) {
+        return;
+      }
+      this->interruptCallbacks[interruptNum] = NULL;
+      this->interruptModes[interruptNum] = 0;
+    }
+
+    void delay(unsigned long ms) override {
+      this->air->advance((uint64_t)ms * 1000);
+    }
+
+    void delayMicroseconds(unsigned long us) override {
+      this->air->advance(us);
+    }
+
+    void yield() override {
+      this->air->advance(this->yieldStep);
+    }
+
+    // reading the clock costs a microsecond, so loops that only poll time still make progress
+    unsigned long millis() override {
+      this->air->advance(1);
+      return((unsigned long)(this->air->now() / 1000));
+    }
+
+    unsigned long micros() override {
+      this->air->advance(1);
+      return((unsigned long)this->air->now());
+    }
+
+    long pulseIn(uint32_t pin, uint32_t state, unsigned long timeout) override {
+      (void)pin;
+      (void)state;
+      (void)timeout;
+      return(0);
+    }
+
+    void spiBegin() override {}
+
+    void spiBeginTransaction() override {}
+
+    void spiTransfer(uint8_t* out, size_t len, uint8_t* in) override {
+      // nothing is driving MISO unless a chip is selected
+      memset(in, 0x00, len);
+      for(size_t i = 0; i < this->numPorts; i++) {
+        SimPort_t* port = &this->ports[i];
+        if((port->cs < RADIOLIB_SIM_MAX_PINS) && (this->levels[port->cs] == SIM_LOW)) {
+          port->radio->spiTransfer(out, in, len);
+          port->radio->stats.spiTransactions++;
+          port->radio->stats.spiBytes += len;
+        }
+      }
+
+      // account for the time the transfer takes on the bus
+      this->air->advance(((uint64_t)len * 8 * 1000000UL + this->spiSpeed - 1) / this->spiSpeed);
+      this->update();
+    }
+
+    void spiEndTransaction() override {}
+
+    void spiEnd() override {}
+
+    /*!
+      \brief Check all attached radios for pin changes and call interrupt handlers.
+      Called automatically whenever the simulation state changes.
+    */
+    void update() {
+      // do not call handlers from within handlers
+      if(this->inInterrupt) {
+        return;
+      }
+      this->inInterrupt = true;
+      for(size_t i = 0; i < this->numPorts; i++) {
+        SimPort_t* port = &this->ports[i];
+        bool irq = port->radio->irqLevel();
+        bool gpio = port->radio->gpioLevel();
+        if(irq != port->irqLast) {
+          port->irqLast = irq;
+          this->edge(port->irq, irq);
+        }
+        if(gpio != port->gpioLast) {
+          port->gpioLast = gpio;
+          this->edge(port->gpio, gpio);
+        }
+      }
+      this->inInterrupt = false;
+    }
+
+#if !RADIOLIB_GODMODE
+  private:
+#endif
+    struct SimPort_t {
+      SimRadio* radio;
+      uint32_t cs;
+      uint32_t irq;
+      uint32_t rst;
+      uint32_t gpio;
+      bool irqLast;
+      bool gpioLast;
+    };
+
+    SimAir* air;
+    const uint32_t spiSpeed;
+    uint32_t yieldStep = 100;
+    SimPort_t ports[RADIOLIB_SIM_MAX_RADIOS] = {};
+    size_t numPorts = 0;
+    uint8_t levels[RADIOLIB_SIM_MAX_PINS];
+    void (*interruptCallbacks[RADIOLIB_SIM_MAX_PINS])(void) = { NULL };
+    uint32_t interruptModes[RADIOLIB_SIM_MAX_PINS] = { 0 };
+    bool inInterrupt = false;
+
+    void edge(uint32_t pin, bool level) {
+      if((pin >= RADIOLIB_SIM_MAX_PINS) || (this->interruptCallbacks[pin] == NULL)) {
+        return;
+      }
+      uint32_t mode = this->interruptModes[pin];
+      if((level && (mode == SIM_RISING)) || (!level && (mode == SIM_FALLING))) {
+        this->interruptCallbacks[pin]();
+      }
+    }
+};
+
+inline void SimAir::runUntil(uint64_t until) {
+  // nested calls (e.g. a delay inside an interrupt handler) only move the clock,
+  // events will be processed by the outer call
+  if(this->running) {
+    if(until > this->time) {
+      this->time = until;
+    }
+    return;
+  }
+
+  this->running = true;
+  while(true) {
+    uint64_t next = this->nextEvent();
+    if((next == RADIOLIB_SIM_NEVER) || (next > until)) {
+      break;
+    }
+    if(next > this->time) {
+      this->time = next;
+    }
+
+    // transmissions first, so a receiver timing out at the same moment still gets the packet
+    for(size_t i = 0; i < RADIOLIB_SIM_MAX_TRANSMISSIONS; i++) {
+      if(this->air[i].active && (this->air[i].end <= this->time)) {
+        this->finish(this->air[i]);
+      }
+    }
+    for(size_t i = 0; i < this->numRadios; i++) {
+      if(this->radios[i]->timer <= this->time) {
+        this->radios[i]->timer = RADIOLIB_SIM_NEVER;
+        this->radios[i]->onTimer();
+      }
+    }
+    this->notify();
+  }
+  if(until > this->time) {
+    this->time = until;
+  }
+  this->running = false;
+}
+
+inline uint64_t SimAir::transmit(SimRadio* sender, const SimLoRaConfig_t& cfg, const uint8_t* data, size_t len) {
+  SimTransmission_t* tx = NULL;
+  for(size_t i = 0; i < RADIOLIB_SIM_MAX_TRANSMISSIONS; i++) {
+    if(!this->air[i].active) {
+      tx = &this->air[i];
+      break;
+    }
+  }
+  if(!tx) {
+    return(RADIOLIB_SIM_NEVER);
+  }
+
+  tx->id = ++this->lastId;
+  tx->sender = sender;
+  tx->cfg = cfg;
+  tx->start = this->time;
+  tx->end = this->time + getTimeOnAir(cfg, len);
+  tx->len = (len > sizeof(tx->data)) ? sizeof(tx->data) : len;
+  memcpy(tx->data, data, tx->len);
+  tx->collided = false;
+  tx->active = true;
+  this->packetsSent++;
+
+  // no capture effect - packets overlapping on the same channel and spreading factor destroy each other
+  if(this->collisions) {
+    for(size_t i = 0; i < RADIOLIB_SIM_MAX_TRANSMISSIONS; i++) {
+      SimTransmission_t* other = &this->air[i];
+      if((other != tx) && other->active && (other->cfg.sf == cfg.sf) &&
+         ((other->cfg.freq > cfg.freq ? other->cfg.freq - cfg.freq : cfg.freq - other->cfg.freq) < cfg.bw)) {
+        other->collided = true;
+        tx->collided = true;
+      }
+    }
+  }
+  return(tx->end);
+}
+
+inline void SimAir::abort(SimRadio* sender) {
+  for(size_t i = 0; i < RADIOLIB_SIM_MAX_TRANSMISSIONS; i++) {
+    if(this->air[i].active && (this->air[i].sender == sender)) {
+      this->air[i].active = false;
+    }
+  }
+}
+
+inline bool SimAir::canHear(const SimRadio* radio, const SimTransmission_t& tx) const {
+  if((radio == tx.sender) || !radio->receiving || !matches(radio->rxConfig, tx.cfg)) {
+    return(false);
+  }
+  if(radio->lockId == tx.id) {
+    return(true);
+  }
+
+  // the receiver has to be listening early enough to catch the end of the preamble
+  uint64_t lock = (uint64_t)(RADIOLIB_SIM_PREAMBLE_LOCK * getSymbolTime(tx.cfg));
+  uint64_t preambleEnd = tx.start + (uint64_t)(tx.cfg.preamble * getSymbolTime(tx.cfg));
+  return(radio->rxSince + lock <= preambleEnd);
+}
+
+inline uint32_t SimAir::preambleDetected(const SimRadio* radio) const {
+  for(size_t i = 0; i < RADIOLIB_SIM_MAX_TRANSMISSIONS; i++) {
+    const SimTransmission_t& tx = this->air[i];
+    uint64_t lock = (uint64_t)(RADIOLIB_SIM_PREAMBLE_LOCK * getSymbolTime(tx.cfg));
+    if(tx.active && this->canHear(radio, tx) && (tx.start + lock <= this->time)) {
+      return(tx.id);
+    }
+  }
+  return(0);
+}
+
+inline bool SimAir::channelActive(const SimLoRaConfig_t& cfg) const {
+  for(size_t i = 0; i < RADIOLIB_SIM_MAX_TRANSMISSIONS; i++) {
+    const SimTransmission_t& tx = this->air[i];
+    uint32_t df = (tx.cfg.freq > cfg.freq) ? tx.cfg.freq - cfg.freq : cfg.freq - tx.cfg.freq;
+    if(tx.active && (tx.cfg.sf == cfg.sf) && (tx.cfg.bw == cfg.bw) && (df <= cfg.bw / 4) && (tx.cfg.invertIq == cfg.invertIq)) {
+      return(true);
+    }
+  }
+  return(false);
+}
+
+inline uint64_t SimAir::nextEvent() const {
+  uint64_t next = RADIOLIB_SIM_NEVER;
+  for(size_t i = 0; i < RADIOLIB_SIM_MAX_TRANSMISSIONS; i++) {
+    if(this->air[i].active && (this->air[i].end < next)) {
+      next = this->air[i].end;
+    }
+  }
+  for(size_t i = 0; i < this->numRadios; i++) {
+    if(this->radios[i]->timer < next) {
+      next = this->radios[i]->timer;
+    }
+  }
+  return(next);
+}
+
+inline void SimAir::finish(SimTransmission_t& tx) {
+  tx.active = false;
+  if(tx.collided) {
+    this->packetsCollided++;
+  }
+
+  for(size_t i = 0; i < this->numRadios; i++) {
+    SimRadio* radio = this->radios[i];
+    if(!this->canHear(radio, tx)) {
+      continue;
+    }
+    bool ok = !tx.collided;
+    if(ok && this->loss && (this->random() <= this->loss)) {
+      ok = false;
+      this->packetsLost++;
+    }
+    if(ok) {
+      radio->stats.rxPackets++;
+    } else {
+      radio->stats.rxDropped++;
+    }
+    radio->onRxDone(tx, ok);
+  }
+  tx.sender->onTxDone();
+}
+
+inline void SimAir::notify() {
+  for(size_t i = 0; i < this->numHals; i++) {
+    this->hals[i]->update();
+  }
+}
+
+#endif
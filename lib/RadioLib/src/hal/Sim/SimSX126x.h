@@ -0,0 +1,464 @@
+#ifndef SIM_SX126X_H
+#define SIM_SX126X_H
+
+#include "SimHal.h"
+
+/*!
+  \class SimSX126x
+  \brief Command decoder model of SX1261/62/68 in LoRa mode.
+  Covers operating modes, data buffer, registers, IRQ status with DIO1 routing, Rx timeout and continuous Rx,
+  CAD (including CAD followed by Rx), packet status and the random number registers.
+  BUSY is always low. Other packet types are accepted but only LoRa packets are put on the air;
+  Rx duty cycle mode is treated as continuous Rx.
+*/
+class SimSX126x : public SimRadio {
+  public:
+    /*!
+      \brief Default constructor.
+      \param air Medium this radio transmits to and receives from.
+      \param version Contents of the version string register, "SX1261" prefix for SX1261/62, "SX1268" for SX1268.
+    */
+    explicit SimSX126x(SimAir& air, const char* version = "SX1261 V2D 2D02") : SimRadio(air) {
+      strncpy(this->versionString, version, sizeof(this->versionString) - 1);
+      this->versionString[sizeof(this->versionString) - 1] = '\0';
+      this->reset();
+    }
+
+    /*!
+      \brief Direct access to the register space, e.g. to check driver configuration in a test.
+    */
+    uint8_t getRegister(uint16_t addr) const {
+      return(this->regs[addr % sizeof(this->regs)]);
+    }
+
+    /*!
+      \brief LoRa settings as currently configured.
+    */
+    SimLoRaConfig_t getConfig() const {
+      SimLoRaConfig_t cfg = this->lora;
+      cfg.syncWord = (this->regs[0x0740] & 0xF0) | (this->regs[0x0741] >> 4);
+      return(cfg);
+    }
+
+#if !RADIOLIB_GODMODE
+  protected:
+#endif
+    // chip modes, as reported in the status byte
+    enum {
+      MODE_STDBY_RC = 0x20,
+      MODE_STDBY_XOSC = 0x30,
+      MODE_FS = 0x40,
+      MODE_RX = 0x50,
+      MODE_TX = 0x60,
+    };
+
+    // IRQ bits
+    enum {
+      IRQ_TX_DONE = 0x0001,
+      IRQ_RX_DONE = 0x0002,
+      IRQ_PREAMBLE_DETECTED = 0x0004,
+      IRQ_HEADER_VALID = 0x0010,
+      IRQ_CAD_DONE = 0x0080,
+      IRQ_CAD_DETECTED = 0x0100,
+      IRQ_TIMEOUT = 0x0200,
+    };
+
+    char versionString[16];
+    uint8_t regs[0x1000];
+    uint8_t buffer[256];
+    uint8_t chipMode;
+    uint8_t cmdStatus;
+    uint8_t fallback;
+    uint8_t packetType;
+    bool sleeping;
+    bool continuous;
+    bool cad;
+    uint8_t cadExit;
+    uint8_t cadSymbols;
+    uint32_t cadTimeout;
+    SimLoRaConfig_t lora;
+    uint8_t txBase;
+    uint8_t rxBase;
+    uint8_t payloadLen;
+    uint8_t rxLen;
+    uint8_t rxStart;
+    uint16_t irqStatus;
+    uint16_t irqMask;
+    uint16_t dio1Mask;
+    uint8_t packetStatus[3];
+
+    void reset() override {
+      memset(this->regs, 0x00, sizeof(this->regs));
+      memcpy(&this->regs[0x0320], this->versionString, sizeof(this->versionString));
+      this->regs[0x0740] = 0x14;
+      this->regs[0x0741] = 0x24;
+      this->regs[0x0736] = 0x0D;
+      this->regs[0x08E7] = 0x18;
+      memset(this->buffer, 0x00, sizeof(this->buffer));
+      this->chipMode = MODE_STDBY_RC;
+      this->cmdStatus = 0;
+      this->fallback = MODE_STDBY_RC;
+      this->packetType = 0x00;
+      this->sleeping = false;
+      this->continuous = false;
+      this->cad = false;
+      this->cadExit = 0;
+      this->cadSymbols = 8;
+      this->cadTimeout = 0;
+      this->lora.freq = 915000000UL;
+      this->lora.bw = 125000;
+      this->lora.sf = 7;
+      this->lora.cr = 1;
+      this->lora.preamble = 12;
+      this->lora.implicitHeader = false;
+      this->lora.crc = true;
+      this->lora.ldro = false;
+      this->lora.invertIq = false;
+      this->lora.syncWord = 0x12;
+      this->txBase = 0;
+      this->rxBase = 0;
+      this->payloadLen = 0xFF;
+      this->rxLen = 0;
+      this->rxStart = 0;
+      this->irqStatus = 0;
+      this->irqMask = 0;
+      this->dio1Mask = 0;
+      memset(this->packetStatus, 0x00, sizeof(this->packetStatus));
+      this->stopRx();
+      this->stopTx();
+      this->timer = RADIOLIB_SIM_NEVER;
+    }
+
+    uint8_t status() const {
+      return(this->chipMode | this->cmdStatus);
+    }
+
+    void spiTransfer(const uint8_t* out, uint8_t* in, size_t len) override {
+      if(len == 0) {
+        return;
+      }
+
+      // falling edge of NSS wakes the chip up
+      if(this->sleeping) {
+        this->sleeping = false;
+        this->chipMode = MODE_STDBY_RC;
+      }
+
+      this->cmdStatus = 0;
+      const uint8_t* p = &out[1];
+      size_t n = len - 1;
+      size_t data = len;
+      switch(out[0]) {
+        case 0x0D: {
+          // WriteRegister: address, data
+          if(n < 2) { break; }
+          uint16_t addr = ((uint16_t)p[0] << 8) | p[1];
+          for(size_t i = 2; i < n; i++) {
+            this->regs[(addr + i - 2) % sizeof(this->regs)] = p[i];
+          }
+        } break;
+        case 0x1D: {
+          // ReadRegister: address, status, data
+          if(n < 3) { break; }
+          uint16_t addr = ((uint16_t)p[0] << 8) | p[1];
+          data = 4;
+          for(size_t i = data; i < len; i++) {
+            in[i] = this->readRegister(addr + i - data);
+          }
+        } break;
+        case 0x0E:
+          // WriteBuffer: offset, data
+          if(n < 1) { break; }
+          for(size_t i = 1; i < n; i++) {
+            this->buffer[(uint8_t)(p[0] + i - 1)] = p[i];
+          }
+          break;
+        case 0x1E:
+          // ReadBuffer: offset, status, data
+          if(n < 2) { break; }
+          data = 3;
+          for(size_t i = data; i < len; i++) {
+            in[i] = this->buffer[(uint8_t)(p[0] + i - data)];
+          }
+          break;
+        case 0x84:
+          // SetSleep
+          this->toMode(MODE_STDBY_RC);
+          this->sleeping = true;
+          break;
+        case 0x80:
+          // SetStandby
+          this->toMode((n > 0) && p[0] ? MODE_STDBY_XOSC : MODE_STDBY_RC);
+          break;
+        case 0xC1:
+          // SetFs
+          this->toMode(MODE_FS);
+          break;
+        case 0x83:
+          // SetTx
+          this->setTx();
+          break;
+        case 0x82:
+          // SetRx
+          if(n < 3) { break; }
+          this->setRx(((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2]);
+          break;
+        case 0x94:
+          // SetRxDutyCycle
+          this->setRx(0xFFFFFF);
+          break;
+        case 0xC5:
+          // SetCad
+          this->setCad();
+          break;
+        case 0xD1:
+        case 0xD2:
+          // SetTxContinuousWave, SetTxInfinitePreamble - nothing goes on the air
+          this->toMode(MODE_TX);
+          break;
+        case 0x93:
+          // SetRxTxFallbackMode
+          if(n < 1) { break; }
+          this->fallback = p[0];
+          break;
+        case 0x08:
+          // SetDioIrqParams: IRQ mask, DIO1 mask, DIO2 mask, DIO3 mask
+          if(n < 4) { break; }
+          this->irqMask = ((uint16_t)p[0] << 8) | p[1];
+          this->dio1Mask = ((uint16_t)p[2] << 8) | p[3];
+          break;
+        case 0x12:
+          // GetIrqStatus
+          data = 2;
+          this->reply(in, len, data, (uint8_t)(this->irqStatus >> 8), (uint8_t)this->irqStatus);
+          break;
+        case 0x02:
+          // ClearIrqStatus
+          if(n < 2) { break; }
+          this->irqStatus &= ~(((uint16_t)p[0] << 8) | p[1]);
+          break;
+        case 0x86: {
+          // SetRfFrequency
+          if(n < 4) { break; }
+          uint32_t frf = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+          this->lora.freq = (uint32_t)(((uint64_t)frf * 32000000ULL) >> 25);
+        } break;
+        case 0x8A:
+          // SetPacketType
+          if(n < 1) { break; }
+          this->packetType = p[0];
+          break;
+        case 0x11:
+          // GetPacketType
+          data = 2;
+          this->reply(in, len, data, this->packetType);
+          break;
+        case 0x8B:
+          // SetModulationParams
+          if((n < 4) || (this->packetType != 0x01)) { break; }
+          this->setModulationParams(p);
+          break;
+        case 0x8C:
+          // SetPacketParams
+          if((n < 6) || (this->packetType != 0x01)) { break; }
+          this->lora.preamble = ((uint16_t)p[0] << 8) | p[1];
+          this->lora.implicitHeader = p[2];
+          this->payloadLen = p[3];
+          this->lora.crc = p[4];
+          this->lora.invertIq = p[5];
+          break;
+        case 0x88:
+          // SetCadParams: symbols, peak, min, exit mode, timeout
+          if(n < 7) { break; }
+          this->cadSymbols = 1 << (p[0] > 4 ? 4 : p[0]);
+          this->cadExit = p[3];
+          this->cadTimeout = ((uint32_t)p[4] << 16) | ((uint32_t)p[5] << 8) | p[6];
+          break;
+        case 0x8F:
+          // SetBufferBaseAddress
+          if(n < 2) { break; }
+          this->txBase = p[0];
+          this->rxBase = p[1];
+          break;
+        case 0xC0:
+          // GetStatus
+          data = 2;
+          break;
+        case 0x15: {
+          // GetRssiInst
+          data = 2;
+          float rssi = this->preambleDetected() ? this->linkRssi() : -120.0f;
+          this->reply(in, len, data, (uint8_t)(-2.0f * rssi));
+        } break;
+        case 0x13:
+          // GetRxBufferStatus
+          data = 2;
+          this->reply(in, len, data, this->rxLen, this->rxStart);
+          break;
+        case 0x14:
+          // GetPacketStatus
+          data = 2;
+          this->reply(in, len, data, this->packetStatus[0], this->packetStatus[1], this->packetStatus[2]);
+          break;
+        case 0x17:
+        case 0x10:
+          // GetDeviceErrors, GetStats - nothing to report
+          data = 2;
+          this->reply(in, len, data);
+          break;
+        default:
+          // calibration, regulator, PA and TCXO settings etc. have no effect here
+          break;
+      }
+
+      // every byte not carrying data returns the status
+      for(size_t i = 0; (i < data) && (i < len); i++) {
+        in[i] = this->status();
+      }
+    }
+
+    void reply(uint8_t* in, size_t len, size_t offset, uint8_t b0 = 0, uint8_t b1 = 0, uint8_t b2 = 0) {
+      const uint8_t bytes[] = { b0, b1, b2 };
+      for(size_t i = offset; i < len; i++) {
+        in[i] = ((i - offset) < sizeof(bytes)) ? bytes[i - offset] : 0;
+      }
+    }
+
+    uint8_t readRegister(uint16_t addr) {
+      // random number generator
+      if((addr >= 0x0819) && (addr <= 0x081C)) {
+        return((uint8_t)this->random());
+      }
+      return(this->regs[addr % sizeof(this->regs)]);
+    }
+
+    void setModulationParams(const uint8_t* p) {
+      static const uint8_t codes[] = { 0x00, 0x08, 0x01, 0x09, 0x02, 0x0A, 0x03, 0x04, 0x05, 0x06 };
+      static const uint32_t bws[] = { 7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000 };
+      this->lora.sf = p[0];
+      for(size_t i = 0; i < sizeof(codes); i++) {
+        if(codes[i] == p[1]) {
+          this->lora.bw = bws[i];
+        }
+      }
+      this->lora.cr = p[2];
+      this->lora.ldro = p[3];
+    }
+
+    void toMode(uint8_t mode) {
+      this->stopRx();
+      this->stopTx();
+      this->timer = RADIOLIB_SIM_NEVER;
+      this->cad = false;
+      this->chipMode = mode;
+    }
+
+    void toFallback() {
+      this->toMode((this->fallback == 0x40) ? MODE_FS : ((this->fallback == 0x30) ? MODE_STDBY_XOSC : MODE_STDBY_RC));
+    }
+
+    void setIrq(uint16_t irq) {
+      this->irqStatus |= irq & this->irqMask;
+    }
+
+    void setTx() {
+      this->toMode(MODE_TX);
+      if(this->packetType != 0x01) {
+        // only LoRa is modelled
+        this->cmdStatus = 0x0A;
+        this->toFallback();
+        return;
+      }
+      uint8_t data[256];
+      for(uint16_t i = 0; i < this->payloadLen; i++) {
+        data[i] = this->buffer[(uint8_t)(this->txBase + i)];
+      }
+      if(!this->startTx(this->getConfig(), data, this->payloadLen)) {
+        this->cmdStatus = 0x0A;
+        this->toFallback();
+      }
+    }
+
+    void setRx(uint32_t timeout) {
+      this->toMode(MODE_RX);
+      if(this->packetType != 0x01) {
+        this->cmdStatus = 0x0A;
+        this->toFallback();
+        return;
+      }
+      this->startRx(this->getConfig());
+      this->continuous = (timeout == 0xFFFFFF);
+      if(!this->continuous && (timeout != 0)) {
+        // timeout is in steps of 15.625 us
+        this->timer = this->air->now() + ((uint64_t)timeout * 125) / 8;
+      }
+    }
+
+    void setCad() {
+      this->toMode(MODE_RX);
+      this->cad = true;
+      this->timer = this->air->now() + (uint64_t)(this->cadSymbols * SimAir::getSymbolTime(this->getConfig()));
+    }
+
+    void onTimer() override {
+      if(this->cad) {
+        bool detected = this->channelActive(this->getConfig());
+        this->setIrq(IRQ_CAD_DONE | (detected ? IRQ_CAD_DETECTED : 0));
+        if(detected && (this->cadExit == 0x01)) {
+          this->setRx(this->cadTimeout);
+        } else {
+          this->toFallback();
+        }
+        return;
+      }
+
+      // a detected preamble stops the Rx timeout
+      this->lockId = this->preambleDetected();
+      if(this->lockId) {
+        return;
+      }
+      this->setIrq(IRQ_TIMEOUT);
+      this->toFallback();
+    }
+
+    void onTxDone() override {
+      this->setIrq(IRQ_TX_DONE);
+      this->toFallback();
+    }
+
+    void onRxDone(const SimTransmission_t& tx, bool ok) override {
+      if(!ok) {
+        if(!this->continuous && this->lockId) {
+          this->setIrq(IRQ_TIMEOUT);
+          this->toFallback();
+        }
+        return;
+      }
+
+      // in implicit header mode, the receiver takes its own payload length
+      size_t len = this->lora.implicitHeader ? this->payloadLen : tx.len;
+      for(size_t i = 0; i < len; i++) {
+        this->buffer[(uint8_t)(this->rxBase + i)] = (i < tx.len) ? tx.data[i] : 0;
+      }
+      this->rxLen = len;
+      this->rxStart = this->rxBase;
+      this->packetStatus[0] = (uint8_t)(-2.0f * this->linkRssi());
+      this->packetStatus[1] = (uint8_t)(int8_t)(this->linkSnr() * 4.0f);
+      this->packetStatus[2] = this->packetStatus[0];
+      this->setIrq(IRQ_PREAMBLE_DETECTED | IRQ_HEADER_VALID | IRQ_RX_DONE);
+      this->lockId = 0;
+      if(!this->continuous) {
+        this->toFallback();
+      }
+    }
+
+    bool irqLevel() override {
+      return(this->irqStatus & this->dio1Mask);
+    }
+
+    bool gpioLevel() override {
+      return(false);
+    }
+};
+
+#endif
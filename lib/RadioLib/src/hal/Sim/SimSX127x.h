@@ -0,0 +1,323 @@
+#ifndef SIM_SX127X_H
+#define SIM_SX127X_H
+
+#include "SimHal.h"
+
+/*!
+  \class SimSX127x
+  \brief Register model of SX1272/73/76/77/78/79 in LoRa mode.
+  Covers what the drivers use for LoRa: operating modes, FIFO and its pointers, IRQ flags with DIO0/DIO1 mapping,
+  Rx single timeout, CAD, packet RSSI/SNR and the wideband RSSI used as entropy source.
+  FSK/OOK mode and frequency hopping are not modelled, registers for them only store what was written.
+*/
+class SimSX127x : public SimRadio {
+  public:
+    /*!
+      \brief Default constructor.
+      \param air Medium this radio transmits to and receives from.
+      \param version Value of the version register: 0x12 for SX1276/77/78/79, 0x22 for SX1272/73.
+    */
+    explicit SimSX127x(SimAir& air, uint8_t version = 0x12) : SimRadio(air), version(version) {
+      this->reset();
+    }
+
+    /*!
+      \brief Direct access to the register file, e.g. to check driver configuration in a test.
+    */
+    uint8_t getRegister(uint8_t addr) const {
+      return(this->regs[addr & 0x7F]);
+    }
+
+    /*!
+      \brief LoRa settings as currently configured in the registers.
+    */
+    SimLoRaConfig_t getConfig() const {
+      SimLoRaConfig_t cfg;
+      uint32_t frf = ((uint32_t)this->regs[0x06] << 16) | ((uint32_t)this->regs[0x07] << 8) | this->regs[0x08];
+      cfg.freq = (uint32_t)(((uint64_t)frf * 32000000ULL) >> 19);
+      uint8_t mc1 = this->regs[0x1D];
+      uint8_t mc2 = this->regs[0x1E];
+      if(this->isSX1272()) {
+        static const uint32_t bws[] = { 125000, 250000, 500000, 500000 };
+        cfg.bw = bws[mc1 >> 6];
+        cfg.cr = (mc1 >> 3) & 0x07;
+        cfg.implicitHeader = mc1 & 0x04;
+        cfg.crc = mc1 & 0x02;
+        cfg.ldro = mc1 & 0x01;
+      } else {
+        static const uint32_t bws[] = { 7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000 };
+        cfg.bw = bws[(mc1 >> 4) > 9 ? 9 : (mc1 >> 4)];
+        cfg.cr = (mc1 >> 1) & 0x07;
+        cfg.implicitHeader = mc1 & 0x01;
+        cfg.crc = mc2 & 0x04;
+        cfg.ldro = this->regs[0x26] & 0x08;
+      }
+      cfg.sf = mc2 >> 4;
+      cfg.preamble = ((uint16_t)this->regs[0x20] << 8) | this->regs[0x21];
+      cfg.syncWord = this->regs[0x39];
+      cfg.invertIq = false;
+      return(cfg);
+    }
+
+#if !RADIOLIB_GODMODE
+  protected:
+#endif
+    const uint8_t version;
+    uint8_t regs[0x80];
+    uint8_t fifo[256];
+
+    bool isSX1272() const {
+      return(this->version == 0x22);
+    }
+
+    uint8_t mode() const {
+      return(this->regs[0x01] & 0x07);
+    }
+
+    void reset() override {
+      memset(this->regs, 0x00, sizeof(this->regs));
+      memset(this->fifo, 0x00, sizeof(this->fifo));
+      this->regs[0x01] = 0x09;
+      this->regs[0x06] = 0x6C;
+      this->regs[0x07] = 0x80;
+      this->regs[0x09] = 0x4F;
+      this->regs[0x0E] = 0x80;
+      this->regs[0x1D] = this->isSX1272() ? 0x08 : 0x72;
+      this->regs[0x1E] = 0x70;
+      this->regs[0x1F] = 0x64;
+      this->regs[0x21] = 0x08;
+      this->regs[0x22] = 0x01;
+      this->regs[0x23] = 0xFF;
+      this->regs[0x26] = 0x04;
+      this->regs[0x33] = 0x27;
+      this->regs[0x39] = 0x12;
+      this->regs[0x42] = this->version;
+      this->stopRx();
+      this->stopTx();
+      this->timer = RADIOLIB_SIM_NEVER;
+    }
+
+    void spiTransfer(const uint8_t* out, uint8_t* in, size_t len) override {
+      if(len == 0) {
+        return;
+      }
+      bool write = out[0] & 0x80;
+      uint8_t addr = out[0] & 0x7F;
+      for(size_t i = 1; i < len; i++) {
+        if(addr == 0x00) {
+          // FIFO access does not increment the address, only the FIFO pointer
+          uint8_t ptr = this->regs[0x0D]++;
+          if(write) {
+            this->fifo[ptr] = out[i];
+          } else {
+            in[i] = this->fifo[ptr];
+          }
+          continue;
+        }
+        if(write) {
+          this->writeRegister(addr, out[i]);
+        } else {
+          in[i] = this->readRegister(addr);
+        }
+        addr = (addr + 1) & 0x7F;
+      }
+    }
+
+    uint8_t readRegister(uint8_t addr) {
+      switch(addr) {
+        case 0x1B: {
+          // current RSSI: noise floor, or the signal while a packet is on the air
+          float rssi = this->preambleDetected() ? this->linkRssi() : -120.0f;
+          return((uint8_t)(rssi + this->rssiOffset()));
+        }
+        case 0x2C:
+          // wideband RSSI is used as a source of randomness
+          return((uint8_t)this->random());
+        default:
+          return(this->regs[addr]);
+      }
+    }
+
+    void writeRegister(uint8_t addr, uint8_t value) {
+      switch(addr) {
+        case 0x01: {
+          // rewriting the current mode does not restart it
+          uint8_t prev = this->regs[0x01];
+          this->regs[0x01] = value;
+          if((prev & 0x87) != (value & 0x87)) {
+            this->setMode(value & 0x07);
+          }
+        } break;
+        case 0x12:
+          // IRQ flags are cleared by writing 1
+          this->regs[0x12] &= ~value;
+          break;
+        case 0x10:
+        case 0x13:
+        case 0x14:
+        case 0x15:
+        case 0x16:
+        case 0x17:
+        case 0x18:
+        case 0x19:
+        case 0x1A:
+        case 0x1B:
+        case 0x1C:
+        case 0x42:
+          // read-only
+          break;
+        default:
+          this->regs[addr] = value;
+          break;
+      }
+    }
+
+    bool lora() const {
+      return(this->regs[0x01] & 0x80);
+    }
+
+    SimLoRaConfig_t txConfig() const {
+      SimLoRaConfig_t cfg = this->getConfig();
+      // the Tx path is inverted when bit 0 is cleared, see RadioLib issue #778
+      cfg.invertIq = !(this->regs[0x33] & 0x01);
+      return(cfg);
+    }
+
+    SimLoRaConfig_t rxLoRaConfig() const {
+      SimLoRaConfig_t cfg = this->getConfig();
+      cfg.invertIq = this->regs[0x33] & 0x40;
+      return(cfg);
+    }
+
+    float symbolTime() const {
+      return(SimAir::getSymbolTime(this->getConfig()));
+    }
+
+    float rssiOffset() const {
+      if(this->isSX1272()) {
+        return(139.0f);
+      }
+      // high frequency port
+      return((this->getConfig().freq >= 779000000UL) ? 157.0f : 164.0f);
+    }
+
+    void setMode(uint8_t mode) {
+      this->stopRx();
+      this->stopTx();
+      this->timer = RADIOLIB_SIM_NEVER;
+      if(!this->lora()) {
+        return;
+      }
+
+      switch(mode) {
+        case 0x03: {
+          // Tx: send the payload from the Tx base address
+          uint8_t data[256];
+          uint8_t len = this->regs[0x22];
+          for(uint8_t i = 0; i < len; i++) {
+            data[i] = this->fifo[(uint8_t)(this->regs[0x0E] + i)];
+          }
+          if(!this->startTx(this->txConfig(), data, len)) {
+            this->toStandby();
+          }
+        } break;
+        case 0x05:
+          this->startRx(this->rxLoRaConfig());
+          break;
+        case 0x06: {
+          this->startRx(this->rxLoRaConfig());
+          uint16_t symbols = ((uint16_t)(this->regs[0x1E] & 0x03) << 8) | this->regs[0x1F];
+          this->timer = this->air->now() + (uint64_t)(symbols * this->symbolTime());
+        } break;
+        case 0x07:
+          // CAD takes about two symbols
+          this->timer = this->air->now() + (uint64_t)(2 * this->symbolTime());
+          break;
+        default:
+          break;
+      }
+    }
+
+    void toStandby() {
+      this->stopRx();
+      this->regs[0x01] = (this->regs[0x01] & ~0x07) | 0x01;
+    }
+
+    void setFlags(uint8_t flags) {
+      this->regs[0x12] |= flags & ~this->regs[0x11];
+    }
+
+    void onTimer() override {
+      if(this->mode() == 0x06) {
+        // a detected preamble stops the Rx timeout
+        this->lockId = this->preambleDetected();
+        if(this->lockId) {
+          return;
+        }
+        this->setFlags(0x80);
+        this->toStandby();
+
+      } else if(this->mode() == 0x07) {
+        uint8_t flags = 0x04;
+        if(this->channelActive(this->rxLoRaConfig())) {
+          flags |= 0x01;
+        }
+        this->setFlags(flags);
+        this->toStandby();
+      }
+    }
+
+    void onTxDone() override {
+      this->setFlags(0x08);
+      this->toStandby();
+    }
+
+    void onRxDone(const SimTransmission_t& tx, bool ok) override {
+      bool single = (this->mode() == 0x06);
+      if(!ok) {
+        if(single && this->lockId) {
+          this->setFlags(0x80);
+          this->toStandby();
+        }
+        return;
+      }
+
+      // in implicit header mode, the receiver takes its own payload length
+      size_t len = tx.len;
+      if(this->rxConfig.implicitHeader) {
+        len = this->regs[0x22];
+      }
+      uint8_t base = this->regs[0x0F];
+      for(size_t i = 0; i < len; i++) {
+        this->fifo[(uint8_t)(base + i)] = (i < tx.len) ? tx.data[i] : 0;
+      }
+      this->regs[0x10] = base;
+      this->regs[0x13] = len;
+      this->regs[0x19] = (uint8_t)(int8_t)(this->linkSnr() * 4.0f);
+      this->regs[0x1A] = (uint8_t)(this->linkRssi() + this->rssiOffset());
+      this->regs[0x1C] = tx.cfg.crc ? 0x40 : 0x00;
+      this->setFlags(0x50);
+      if(single) {
+        this->toStandby();
+      }
+      this->lockId = 0;
+    }
+
+    bool dio(uint8_t num) const {
+      uint8_t mapping = (this->regs[0x40] >> (6 - 2*num)) & 0x03;
+      static const uint8_t dio0[] = { 0x40, 0x08, 0x04, 0x00 };
+      static const uint8_t dio1[] = { 0x80, 0x02, 0x01, 0x00 };
+      uint8_t mask = (num == 0) ? dio0[mapping] : dio1[mapping];
+      return(this->regs[0x12] & mask);
+    }
+
+    bool irqLevel() override {
+      return(this->dio(0));
+    }
+
+    bool gpioLevel() override {
+      return(this->dio(1));
+    }
+};
+
+#endif
@@ -367,9 +367,11 @@ int16_t CC1101::setFrequency(float freq) {
   //set carrier frequency
   uint32_t base = 1;
   uint32_t FRF = (freq * (base << 16)) / 26.0;
+  this->mod->SPIbeginBatch();
   int16_t state = SPIsetRegValue(RADIOLIB_CC1101_REG_FREQ2, (FRF & 0xFF0000) >> 16, 7, 0);
   state |= SPIsetRegValue(RADIOLIB_CC1101_REG_FREQ1, (FRF & 0x00FF00) >> 8, 7, 0);
   state |= SPIsetRegValue(RADIOLIB_CC1101_REG_FREQ0, FRF & 0x0000FF, 7, 0);
+  state |= this->mod->SPIcommitBatch();
 
   if(state == RADIOLIB_ERR_NONE) {
     this->frequency = freq;
@@ -391,8 +393,10 @@ int16_t CC1101::setBitRate(float br) {
   getExpMant(br * 1000.0, 256, 28, 14, e, m);
 
   // set bit rate value
+  this->mod->SPIbeginBatch();
   int16_t state = SPIsetRegValue(RADIOLIB_CC1101_REG_MDMCFG4, e, 3, 0);
   state |= SPIsetRegValue(RADIOLIB_CC1101_REG_MDMCFG3, m);
+  state |= this->mod->SPIcommitBatch();
   if(state == RADIOLIB_ERR_NONE) {
     this->bitRate = br;
   }
@@ -468,8 +472,10 @@ int16_t CC1101::setFrequencyDeviation(float freqDev) {
   getExpMant(newFreqDev * 1000.0, 8, 17, 7, e, m);
 
   // set frequency deviation value
+  this->mod->SPIbeginBatch();
   int16_t state = SPIsetRegValue(RADIOLIB_CC1101_REG_DEVIATN, (e << 4), 6, 4);
   state |= SPIsetRegValue(RADIOLIB_CC1101_REG_DEVIATN, m, 2, 0);
+  state |= this->mod->SPIcommitBatch();
   
   return(state);
 }
@@ -935,6 +941,7 @@ int16_t CC1101::beginCommon(float freq, float br, float freqDev, float rxBw, int
   // set module properties
   this->mod->spiConfig.cmds[RADIOLIB_MODULE_SPI_COMMAND_READ] = RADIOLIB_CC1101_CMD_READ;
   this->mod->spiConfig.cmds[RADIOLIB_MODULE_SPI_COMMAND_WRITE] = RADIOLIB_CC1101_CMD_WRITE;
+  this->mod->spiConfig.cmds[RADIOLIB_MODULE_SPI_COMMAND_BURST] = RADIOLIB_CC1101_CMD_BURST;
   this->mod->init();
   this->mod->hal->pinMode(this->mod->getIrq(), this->mod->hal->GpioModeInput);
 
@@ -1021,19 +1028,21 @@ int16_t CC1101::config() {
 
   standby();
 
+  // the whole configuration is written and verified in one go
+  this->mod->SPIbeginBatch();
+
   // enable automatic frequency synthesizer calibration and disable pin control
   int16_t state = SPIsetRegValue(RADIOLIB_CC1101_REG_MCSM0, RADIOLIB_CC1101_FS_AUTOCAL_IDLE_TO_RXTX, 5, 4);
   state |= SPIsetRegValue(RADIOLIB_CC1101_REG_MCSM0, RADIOLIB_CC1101_PIN_CTRL_OFF, 1, 1);
-  RADIOLIB_ASSERT(state);
 
   // set GDOs to Hi-Z so that it doesn't output clock on startup (might confuse GDO0 action)
-  state = SPIsetRegValue(RADIOLIB_CC1101_REG_IOCFG0, RADIOLIB_CC1101_GDOX_HIGH_Z, 5, 0);
+  state |= SPIsetRegValue(RADIOLIB_CC1101_REG_IOCFG0, RADIOLIB_CC1101_GDOX_HIGH_Z, 5, 0);
   state |= SPIsetRegValue(RADIOLIB_CC1101_REG_IOCFG2, RADIOLIB_CC1101_GDOX_HIGH_Z, 5, 0);
-  RADIOLIB_ASSERT(state);
 
   // set packet mode
-  state = packetMode();
+  state |= packetMode();
 
+  state |= this->mod->SPIcommitBatch();
   return(state);
 }
 
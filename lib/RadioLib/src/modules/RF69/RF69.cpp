@@ -102,6 +102,19 @@ int16_t RF69::transmit(const uint8_t* data, size_t len, uint8_t addr) {
   // calculate timeout (5ms + 500 % of expected time-on-air)
   RadioLibTime_t timeout = 5 + (RadioLibTime_t)((((float)(len * 8)) / this->bitRate) * 5);
 
+  if(len > RADIOLIB_RF69_MAX_PACKET_LENGTH) {
+    // the rest of a long packet is streamed into the FIFO while the start is on the air
+    int16_t state = startTransmitCommon(data, len, addr, false);
+    RADIOLIB_ASSERT(state);
+
+    state = getPacketFifo().transmit(data, len, RADIOLIB_RF69_FIFO_THRESH - 1, timeout);
+    if(state != RADIOLIB_ERR_NONE) {
+      finishTransmit();
+      return(state);
+    }
+    return(finishTransmit());
+  }
+
   // start transmission
   int16_t state = startTransmit(data, len, addr);
   RADIOLIB_ASSERT(state);
@@ -124,10 +137,36 @@ int16_t RF69::receive(uint8_t* data, size_t len) {
   // calculate timeout (500 ms + 400 full 64-byte packets at current bit rate)
   RadioLibTime_t timeout = 500 + (1.0/(this->bitRate))*(RADIOLIB_RF69_MAX_PACKET_LENGTH*400.0);
 
+  // a long packet is read while it arrives, so a failed CRC must not clear the FIFO under it
+  bool stream = (len > RADIOLIB_RF69_MAX_PACKET_LENGTH);
+  int16_t state = RADIOLIB_ERR_NONE;
+  if(stream) {
+    state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_PACKET_CONFIG_1, RADIOLIB_RF69_CRC_AUTOCLEAR_OFF, 3, 3);
+    RADIOLIB_ASSERT(state);
+  }
+
   // start reception
-  int16_t state = startReceive();
+  state = startReceive();
   RADIOLIB_ASSERT(state);
 
+  if(stream) {
+    // a long packet has to be read from the FIFO while it is still being received
+    uint8_t filter = this->mod->SPIgetRegValue(RADIOLIB_RF69_REG_PACKET_CONFIG_1, 2, 1);
+    size_t skip = ((filter == RADIOLIB_RF69_ADDRESS_FILTERING_NODE) || (filter == RADIOLIB_RF69_ADDRESS_FILTERING_NODE_BROADCAST)) ? 1 : 0;
+    size_t pktLen = (this->packetLengthConfig == RADIOLIB_RF69_PACKET_FORMAT_VARIABLE) ? 0 : this->mod->SPIreadRegister(RADIOLIB_RF69_REG_PAYLOAD_LENGTH);
+    bool crc = (this->mod->SPIgetRegValue(RADIOLIB_RF69_REG_PACKET_CONFIG_1, 4, 4) == RADIOLIB_RF69_CRC_ON);
+    size_t rcvLen = 0;
+    state = getPacketFifo().receive(data, len, pktLen, skip, crc, &rcvLen, timeout);
+
+    // the packet is gone from the FIFO, so getPacketLength must return the cached length
+    this->packetLength = rcvLen;
+    this->packetLengthQueried = true;
+    standby();
+    clearIRQFlags();
+    this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_PACKET_CONFIG_1, RADIOLIB_RF69_CRC_AUTOCLEAR_ON, 3, 3);
+    return(state);
+  }
+
   // wait for packet reception or timeout
   RadioLibTime_t start = this->mod->hal->millis();
   while(!this->mod->hal->digitalRead(this->mod->getIrq())) {
@@ -245,6 +284,9 @@ int16_t RF69::startReceive() {
   // clear interrupt flags
   clearIRQFlags();
 
+  // length of the next packet is not known yet
+  this->packetLengthQueried = false;
+
   // set RF switch (if present)
   this->mod->setRfSwitchState(Module::MODE_RX);
 
@@ -385,6 +427,15 @@ bool RF69::fifoGet(volatile uint8_t* data, int totalLen, volatile int* rcvLen) {
 }
 
 int16_t RF69::startTransmit(const uint8_t* data, size_t len, uint8_t addr) {
+  return(startTransmitCommon(data, len, addr, true));
+}
+
+int16_t RF69::startTransmitCommon(const uint8_t* data, size_t len, uint8_t addr, bool padding) {
+  // check packet length
+  if(len > RADIOLIB_RF69_MAX_PACKET_LENGTH_LONG) {
+    return(RADIOLIB_ERR_PACKET_TOO_LONG);
+  }
+
   // set mode to standby
   int16_t state = setMode(RADIOLIB_RF69_STANDBY);
   RADIOLIB_ASSERT(state);
@@ -421,7 +472,8 @@ int16_t RF69::startTransmit(const uint8_t* data, size_t len, uint8_t addr) {
 
   // this is a hack, but it seems than in Stream mode, Rx FIFO level is getting triggered 1 byte before it should
   // just add a padding byte that can be dropped without consequence
-  if(len > RADIOLIB_RF69_MAX_PACKET_LENGTH) {
+  // not needed when the packet is streamed by transmit(), which sends exactly the packet length
+  if(padding && (len > RADIOLIB_RF69_MAX_PACKET_LENGTH)) {
     this->mod->SPIwriteRegister(RADIOLIB_RF69_REG_FIFO, '/');
   }
 
@@ -534,10 +586,10 @@ int16_t RF69::setFrequency(float freq) {
 
   //set carrier frequency
   //FRF(23:0) = freq / Fstep = freq * (1 / Fstep) = freq * (2^19 / 32.0) (pag. 17 of datasheet) 
+  //the new frequency is applied once the lsb is written, so send all three in one burst
   uint32_t FRF = (freq * (uint32_t(1) << RADIOLIB_RF69_DIV_EXPONENT)) / RADIOLIB_RF69_CRYSTAL_FREQ;
-  this->mod->SPIwriteRegister(RADIOLIB_RF69_REG_FRF_MSB, (FRF & 0xFF0000) >> 16);
-  this->mod->SPIwriteRegister(RADIOLIB_RF69_REG_FRF_MID, (FRF & 0x00FF00) >> 8);
-  this->mod->SPIwriteRegister(RADIOLIB_RF69_REG_FRF_LSB, FRF & 0x0000FF);
+  uint8_t frf[] = { (uint8_t)((FRF & 0xFF0000) >> 16), (uint8_t)((FRF & 0x00FF00) >> 8), (uint8_t)(FRF & 0x0000FF) };
+  this->mod->SPIwriteRegisterBurst(RADIOLIB_RF69_REG_FRF_MSB, frf, sizeof(frf));
 
   return(RADIOLIB_ERR_NONE);
 }
@@ -571,8 +623,10 @@ int16_t RF69::setBitRate(float br) {
 
   // set bit rate
   uint16_t bitRateRaw = 32000 / br;
+  this->mod->SPIbeginBatch();
   int16_t state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_BITRATE_MSB, (bitRateRaw & 0xFF00) >> 8, 7, 0);
   state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_BITRATE_LSB, bitRateRaw & 0x00FF, 7, 0);
+  state |= this->mod->SPIcommitBatch();
   if(state == RADIOLIB_ERR_NONE) {
     this->bitRate = br;
   }
@@ -624,8 +678,10 @@ int16_t RF69::setFrequencyDeviation(float freqDev) {
 
   // set frequency deviation from carrier frequency
   uint32_t fdev = (newFreqDev * (uint32_t(1) << RADIOLIB_RF69_DIV_EXPONENT)) / 32000;
+  this->mod->SPIbeginBatch();
   int16_t state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_FDEV_MSB, (fdev & 0xFF00) >> 8, 5, 0);
   state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_FDEV_LSB, fdev & 0x00FF, 7, 0);
+  state |= this->mod->SPIcommitBatch();
 
   return(state);
 }
@@ -1001,56 +1057,50 @@ int16_t RF69::config() {
   state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_OP_MODE, RADIOLIB_RF69_SEQUENCER_ON | RADIOLIB_RF69_LISTEN_OFF, 7, 6);
   RADIOLIB_ASSERT(state);
 
+  // reset FIFO flag
+  this->mod->SPIwriteRegister(RADIOLIB_RF69_REG_IRQ_FLAGS_2, RADIOLIB_RF69_IRQ_FIFO_OVERRUN);
+
+  // everything else is written and verified in one go
+  this->mod->SPIbeginBatch();
+
   // enable over-current protection
   state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_OCP, RADIOLIB_RF69_OCP_ON, 4, 4);
-  RADIOLIB_ASSERT(state);
 
   // set data mode, modulation type and shaping
-  state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_DATA_MODUL, RADIOLIB_RF69_PACKET_MODE | RADIOLIB_RF69_FSK, 6, 3);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_DATA_MODUL, RADIOLIB_RF69_PACKET_MODE | RADIOLIB_RF69_FSK, 6, 3);
   state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_DATA_MODUL, RADIOLIB_RF69_FSK_GAUSSIAN_0_3, 1, 0);
-  RADIOLIB_ASSERT(state);
 
   // set RSSI threshold
-  state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_RSSI_THRESH, RADIOLIB_RF69_RSSI_THRESHOLD, 7, 0);
-  RADIOLIB_ASSERT(state);
-
-  // reset FIFO flag
-  this->mod->SPIwriteRegister(RADIOLIB_RF69_REG_IRQ_FLAGS_2, RADIOLIB_RF69_IRQ_FIFO_OVERRUN);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_RSSI_THRESH, RADIOLIB_RF69_RSSI_THRESHOLD, 7, 0);
 
   // disable ClkOut on DIO5
-  state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_DIO_MAPPING_2, RADIOLIB_RF69_CLK_OUT_OFF, 2, 0);
-  RADIOLIB_ASSERT(state);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_DIO_MAPPING_2, RADIOLIB_RF69_CLK_OUT_OFF, 2, 0);
 
   // set packet configuration and disable encryption
-  state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_PACKET_CONFIG_1, RADIOLIB_RF69_PACKET_FORMAT_VARIABLE | RADIOLIB_RF69_DC_FREE_NONE | RADIOLIB_RF69_CRC_ON | RADIOLIB_RF69_CRC_AUTOCLEAR_ON | RADIOLIB_RF69_ADDRESS_FILTERING_OFF, 7, 1);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_PACKET_CONFIG_1, RADIOLIB_RF69_PACKET_FORMAT_VARIABLE | RADIOLIB_RF69_DC_FREE_NONE | RADIOLIB_RF69_CRC_ON | RADIOLIB_RF69_CRC_AUTOCLEAR_ON | RADIOLIB_RF69_ADDRESS_FILTERING_OFF, 7, 1);
   state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_PACKET_CONFIG_2, RADIOLIB_RF69_INTER_PACKET_RX_DELAY, 7, 4);
   state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_PACKET_CONFIG_2, RADIOLIB_RF69_AUTO_RX_RESTART_ON | RADIOLIB_RF69_AES_OFF, 1, 0);
-  RADIOLIB_ASSERT(state);
 
   // set payload length
-  state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_PAYLOAD_LENGTH, RADIOLIB_RF69_PAYLOAD_LENGTH, 7, 0);
-  RADIOLIB_ASSERT(state);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_PAYLOAD_LENGTH, RADIOLIB_RF69_PAYLOAD_LENGTH, 7, 0);
 
   // set FIFO threshold
-  state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_FIFO_THRESH, RADIOLIB_RF69_TX_START_CONDITION_FIFO_NOT_EMPTY | RADIOLIB_RF69_FIFO_THRESH, 7, 0);
-  RADIOLIB_ASSERT(state);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_FIFO_THRESH, RADIOLIB_RF69_TX_START_CONDITION_FIFO_NOT_EMPTY | RADIOLIB_RF69_FIFO_THRESH, 7, 0);
 
   // set Rx timeouts
-  state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_RX_TIMEOUT_1, RADIOLIB_RF69_TIMEOUT_RX_START, 7, 0);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_RX_TIMEOUT_1, RADIOLIB_RF69_TIMEOUT_RX_START, 7, 0);
   state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_RX_TIMEOUT_2, RADIOLIB_RF69_TIMEOUT_RSSI_THRESH, 7, 0);
-  RADIOLIB_ASSERT(state);
 
   // enable improved fading margin
-  state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_TEST_DAGC, RADIOLIB_RF69_CONTINUOUS_DAGC_LOW_BETA_OFF, 7, 0);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_TEST_DAGC, RADIOLIB_RF69_CONTINUOUS_DAGC_LOW_BETA_OFF, 7, 0);
 
+  state |= this->mod->SPIcommitBatch();
   return(state);
 }
 
 int16_t RF69::setPacketMode(uint8_t mode, uint8_t len) {
-  // check length
-  if (len > RADIOLIB_RF69_MAX_PACKET_LENGTH) {
-    return(RADIOLIB_ERR_PACKET_TOO_LONG);
-  }
+  // any length up to RADIOLIB_RF69_MAX_PACKET_LENGTH_LONG fits the register,
+  // packets longer than the FIFO are streamed by the blocking methods
 
   // set to fixed packet length
   int16_t state = this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_PACKET_CONFIG_1, mode, 7, 7);
@@ -1065,6 +1115,12 @@ int16_t RF69::setPacketMode(uint8_t mode, uint8_t len) {
   return(state);
 }
 
+RadioLibPacketFifo RF69::getPacketFifo() {
+  uint8_t threshold = this->mod->SPIgetRegValue(RADIOLIB_RF69_REG_FIFO_THRESH, 6, 0);
+  return(RadioLibPacketFifo(this->mod, RADIOLIB_RF69_REG_FIFO, RADIOLIB_RF69_REG_IRQ_FLAGS_2, RADIOLIB_RF69_IRQ_FIFO_LEVEL,
+    RADIOLIB_RF69_IRQ_PACKET_SENT, RADIOLIB_RF69_IRQ_PAYLOAD_READY, RADIOLIB_RF69_IRQ_CRC_OK, RADIOLIB_RF69_MAX_PACKET_LENGTH, threshold));
+}
+
 int16_t RF69::setMode(uint8_t mode) {
   return(this->mod->SPIsetRegValue(RADIOLIB_RF69_REG_OP_MODE, mode, 4, 2));
 }
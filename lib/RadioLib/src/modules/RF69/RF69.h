@@ -8,10 +8,12 @@
 #include "../../Module.h"
 
 #include "../../protocols/PhysicalLayer/PhysicalLayer.h"
+#include "../../utils/PacketFifo.h"
 
 // RF69 physical layer properties
 #define RADIOLIB_RF69_FREQUENCY_STEP_SIZE                       61.03515625
 #define RADIOLIB_RF69_MAX_PACKET_LENGTH                         64
+#define RADIOLIB_RF69_MAX_PACKET_LENGTH_LONG                    255
 #define RADIOLIB_RF69_CRYSTAL_FREQ                              32.0
 #define RADIOLIB_RF69_DIV_EXPONENT                              19
 
@@ -517,6 +519,7 @@ class RF69: public PhysicalLayer {
 
     /*!
       \brief Blocking binary transmit method.
+      Packets longer than the 64-byte FIFO (up to 255 bytes) are streamed through it while on the air.
       Overloads for string-based transmissions are implemented in PhysicalLayer.
       \param data Binary data to be sent.
       \param len Number of bytes to send.
@@ -527,6 +530,8 @@ class RF69: public PhysicalLayer {
 
     /*!
       \brief Blocking binary receive method.
+      With a buffer longer than the 64-byte FIFO, the packet is read from the FIFO while it is received,
+      the maximum length must be configured by variablePacketLengthMode or fixedPacketLengthMode.
       Overloads for string-based transmissions are implemented in PhysicalLayer.
       \param data Binary data to be sent.
       \param len Number of bytes to send.
@@ -873,14 +878,14 @@ class RF69: public PhysicalLayer {
 
     /*!
       \brief Set modem in fixed packet length mode.
-      \param len Packet length.
+      \param len Packet length, up to 255 bytes. Packets longer than the FIFO need blocking transmit/receive, or fifoAdd/fifoGet.
       \returns \ref status_codes
     */
     int16_t fixedPacketLengthMode(uint8_t len = RADIOLIB_RF69_MAX_PACKET_LENGTH);
 
      /*!
       \brief Set modem in variable packet length mode.
-      \param maxLen Maximum packet length.
+      \param maxLen Maximum packet length, up to 255 bytes. Packets longer than the FIFO need blocking transmit/receive, or fifoAdd/fifoGet.
       \returns \ref status_codes
     */
     int16_t variablePacketLengthMode(uint8_t maxLen = RADIOLIB_RF69_MAX_PACKET_LENGTH);
@@ -1037,6 +1042,8 @@ class RF69: public PhysicalLayer {
 
     int16_t directMode();
     int16_t setPacketMode(uint8_t mode, uint8_t len);
+    int16_t startTransmitCommon(const uint8_t* data, size_t len, uint8_t addr, bool padding);
+    RadioLibPacketFifo getPacketFifo();
     void clearIRQFlags();
     void clearFIFO(size_t count);
 };
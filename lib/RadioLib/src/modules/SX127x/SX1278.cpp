@@ -560,6 +560,7 @@ int16_t SX1278::setSpreadingFactorRaw(uint8_t newSpreadingFactor) {
 
   // write registers
   Module* mod = this->getMod();
+  mod->SPIbeginBatch();
   if(newSpreadingFactor == RADIOLIB_SX127X_SF_6) {
     this->implicitHdr = true;
     state |= mod->SPIsetRegValue(RADIOLIB_SX127X_REG_MODEM_CONFIG_1, RADIOLIB_SX1278_HEADER_IMPL_MODE, 0, 0);
@@ -573,6 +574,7 @@ int16_t SX1278::setSpreadingFactorRaw(uint8_t newSpreadingFactor) {
     state |= mod->SPIsetRegValue(RADIOLIB_SX127X_REG_DETECT_OPTIMIZE, RADIOLIB_SX127X_DETECT_OPTIMIZE_SF_7_12, 2, 0);
     state |= mod->SPIsetRegValue(RADIOLIB_SX127X_REG_DETECTION_THRESHOLD, RADIOLIB_SX127X_DETECTION_THRESHOLD_SF_7_12);
   }
+  state |= mod->SPIcommitBatch();
   return(state);
 }
 
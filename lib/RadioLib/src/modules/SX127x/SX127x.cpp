@@ -192,13 +192,23 @@ int16_t SX127x::transmit(const uint8_t* data, size_t len, uint8_t addr) {
   state = startTransmit(data, len, addr);
   RADIOLIB_ASSERT(state);
 
-  // wait for packet transmission or timeout
   start = this->mod->hal->millis();
-  while(!this->mod->hal->digitalRead(this->mod->getIrq())) {
-    this->mod->hal->yield();
-    if(this->mod->hal->millis() - start > timeout) {
+  if((modem == RADIOLIB_SX127X_FSK_OOK) && (len > RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK)) {
+    // the rest of a long packet is streamed into the FIFO while the start is on the air
+    state = getPacketFifo().transmit(data, len, RADIOLIB_SX127X_FIFO_THRESH - 1, timeout);
+    if(state != RADIOLIB_ERR_NONE) {
       finishTransmit();
-      return(RADIOLIB_ERR_TX_TIMEOUT);
+      return(state);
+    }
+
+  } else {
+    // wait for packet transmission or timeout
+    while(!this->mod->hal->digitalRead(this->mod->getIrq())) {
+      this->mod->hal->yield();
+      if(this->mod->hal->millis() - start > timeout) {
+        finishTransmit();
+        return(RADIOLIB_ERR_TX_TIMEOUT);
+      }
     }
   }
 
@@ -252,10 +262,34 @@ int16_t SX127x::receive(uint8_t* data, size_t len) {
     // calculate timeout in ms (500 % of expected time-on-air)
     RadioLibTime_t timeout = (getTimeOnAir(len) * 5) / 1000;
 
+    // a long packet is read while it arrives, so a failed CRC must not clear the FIFO under it
+    bool stream = (len > RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK);
+    if(stream) {
+      state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_1, RADIOLIB_SX127X_CRC_AUTOCLEAR_OFF, 3, 3);
+      RADIOLIB_ASSERT(state);
+    }
+
     // set mode to receive
     state = startReceive(0, RADIOLIB_IRQ_RX_DEFAULT_FLAGS, RADIOLIB_IRQ_RX_DEFAULT_MASK, len);
     RADIOLIB_ASSERT(state);
 
+    if(stream) {
+      // a long packet has to be read from the FIFO while it is still being received
+      uint8_t filter = this->mod->SPIgetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_1, 2, 1);
+      size_t skip = ((filter == RADIOLIB_SX127X_ADDRESS_FILTERING_NODE) || (filter == RADIOLIB_SX127X_ADDRESS_FILTERING_NODE_BROADCAST)) ? 1 : 0;
+      size_t pktLen = (this->packetLengthConfig == RADIOLIB_SX127X_PACKET_VARIABLE) ? 0 : getPacketLength();
+      bool crc = (this->mod->SPIgetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_1, 4, 4) == RADIOLIB_SX127X_CRC_ON);
+      size_t rcvLen = 0;
+      state = getPacketFifo().receive(data, len, pktLen, skip, crc, &rcvLen, timeout);
+
+      // the packet is gone from the FIFO, so getPacketLength must return the cached length
+      this->packetLength = rcvLen;
+      this->packetLengthQueried = true;
+      clearIrqFlags(RADIOLIB_SX127X_FLAGS_ALL);
+      this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_1, RADIOLIB_SX127X_CRC_AUTOCLEAR_ON, 3, 3);
+      return(state);
+    }
+
     // wait for packet reception or timeout
     RadioLibTime_t start = this->mod->hal->millis();
     while(!this->mod->hal->digitalRead(this->mod->getIrq())) {
@@ -439,6 +473,9 @@ int16_t SX127x::startReceive(uint32_t timeout, RadioLibIrqFlags_t irqFlags, Radi
     // clear interrupt flags
     clearIrqFlags(RADIOLIB_SX127X_FLAGS_ALL);
 
+    // length of the next packet is not known yet
+    this->packetLengthQueried = false;
+
     // FSK modem does not distinguish between Rx single and continuous
     mode = RADIOLIB_SX127X_RX;
   }
@@ -612,8 +649,17 @@ int16_t SX127x::startTransmit(const uint8_t* data, size_t len, uint8_t addr) {
 
     // set packet length - increased by 1 when address filter is enabled
     uint8_t filter = this->mod->SPIgetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_1, 2, 1);
+    bool addrFilter = (filter == RADIOLIB_SX127X_ADDRESS_FILTERING_NODE) || (filter == RADIOLIB_SX127X_ADDRESS_FILTERING_NODE_BROADCAST);
+    size_t maxLen = RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK_FIXED;
     if(this->packetLengthConfig == RADIOLIB_SX127X_PACKET_VARIABLE) {
-      if((filter == RADIOLIB_SX127X_ADDRESS_FILTERING_NODE) || (filter == RADIOLIB_SX127X_ADDRESS_FILTERING_NODE_BROADCAST)) {
+      maxLen = RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK_VARIABLE - (addrFilter ? 1 : 0);
+    }
+    if(len > maxLen) {
+      return(RADIOLIB_ERR_PACKET_TOO_LONG);
+    }
+
+    if(this->packetLengthConfig == RADIOLIB_SX127X_PACKET_VARIABLE) {
+      if(addrFilter) {
         this->mod->SPIwriteRegister(RADIOLIB_SX127X_REG_FIFO, len + 1);
         this->mod->SPIwriteRegister(RADIOLIB_SX127X_REG_FIFO, addr);
       } else {
@@ -932,6 +978,7 @@ int16_t SX127x::setBitRateCommon(float br, uint8_t fracRegAddr) {
 
   // set bit rate
   uint16_t bitRateRaw = (RADIOLIB_SX127X_CRYSTAL_FREQ * 1000.0) / br;
+  this->mod->SPIbeginBatch();
   state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_BITRATE_MSB, (bitRateRaw & 0xFF00) >> 8, 7, 0);
   state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_BITRATE_LSB, bitRateRaw & 0x00FF, 7, 0);
 
@@ -941,6 +988,7 @@ int16_t SX127x::setBitRateCommon(float br, uint8_t fracRegAddr) {
     uint8_t bitRateFrac = bitRateRem * 16;
     state |= this->mod->SPIsetRegValue(fracRegAddr, bitRateFrac, 7, 0);
   }
+  state |= this->mod->SPIcommitBatch();
 
   if(state == RADIOLIB_ERR_NONE) {
     this->bitRate = br;
@@ -972,8 +1020,10 @@ int16_t SX127x::setFrequencyDeviation(float freqDev) {
   // set allowed frequency deviation
   uint32_t base = 1;
   uint32_t FDEV = (newFreqDev * (base << 19)) / 32000;
+  this->mod->SPIbeginBatch();
   state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_FDEV_MSB, (FDEV & 0xFF00) >> 8, 5, 0);
   state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_FDEV_LSB, FDEV & 0x00FF, 7, 0);
+  state |= this->mod->SPIcommitBatch();
   return(state);
 }
 
@@ -1201,11 +1251,13 @@ int16_t SX127x::setFrequencyRaw(float newFreq) {
   // calculate register values
   uint32_t FRF = (newFreq * (uint32_t(1) << RADIOLIB_SX127X_DIV_EXPONENT)) / RADIOLIB_SX127X_CRYSTAL_FREQ;
 
-  // write registers
+  // write registers in a single burst
   // lsb needs to be written no matter what in order for the module to update the frequency
+  this->mod->SPIbeginBatch();
   state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_FRF_MSB, (FRF & 0xFF0000) >> 16);
   state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_FRF_MID, (FRF & 0x00FF00) >> 8);
   state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_FRF_LSB, FRF & 0x0000FF, 7U, 0U, 2U, 0xFF, true);
+  state |= this->mod->SPIcommitBatch();
   return(state);
 }
 
@@ -1229,6 +1281,7 @@ size_t SX127x::getPacketLength(bool update) {
         this->packetLength = this->mod->SPIreadRegister(RADIOLIB_SX127X_REG_FIFO);
       } else {
         this->packetLength = this->mod->SPIreadRegister(RADIOLIB_SX127X_REG_PAYLOAD_LENGTH_FSK);
+        this->packetLength |= (size_t)(this->mod->SPIreadRegister(RADIOLIB_SX127X_REG_PACKET_CONFIG_2) & RADIOLIB_SX127X_PAYLOAD_LENGTH_FSK_MSB) << 8;
       }
       this->packetLengthQueried = true;
     }
@@ -1237,7 +1290,7 @@ size_t SX127x::getPacketLength(bool update) {
   return(this->packetLength);
 }
 
-int16_t SX127x::fixedPacketLengthMode(uint8_t len) {
+int16_t SX127x::fixedPacketLengthMode(uint16_t len) {
   return(SX127x::setPacketMode(RADIOLIB_SX127X_PACKET_FIXED, len));
 }
 
@@ -1295,6 +1348,7 @@ RadioLibTime_t SX127x::getTimeOnAir(size_t len) {
     if (this->packetLengthConfig == RADIOLIB_SX127X_PACKET_FIXED) {
       // if packet size fixed -> len = fixed packet length
       len = this->mod->SPIgetRegValue(RADIOLIB_SX127X_REG_PAYLOAD_LENGTH_FSK);
+      len |= (size_t)this->mod->SPIgetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_2, 2, 0) << 8;
     } else {
       // if packet variable -> Add 1 extra byte for payload length
       len += 1;
@@ -1626,38 +1680,39 @@ int16_t SX127x::config() {
 }
 
 int16_t SX127x::configFSK() {
-  // set RSSI threshold
-  int16_t state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_RSSI_THRESH, RADIOLIB_SX127X_RSSI_THRESHOLD);
-  RADIOLIB_ASSERT(state);
-
   // reset FIFO flag
   this->mod->SPIwriteRegister(RADIOLIB_SX127X_REG_IRQ_FLAGS_2, RADIOLIB_SX127X_FLAG_FIFO_OVERRUN);
 
+  // everything else is written and verified in one go
+  this->mod->SPIbeginBatch();
+
+  // set RSSI threshold
+  int16_t state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_RSSI_THRESH, RADIOLIB_SX127X_RSSI_THRESHOLD);
+
   // set packet configuration
-  state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_1, RADIOLIB_SX127X_PACKET_VARIABLE | RADIOLIB_SX127X_DC_FREE_NONE | RADIOLIB_SX127X_CRC_ON | RADIOLIB_SX127X_CRC_AUTOCLEAR_ON | RADIOLIB_SX127X_ADDRESS_FILTERING_OFF | RADIOLIB_SX127X_CRC_WHITENING_TYPE_CCITT, 7, 0);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_1, RADIOLIB_SX127X_PACKET_VARIABLE | RADIOLIB_SX127X_DC_FREE_NONE | RADIOLIB_SX127X_CRC_ON | RADIOLIB_SX127X_CRC_AUTOCLEAR_ON | RADIOLIB_SX127X_ADDRESS_FILTERING_OFF | RADIOLIB_SX127X_CRC_WHITENING_TYPE_CCITT, 7, 0);
   state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_2, RADIOLIB_SX127X_DATA_MODE_PACKET | RADIOLIB_SX127X_IO_HOME_OFF, 6, 5);
-  RADIOLIB_ASSERT(state);
 
   // set FIFO threshold
-  state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_FIFO_THRESH, RADIOLIB_SX127X_TX_START_FIFO_NOT_EMPTY, 7, 7);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_FIFO_THRESH, RADIOLIB_SX127X_TX_START_FIFO_NOT_EMPTY, 7, 7);
   state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_FIFO_THRESH, RADIOLIB_SX127X_FIFO_THRESH, 5, 0);
-  RADIOLIB_ASSERT(state);
 
   // disable Rx timeouts
-  state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_RX_TIMEOUT_1, RADIOLIB_SX127X_TIMEOUT_RX_RSSI_OFF);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_RX_TIMEOUT_1, RADIOLIB_SX127X_TIMEOUT_RX_RSSI_OFF);
   state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_RX_TIMEOUT_2, RADIOLIB_SX127X_TIMEOUT_RX_PREAMBLE_OFF);
   state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_RX_TIMEOUT_3, RADIOLIB_SX127X_TIMEOUT_SIGNAL_SYNC_OFF);
-  RADIOLIB_ASSERT(state);
 
   // enable preamble detector
-  state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PREAMBLE_DETECT, RADIOLIB_SX127X_PREAMBLE_DETECTOR_ON | RADIOLIB_SX127X_PREAMBLE_DETECTOR_2_BYTE | RADIOLIB_SX127X_PREAMBLE_DETECTOR_TOL);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PREAMBLE_DETECT, RADIOLIB_SX127X_PREAMBLE_DETECTOR_ON | RADIOLIB_SX127X_PREAMBLE_DETECTOR_2_BYTE | RADIOLIB_SX127X_PREAMBLE_DETECTOR_TOL);
 
+  state |= this->mod->SPIcommitBatch();
   return(state);
 }
 
-int16_t SX127x::setPacketMode(uint8_t mode, uint8_t len) {
-  // check packet length
-  if(len > RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK) {
+int16_t SX127x::setPacketMode(uint8_t mode, uint16_t len) {
+  // check packet length, only fixed length mode has the extra length bits
+  uint16_t maxLen = (mode == RADIOLIB_SX127X_PACKET_FIXED) ? RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK_FIXED : RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK_VARIABLE;
+  if(len > maxLen) {
     return(RADIOLIB_ERR_PACKET_TOO_LONG);
   }
 
@@ -1671,7 +1726,8 @@ int16_t SX127x::setPacketMode(uint8_t mode, uint8_t len) {
   RADIOLIB_ASSERT(state);
 
   // set length to register
-  state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PAYLOAD_LENGTH_FSK, len);
+  state = this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PACKET_CONFIG_2, len >> 8, 2, 0);
+  state |= this->mod->SPIsetRegValue(RADIOLIB_SX127X_REG_PAYLOAD_LENGTH_FSK, len & 0xFF);
   RADIOLIB_ASSERT(state);
 
   // update cached value
@@ -1679,6 +1735,12 @@ int16_t SX127x::setPacketMode(uint8_t mode, uint8_t len) {
   return(state);
 }
 
+RadioLibPacketFifo SX127x::getPacketFifo() {
+  uint8_t threshold = this->mod->SPIgetRegValue(RADIOLIB_SX127X_REG_FIFO_THRESH, 5, 0);
+  return(RadioLibPacketFifo(this->mod, RADIOLIB_SX127X_REG_FIFO, RADIOLIB_SX127X_REG_IRQ_FLAGS_2, RADIOLIB_SX127X_FLAG_FIFO_LEVEL,
+    RADIOLIB_SX127X_FLAG_PACKET_SENT, RADIOLIB_SX127X_FLAG_PAYLOAD_READY, RADIOLIB_SX127X_FLAG_CRC_OK, RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK, threshold));
+}
+
 bool SX127x::findChip(const uint8_t* vers, uint8_t num) {
   uint8_t i = 0;
   bool flagFound = false;
@@ -8,11 +8,14 @@
 #include "../../Module.h"
 
 #include "../../protocols/PhysicalLayer/PhysicalLayer.h"
+#include "../../utils/PacketFifo.h"
 
 // SX127x physical layer properties
 #define RADIOLIB_SX127X_FREQUENCY_STEP_SIZE                     61.03515625
 #define RADIOLIB_SX127X_MAX_PACKET_LENGTH                       255
 #define RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK                   64
+#define RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK_VARIABLE          255
+#define RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK_FIXED             2047
 #define RADIOLIB_SX127X_CRYSTAL_FREQ                            32.0
 #define RADIOLIB_SX127X_DIV_EXPONENT                            19
 
@@ -399,6 +402,7 @@
 #define RADIOLIB_SX127X_DATA_MODE_CONTINUOUS                    0b00000000  //  6     6              continuous
 #define RADIOLIB_SX127X_IO_HOME_OFF                             0b00000000  //  5     5   io-homecontrol compatibility disabled (default)
 #define RADIOLIB_SX127X_IO_HOME_ON                              0b00100000  //  5     5   io-homecontrol compatibility enabled
+#define RADIOLIB_SX127X_PAYLOAD_LENGTH_FSK_MSB                  0b00000111  //  2     0   payload length bits 10..8 (fixed packet length mode)
 
 // RADIOLIB_SX127X_REG_FIFO_THRESH
 #define RADIOLIB_SX127X_TX_START_FIFO_LEVEL                     0b00000000  //  7     7   start packet transmission when: number of bytes in FIFO exceeds FIFO_THRESHOLD
@@ -626,7 +630,9 @@ class SX127x: public PhysicalLayer {
     int16_t beginFSK(uint8_t* chipVersions, uint8_t numVersions, float freqDev, float rxBw, uint16_t preambleLength, bool enableOOK);
 
     /*!
-      \brief Binary transmit method. Will transmit arbitrary binary data up to 255 bytes long using %LoRa or up to 63 bytes using FSK modem.
+      \brief Binary transmit method. Will transmit arbitrary binary data up to 255 bytes long using %LoRa.
+      In FSK mode, packets longer than the 64-byte FIFO are streamed through it while on the air,
+      up to 255 bytes in variable and 2047 bytes in fixed packet length mode (see fixedPacketLengthMode).
       For overloads to transmit Arduino String or C-string, see PhysicalLayer::transmit.
       \param data Binary data that will be transmitted.
       \param len Length of binary data to transmit (in bytes).
@@ -636,7 +642,9 @@ class SX127x: public PhysicalLayer {
     int16_t transmit(const uint8_t* data, size_t len, uint8_t addr = 0) override;
 
     /*!
-      \brief Binary receive method. Will attempt to receive arbitrary binary data up to 255 bytes long using %LoRa or up to 63 bytes using FSK modem.
+      \brief Binary receive method. Will attempt to receive arbitrary binary data up to 255 bytes long using %LoRa.
+      In FSK mode, a buffer longer than the 64-byte FIFO makes the packet stream out of the FIFO while it is received,
+      the maximum length must be configured by variablePacketLengthMode or fixedPacketLengthMode.
       For overloads to receive Arduino String, see PhysicalLayer::receive.
       \param data Pointer to array to save the received binary data.
       \param len Number of bytes that will be received. Must be known in advance for binary transmissions.
@@ -1030,14 +1038,14 @@ class SX127x: public PhysicalLayer {
 
     /*!
       \brief Set modem in fixed packet length mode. Available in FSK mode only.
-      \param len Packet length.
+      \param len Packet length, up to 2047 bytes. Packets longer than the FIFO need blocking transmit/receive, or fifoAdd/fifoGet.
       \returns \ref status_codes
     */
-    int16_t fixedPacketLengthMode(uint8_t len = RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK);
+    int16_t fixedPacketLengthMode(uint16_t len = RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK);
 
     /*!
       \brief Set modem in variable packet length mode. Available in FSK mode only.
-      \param maxLen Maximum packet length.
+      \param maxLen Maximum packet length, up to 255 bytes. Packets longer than the FIFO need blocking transmit/receive, or fifoAdd/fifoGet.
       \returns \ref status_codes
     */
     int16_t variablePacketLengthMode(uint8_t maxLen = RADIOLIB_SX127X_MAX_PACKET_LENGTH_FSK);
@@ -1271,7 +1279,8 @@ class SX127x: public PhysicalLayer {
 
     int16_t config();
     int16_t directMode();
-    int16_t setPacketMode(uint8_t mode, uint8_t len);
+    int16_t setPacketMode(uint8_t mode, uint16_t len);
+    RadioLibPacketFifo getPacketFifo();
     bool findChip(const uint8_t* vers, uint8_t num);
     int16_t setMode(uint8_t mode);
     int16_t setActiveModem(uint8_t modem);
@@ -77,6 +77,7 @@ int16_t nRF24::standby(uint8_t mode) {
   this->mod->SPIsetRegValue(RADIOLIB_NRF24_REG_RF_SETUP, RADIOLIB_NRF24_CONT_WAVE_OFF, 7, 7);
   this->mod->SPIsetRegValue(RADIOLIB_NRF24_REG_RF_SETUP, RADIOLIB_NRF24_PLL_LOCK_OFF, 4, 4);
   this->mod->hal->digitalWrite(this->mod->getRst(), this->mod->hal->GpioLevelLow);
+  this->burstActive = false;
 
   // use standby-1 mode
   return(this->mod->SPIsetRegValue(RADIOLIB_NRF24_REG_CONFIG, mode, 1, 1));
@@ -278,6 +279,138 @@ int16_t nRF24::readData(uint8_t* data, size_t len) {
   return(RADIOLIB_ERR_NONE);
 }
 
+int16_t nRF24::startBurst(bool ack, nRF24BurstCb_t cb, void* ctx) {
+  // set mode to standby
+  int16_t state = standby();
+  RADIOLIB_ASSERT(state);
+
+  // enable primary Tx mode
+  state = this->mod->SPIsetRegValue(RADIOLIB_NRF24_REG_CONFIG, RADIOLIB_NRF24_PTX, 0, 0);
+  RADIOLIB_ASSERT(state);
+
+  // W_TX_PAYLOAD_NOACK is only accepted with dynamic ACK enabled
+  state = this->mod->SPIsetRegValue(RADIOLIB_NRF24_REG_FEATURE, ack ? RADIOLIB_NRF24_DYN_ACK_OFF : RADIOLIB_NRF24_DYN_ACK_ON, 0, 0);
+  RADIOLIB_ASSERT(state);
+
+  // clear interrupts, then enable both that end a packet
+  clearIRQ();
+  state = this->mod->SPIsetRegValue(RADIOLIB_NRF24_REG_CONFIG, RADIOLIB_NRF24_MASK_TX_DS_IRQ_ON | RADIOLIB_NRF24_MASK_MAX_RT_IRQ_ON, 5, 4);
+  RADIOLIB_ASSERT(state);
+
+  // flush Tx FIFO
+  SPItransfer(RADIOLIB_NRF24_CMD_FLUSH_TX);
+
+  this->burstActive = true;
+  this->burstAck = ack;
+  this->burstQueued = 0;
+  this->burstDone = 0;
+  this->burstFailed = 0;
+  this->burstCb = cb;
+  this->burstCtx = ctx;
+
+  // CE stays high for the whole burst, so each payload is sent as soon as it is in the FIFO
+  this->mod->hal->digitalWrite(this->mod->getRst(), this->mod->hal->GpioLevelHigh);
+  return(state);
+}
+
+int16_t nRF24::addBurst(const uint8_t* data, size_t len) {
+  if(!this->burstActive) {
+    return(RADIOLIB_ERR_BURST_NOT_STARTED);
+  }
+
+  // check packet length
+  if(len > RADIOLIB_NRF24_MAX_PACKET_LENGTH) {
+    return(RADIOLIB_ERR_PACKET_TOO_LONG);
+  }
+
+  // after MAX_RT, the FIFO is flushed by checkBurst, so nothing should be added before that
+  if(getStatus(RADIOLIB_NRF24_TX_FIFO_FULL | RADIOLIB_NRF24_MAX_RT)) {
+    return(RADIOLIB_ERR_BURST_FIFO_FULL);
+  }
+
+  uint8_t cmd = this->burstAck ? RADIOLIB_NRF24_CMD_WRITE_TX_PAYLOAD : RADIOLIB_NRF24_CMD_WRITE_TX_PAYLOAD_NOACK;
+  SPItransfer(cmd, true, const_cast<uint8_t*>(data), NULL, len);
+  this->burstQueued++;
+  return(RADIOLIB_ERR_NONE);
+}
+
+int16_t nRF24::checkBurst() {
+  if(!this->burstActive) {
+    return(RADIOLIB_ERR_BURST_NOT_STARTED);
+  }
+
+  // status goes first, so that a packet sent in between is either seen in the FIFO level, or by the next call
+  uint8_t status = this->mod->SPIreadRegister(RADIOLIB_NRF24_REG_STATUS);
+  uint8_t fifo = this->mod->SPIreadRegister(RADIOLIB_NRF24_REG_FIFO_STATUS);
+
+  // TX_DS is set for each packet, but may stand for two if the last call was too long ago;
+  // the FIFO level gives the exact count when the FIFO is empty or full, otherwise it holds one or two packets
+  uint32_t queued = this->burstQueued;
+  uint32_t counted = this->burstDone + ((status & RADIOLIB_NRF24_TX_DS) ? 1 : 0);
+  uint32_t done = counted;
+  if(fifo & RADIOLIB_NRF24_TX_FIFO_EMPTY_FLAG) {
+    done = queued;
+  } else if((fifo & RADIOLIB_NRF24_TX_FIFO_FULL_FLAG) && (queued >= RADIOLIB_NRF24_TX_FIFO_LEVELS)) {
+    done = queued - RADIOLIB_NRF24_TX_FIFO_LEVELS;
+  } else if(queued > 0) {
+    done = RADIOLIB_MIN(done, queued - 1);
+    if(queued >= 2) {
+      done = RADIOLIB_MAX(done, queued - 2);
+    }
+  }
+
+  // when the FIFO level accounts for more packets than the flag did, a TX_DS that latched
+  // after status was read is already counted, so it must not be counted again by the next call
+  if((status & RADIOLIB_NRF24_TX_DS) || (done > counted)) {
+    this->mod->SPIwriteRegister(RADIOLIB_NRF24_REG_STATUS, RADIOLIB_NRF24_TX_DS);
+  }
+  this->reportBurst(RADIOLIB_MAX(done, this->burstDone), RADIOLIB_ERR_NONE);
+
+  // transmission is halted with the failed packet at the head of the FIFO until MAX_RT is cleared
+  if(!(status & RADIOLIB_NRF24_MAX_RT)) {
+    return(RADIOLIB_ERR_NONE);
+  }
+  RADIOLIB_DEBUG_BASIC_PRINTLN("nRF24 burst: packet %lu not acknowledged, dropping %lu",
+    (unsigned long)this->burstDone, (unsigned long)(queued - this->burstDone));
+  SPItransfer(RADIOLIB_NRF24_CMD_FLUSH_TX);
+  this->mod->SPIwriteRegister(RADIOLIB_NRF24_REG_STATUS, RADIOLIB_NRF24_MAX_RT);
+  this->reportBurst(queued, RADIOLIB_ERR_ACK_NOT_RECEIVED);
+  return(RADIOLIB_ERR_ACK_NOT_RECEIVED);
+}
+
+int16_t nRF24::finishBurst() {
+  if(!this->burstActive) {
+    return(RADIOLIB_ERR_BURST_NOT_STARTED);
+  }
+
+  // same timeout as transmit for each pending packet: 15 retries * 4ms (max Tx time as per datasheet) + 10 ms
+  RadioLibTime_t timeout = ((15 * 4) + 10) * getBurstPending();
+  RadioLibTime_t start = this->mod->hal->millis();
+  int16_t state = RADIOLIB_ERR_NONE;
+  while(getBurstPending() > 0) {
+    checkBurst();
+    this->mod->hal->yield();
+
+    if(this->mod->hal->millis() - start >= timeout) {
+      SPItransfer(RADIOLIB_NRF24_CMD_FLUSH_TX);
+      this->reportBurst(this->burstQueued, RADIOLIB_ERR_TX_TIMEOUT);
+      state = RADIOLIB_ERR_TX_TIMEOUT;
+      break;
+    }
+  }
+
+  // disable payloads without ACK again, then clean up as after a single packet
+  this->mod->SPIsetRegValue(RADIOLIB_NRF24_REG_FEATURE, RADIOLIB_NRF24_DYN_ACK_OFF, 0, 0);
+  int16_t finished = finishTransmit();
+  RADIOLIB_ASSERT(state);
+  RADIOLIB_ASSERT(finished);
+  return((this->burstFailed > 0) ? RADIOLIB_ERR_ACK_NOT_RECEIVED : RADIOLIB_ERR_NONE);
+}
+
+size_t nRF24::getBurstPending() {
+  return(this->burstQueued - this->burstDone);
+}
+
 int16_t nRF24::setFrequency(float freq) {
   RADIOLIB_CHECK_RANGE((uint16_t)freq, 2400, 2525, RADIOLIB_ERR_INVALID_FREQUENCY);
 
@@ -569,6 +702,19 @@ void nRF24::clearIRQ() {
   this->mod->SPIsetRegValue(RADIOLIB_NRF24_REG_CONFIG, RADIOLIB_NRF24_MASK_RX_DR_IRQ_OFF | RADIOLIB_NRF24_MASK_TX_DS_IRQ_OFF | RADIOLIB_NRF24_MASK_MAX_RT_IRQ_OFF, 6, 4);
 }
 
+void nRF24::reportBurst(uint32_t done, int16_t state) {
+  // the callback may add the next packet, which does not change the number to report
+  while(this->burstDone < done) {
+    if(state != RADIOLIB_ERR_NONE) {
+      this->burstFailed++;
+    }
+    uint32_t seq = this->burstDone++;
+    if(this->burstCb) {
+      this->burstCb(seq, state, this->burstCtx);
+    }
+  }
+}
+
 int16_t nRF24::config() {
   // enable 16-bit CRC
   int16_t state = this->mod->SPIsetRegValue(RADIOLIB_NRF24_REG_CONFIG, RADIOLIB_NRF24_CRC_ON | RADIOLIB_NRF24_CRC_16, 3, 2);
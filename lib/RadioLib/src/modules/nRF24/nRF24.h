@@ -177,6 +177,19 @@
 #define RADIOLIB_NRF24_DEFAULT_POWER                            -12
 #define RADIOLIB_NRF24_DEFAULT_ADDRWIDTH                        5
 
+// number of payloads the Tx FIFO can hold
+#define RADIOLIB_NRF24_TX_FIFO_LEVELS                           3
+
+/*!
+  \brief Per-packet result of a burst transmission, called from nRF24::checkBurst.
+  \param seq Sequence number of the packet, i.e. the number of packets added by nRF24::addBurst before it.
+  \param state RADIOLIB_ERR_NONE when the packet was sent (and acknowledged, if enabled),
+  RADIOLIB_ERR_ACK_NOT_RECEIVED when it was dropped, RADIOLIB_ERR_TX_TIMEOUT if it was still pending
+  when finishBurst timed out.
+  \param ctx User context passed to nRF24::startBurst.
+*/
+typedef void (*nRF24BurstCb_t)(uint32_t seq, int16_t state, void* ctx);
+
 /*!
   \class nRF24
   \brief Control class for %nRF24 module.
@@ -338,6 +351,48 @@ class nRF24: public PhysicalLayer {
     */
     int16_t readData(uint8_t* data, size_t len) override;
 
+    /*!
+      \brief Start a burst transmission. The transmitter is kept enabled until finishBurst is called,
+      so packets added by addBurst are sent back-to-back as long as the Tx FIFO is not empty, while the next
+      ones are uploaded. TX_DS and MAX_RT are reflected on the IRQ pin (setPacketSentAction) during the burst.
+      \param ack Whether packets should be acknowledged. If false, they are sent with W_TX_PAYLOAD_NOACK
+      and count as sent once they are on air.
+      \param cb Optional function called from checkBurst with the result of each packet, in the order they were added.
+      \param ctx User context passed to cb.
+      \returns \ref status_codes
+    */
+    int16_t startBurst(bool ack = true, nRF24BurstCb_t cb = NULL, void* ctx = NULL);
+
+    /*!
+      \brief Add a packet to the running burst. Does not block; when all three levels of the Tx FIFO are occupied,
+      call checkBurst and try again.
+      \param data Binary data to be sent.
+      \param len Number of bytes to send, up to 32.
+      \returns \ref status_codes
+    */
+    int16_t addBurst(const uint8_t* data, size_t len);
+
+    /*!
+      \brief Process packets of the running burst that were sent or failed since the last call.
+      Should be called at least once per packet airtime, otherwise the results may be reported late.
+      When a packet is not acknowledged after all retransmissions, it is dropped together with all packets
+      queued behind it (they would most likely fail as well), each of them reported as failed.
+      \returns RADIOLIB_ERR_ACK_NOT_RECEIVED if packets were dropped during this call, otherwise \ref status_codes
+    */
+    int16_t checkBurst();
+
+    /*!
+      \brief Wait until all packets of the burst were processed and end the burst.
+      \returns RADIOLIB_ERR_ACK_NOT_RECEIVED if any packet of the burst was dropped, otherwise \ref status_codes
+    */
+    int16_t finishBurst();
+
+    /*!
+      \brief Get the number of packets of the burst that were added, but not processed by checkBurst yet.
+      \returns Number of pending packets.
+    */
+    size_t getBurstPending();
+
     // configuration methods
 
     /*!
@@ -484,8 +539,17 @@ class nRF24: public PhysicalLayer {
     int8_t power = RADIOLIB_NRF24_DEFAULT_POWER;
     uint8_t addressWidth = RADIOLIB_NRF24_DEFAULT_ADDRWIDTH;
 
+    bool burstActive = false;
+    bool burstAck = true;
+    uint32_t burstQueued = 0;
+    uint32_t burstDone = 0;
+    uint32_t burstFailed = 0;
+    nRF24BurstCb_t burstCb = NULL;
+    void* burstCtx = NULL;
+
     int16_t config();
     void clearIRQ();
+    void reportBurst(uint32_t done, int16_t state);
 };
 
 #endif
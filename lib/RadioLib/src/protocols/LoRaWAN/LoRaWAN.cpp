@@ -179,6 +179,7 @@ int16_t LoRaWANNode::sendReceive(const uint8_t* dataUp, size_t lenUp, uint8_t fP
     eventUp->fCnt = this->fCntUp;
     eventUp->fPort = fPort;
     eventUp->nbTrans = trans;
+    eventUp->multicast = RADIOLIB_LORAWAN_MULTICAST_NONE;
   }
 
   #if !RADIOLIB_STATIC_ONLY
@@ -200,6 +201,10 @@ int16_t LoRaWANNode::sendReceive(const uint8_t* dataUp, size_t lenUp, uint8_t fP
     }
     // remove only non-persistent MAC commands, the other commands should be re-sent until downlink is received
     LoRaWANNode::clearMacCommands(this->fOptsUp, &this->fOptsUpLen, RADIOLIB_LORAWAN_UPLINK);
+
+    // class C devices continue listening once the class A windows are closed
+    state = this->receiveClassC();
+    RADIOLIB_ASSERT(state);
     return(rxWindow);
   }
 
@@ -208,9 +213,13 @@ int16_t LoRaWANNode::sendReceive(const uint8_t* dataUp, size_t lenUp, uint8_t fP
   this->fOptsUpLen = 0;
 
   state = this->parseDownlink(dataDown, lenDown, eventDown);
+
+  // class C devices continue listening once the downlink is processed
+  int16_t stateRx = this->receiveClassC();
   
   // return an error code, if any, otherwise return Rx window (which is > 0)
   RADIOLIB_ASSERT(state);
+  RADIOLIB_ASSERT(stateRx);
   return(rxWindow);
 }
 
@@ -839,9 +848,9 @@ int16_t LoRaWANNode::processJoinAccept(LoRaWANJoinEvent_t *joinEvent) {
   this->bufferNonces[RADIOLIB_LORAWAN_NONCES_ACTIVE] = (uint8_t)true;
 
   // generate the signature of the Nonces buffer, and store it in the last two bytes of the Nonces buffer
+  // the configuration (mode, class, plan, keys) is filled in first, as it is covered by the signature too
   // also store this signature in the Session buffer to make sure these buffers match
-  uint16_t signature = LoRaWANNode::checkSum16(this->bufferNonces, RADIOLIB_LORAWAN_NONCES_BUF_SIZE - 2);
-  LoRaWANNode::hton<uint16_t>(&this->bufferNonces[RADIOLIB_LORAWAN_NONCES_SIGNATURE], signature);
+  uint16_t signature = LoRaWANNode::ntoh<uint16_t>(&this->getBufferNonces()[RADIOLIB_LORAWAN_NONCES_SIGNATURE]);
   LoRaWANNode::hton<uint16_t>(&this->bufferSession[RADIOLIB_LORAWAN_SESSION_NONCES_SIGNATURE], signature);
 
   // store DevAddr and all keys
@@ -874,6 +883,8 @@ int16_t LoRaWANNode::activateOTAA(uint8_t joinDr, LoRaWANJoinEvent_t *joinEvent)
   if(this->bufferNonces[RADIOLIB_LORAWAN_NONCES_ACTIVE]) {
     // session restored but not yet activated - do so now
     this->isActive = true;
+    int16_t state = this->receiveClassC();
+    RADIOLIB_ASSERT(state);
     return(RADIOLIB_LORAWAN_SESSION_RESTORED);
   }
 
@@ -952,6 +963,9 @@ int16_t LoRaWANNode::activateOTAA(uint8_t joinDr, LoRaWANJoinEvent_t *joinEvent)
   state = this->processJoinAccept(joinEvent);
   RADIOLIB_ASSERT(state);
 
+  state = this->receiveClassC();
+  RADIOLIB_ASSERT(state);
+
   return(RADIOLIB_LORAWAN_NEW_SESSION);
 }
 
@@ -964,6 +978,8 @@ int16_t LoRaWANNode::activateABP(uint8_t initialDr) {
   if(this->bufferNonces[RADIOLIB_LORAWAN_NONCES_ACTIVE]) {
     // session restored but not yet activated - do so now
     this->isActive = true;
+    int16_t state = this->receiveClassC();
+    RADIOLIB_ASSERT(state);
     return(RADIOLIB_LORAWAN_SESSION_RESTORED);
   }
 
@@ -974,9 +990,9 @@ int16_t LoRaWANNode::activateABP(uint8_t initialDr) {
   this->bufferNonces[RADIOLIB_LORAWAN_NONCES_ACTIVE] = (uint8_t)true;
 
   // generate the signature of the Nonces buffer, and store it in the last two bytes of the Nonces buffer
+  // the configuration (mode, class, plan, keys) is filled in first, as it is covered by the signature too
   // also store this signature in the Session buffer to make sure these buffers match
-  uint16_t signature = LoRaWANNode::checkSum16(this->bufferNonces, RADIOLIB_LORAWAN_NONCES_BUF_SIZE - 2);
-  LoRaWANNode::hton<uint16_t>(&this->bufferNonces[RADIOLIB_LORAWAN_NONCES_SIGNATURE], signature);
+  uint16_t signature = LoRaWANNode::ntoh<uint16_t>(&this->getBufferNonces()[RADIOLIB_LORAWAN_NONCES_SIGNATURE]);
   LoRaWANNode::hton<uint16_t>(&this->bufferSession[RADIOLIB_LORAWAN_SESSION_NONCES_SIGNATURE], signature);
 
   // store DevAddr and all keys
@@ -992,6 +1008,9 @@ int16_t LoRaWANNode::activateABP(uint8_t initialDr) {
 
   this->isActive = true;
 
+  int16_t state = this->receiveClassC();
+  RADIOLIB_ASSERT(state);
+
   return(RADIOLIB_LORAWAN_NEW_SESSION);
 }
 
@@ -1208,7 +1227,7 @@ void LoRaWANNode::composeUplink(const uint8_t* in, uint8_t lenIn, uint8_t* out,
 
     if(this->rev == 1) {
       // in LoRaWAN v1.1, the FOpts are encrypted using the NwkSEncKey
-      processAES(this->fOptsUp, this->fOptsUpLen, this->nwkSEncKey, &out[RADIOLIB_LORAWAN_FHDR_FOPTS_POS], this->fCntUp, RADIOLIB_LORAWAN_UPLINK, 0x01, true);
+      processAES(this->fOptsUp, this->fOptsUpLen, this->nwkSEncKey, &out[RADIOLIB_LORAWAN_FHDR_FOPTS_POS], this->devAddr, this->fCntUp, RADIOLIB_LORAWAN_UPLINK, 0x01, true);
     } else {
       // in LoRaWAN v1.0.x, the FOpts are unencrypted
       memcpy(&out[RADIOLIB_LORAWAN_FHDR_FOPTS_POS], this->fOptsUp, this->fOptsUpLen);
@@ -1226,7 +1245,7 @@ void LoRaWANNode::composeUplink(const uint8_t* in, uint8_t lenIn, uint8_t* out,
   }
 
   // encrypt the frame payload
-  processAES(in, lenIn, encKey, &out[RADIOLIB_LORAWAN_FRAME_PAYLOAD_POS(this->fOptsUpLen)], this->fCntUp, RADIOLIB_LORAWAN_UPLINK, 0x00, true);
+  processAES(in, lenIn, encKey, &out[RADIOLIB_LORAWAN_FRAME_PAYLOAD_POS(this->fOptsUpLen)], this->devAddr, this->fCntUp, RADIOLIB_LORAWAN_UPLINK, 0x00, true);
 }
 
 void LoRaWANNode::micUplink(uint8_t* inOut, uint8_t lenInOut) {
@@ -1454,6 +1473,71 @@ int16_t LoRaWANNode::receiveCommon(uint8_t dir, const LoRaWANChannel_t* dlChanne
   return(state);
 }
 
+int16_t LoRaWANNode::receiveClassC() {
+  if((this->lwClass != RADIOLIB_LORAWAN_CLASS_C) || !this->isActivated()) {
+    return(RADIOLIB_ERR_NONE);
+  }
+
+  // ADR or a new datarate may have changed the payload limit, find it now
+  // so that getMaxPayloadLen() doesn't have to interrupt the reception
+  (void)this->updateMaxFrameLen();
+
+  int16_t state = this->setPhyProperties(this->getClassCChannel(), RADIOLIB_LORAWAN_DOWNLINK, this->txPowerMax - 2*this->txPowerSteps);
+  RADIOLIB_ASSERT(state);
+
+  // the same interrupt as in the class A windows, but without a timeout
+  downlinkAction = false;
+  this->phyLayer->setPacketReceivedAction(LoRaWANNodeOnDownlinkAction);
+  RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Opening RxC window");
+  return(this->phyLayer->startReceive());
+}
+
+const LoRaWANChannel_t* LoRaWANNode::getClassCChannel() {
+  if(this->channelClassC.enabled) {
+    return(&this->channelClassC);
+  }
+  return(&this->channels[RADIOLIB_LORAWAN_DIR_RX2]);
+}
+
+int16_t LoRaWANNode::getDownlinkClassC(uint8_t* dataDown, size_t* lenDown, LoRaWANEvent_t* eventDown) {
+  if(!dataDown || !lenDown) {
+    return(RADIOLIB_ERR_NULL_POINTER);
+  }
+  *lenDown = 0;
+  if(this->lwClass != RADIOLIB_LORAWAN_CLASS_C) {
+    return(RADIOLIB_ERR_INVALID_MODE);
+  }
+  if(!this->isActivated()) {
+    return(RADIOLIB_ERR_NETWORK_NOT_JOINED);
+  }
+  if(!downlinkAction) {
+    return(0);
+  }
+  downlinkAction = false;
+  this->tDownlink = this->phyLayer->getMod()->hal->millis();
+
+  // frames longer than allowed at this datarate are silently discarded, as in the class A windows
+  const LoRaWANChannel_t* chnl = this->getClassCChannel();
+  int16_t state = RADIOLIB_ERR_NONE;
+  if(this->phyLayer->getPacketLength() <= (size_t)(this->band->payloadLenMax[chnl->dr] + 13)) {
+    state = this->parseDownlink(dataDown, lenDown, eventDown);
+  } else {
+    state = RADIOLIB_ERR_DOWNLINK_MALFORMED;
+  }
+
+  // the downlink was not received in the Rx1 window
+  if(eventDown && (state == RADIOLIB_ERR_NONE)) {
+    eventDown->datarate = chnl->dr;
+    eventDown->freq = chnl->freq / 10000.0;
+  }
+
+  // keep listening
+  int16_t stateRx = this->receiveClassC();
+  RADIOLIB_ASSERT(state);
+  RADIOLIB_ASSERT(stateRx);
+  return(RADIOLIB_LORAWAN_DIR_RXC);
+}
+
 int16_t LoRaWANNode::parseDownlink(uint8_t* data, size_t* len, LoRaWANEvent_t* event) {
   int16_t state = RADIOLIB_ERR_UNKNOWN;
   
@@ -1497,6 +1581,17 @@ int16_t LoRaWANNode::parseDownlink(uint8_t* data, size_t* len, LoRaWANEvent_t* e
   // check the address
   uint32_t addr = LoRaWANNode::ntoh<uint32_t>(&downlinkMsg[RADIOLIB_LORAWAN_FHDR_DEV_ADDR_POS]);
   if(addr != this->devAddr) {
+    // not addressed to this device, but maybe to one of its multicast groups
+    for(uint8_t id = 0; id < RADIOLIB_LORAWAN_MULTICAST_GROUPS; id++) {
+      if(this->mcGroups[id].active && (this->mcGroups[id].addr == addr)) {
+        state = this->parseMulticast(id, downlinkMsg, downlinkMsgLen, data, len, event);
+        #if !RADIOLIB_STATIC_ONLY
+          delete[] downlinkMsg;
+        #endif
+        return(state);
+      }
+    }
+
     RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Device address mismatch, expected 0x%08lX, got 0x%08lX", 
                                     (unsigned long)this->devAddr, (unsigned long)addr);
     #if !RADIOLIB_STATIC_ONLY
@@ -1684,7 +1779,7 @@ int16_t LoRaWANNode::parseDownlink(uint8_t* data, size_t* len, LoRaWANEvent_t* e
   }
 
   // decrypt the frame payload
-  processAES(&downlinkMsg[RADIOLIB_LORAWAN_FRAME_PAYLOAD_POS(fOptsPbLen)], payLen, encKey, dest, fCnt32, RADIOLIB_LORAWAN_DOWNLINK, 0x00, true);
+  processAES(&downlinkMsg[RADIOLIB_LORAWAN_FRAME_PAYLOAD_POS(fOptsPbLen)], payLen, encKey, dest, this->devAddr, fCnt32, RADIOLIB_LORAWAN_DOWNLINK, 0x00, true);
   
   // decrypt any piggy-backed FOpts
   if(fOptsPbLen > 0) {
@@ -1692,7 +1787,7 @@ int16_t LoRaWANNode::parseDownlink(uint8_t* data, size_t* len, LoRaWANEvent_t* e
     if(this->rev == 1) {
       // in LoRaWAN v1.1, the piggy-backed FOpts are encrypted using the NwkSEncKey
       uint8_t ctrId = 0x01 + isAppDownlink; // see LoRaWAN v1.1 errata
-      processAES(&downlinkMsg[RADIOLIB_LORAWAN_FHDR_FOPTS_POS], (size_t)fOptsPbLen, this->nwkSEncKey, fOpts, fCnt32, RADIOLIB_LORAWAN_DOWNLINK, ctrId, true);
+      processAES(&downlinkMsg[RADIOLIB_LORAWAN_FHDR_FOPTS_POS], (size_t)fOptsPbLen, this->nwkSEncKey, fOpts, this->devAddr, fCnt32, RADIOLIB_LORAWAN_DOWNLINK, ctrId, true);
     } else {
       // in LoRaWAN v1.0.x, the piggy-backed FOpts are unencrypted
       memcpy(fOpts, &downlinkMsg[RADIOLIB_LORAWAN_FHDR_FOPTS_POS], (size_t)fOptsPbLen);
@@ -1832,6 +1927,7 @@ int16_t LoRaWANNode::parseDownlink(uint8_t* data, size_t* len, LoRaWANEvent_t* e
     event->power = this->txPowerMax - this->txPowerSteps * 2;
     event->fCnt = isAppDownlink ? this->aFCntDown : this->nFCntDown;
     event->fPort = fPort;
+    event->multicast = RADIOLIB_LORAWAN_MULTICAST_NONE;
   }
 
   #if !RADIOLIB_STATIC_ONLY
@@ -1843,6 +1939,76 @@ int16_t LoRaWANNode::parseDownlink(uint8_t* data, size_t* len, LoRaWANEvent_t* e
   return(RADIOLIB_ERR_NONE);
 }
 
+int16_t LoRaWANNode::parseMulticast(uint8_t id, uint8_t* msg, size_t msgLen, uint8_t* data, size_t* len, LoRaWANEvent_t* event) {
+  LoRaWANMulticastGroup_t* group = &this->mcGroups[id];
+
+  // multicast frames are unconfirmed, never acknowledge anything and carry no MAC commands
+  uint8_t mType = msg[RADIOLIB_LORAWAN_FHDR_LEN_START_OFFS] & RADIOLIB_LORAWAN_MHDR_MTYPE_MASK;
+  uint8_t fCtrl = msg[RADIOLIB_LORAWAN_FHDR_FCTRL_POS];
+  if((mType != RADIOLIB_LORAWAN_MHDR_MTYPE_UNCONF_DATA_DOWN) ||
+     (fCtrl & (RADIOLIB_LORAWAN_FHDR_FOPTS_LEN_MASK | RADIOLIB_LORAWAN_FCTRL_ACK))) {
+    RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Invalid multicast frame (MHDR 0x%02x, FCtrl 0x%02x)", mType, fCtrl);
+    return(RADIOLIB_ERR_DOWNLINK_MALFORMED);
+  }
+
+  // MHDR(1) - McAddr(4) - FCtrl(1) - FCnt(2) - FPort(1) - Payload - MIC(4)
+  if(msgLen < 1 + 4 + 1 + 2 + 1 + 4) {
+    return(RADIOLIB_ERR_DOWNLINK_MALFORMED);
+  }
+  uint8_t payLen = msgLen - 1 - 4 - 1 - 2 - 1 - 4;
+  uint8_t fPort = msg[RADIOLIB_LORAWAN_FHDR_FPORT_POS(0)];
+  if((fPort == RADIOLIB_LORAWAN_FPORT_MAC_COMMAND) || (fPort > RADIOLIB_LORAWAN_FPORT_PAYLOAD_MAX)) {
+    RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Multicast downlink at FPort %d - rejected!", fPort);
+    return(RADIOLIB_ERR_INVALID_PORT);
+  }
+
+  // restore the 32-bit frame counter, assuming a rollover if the 16 bits are lower than expected
+  uint16_t fCnt16 = LoRaWANNode::ntoh<uint16_t>(&msg[RADIOLIB_LORAWAN_FHDR_FCNT_POS]);
+  uint32_t fCnt32 = (group->fCnt & 0xFFFF0000UL) | fCnt16;
+  if(fCnt32 < group->fCnt) {
+    fCnt32 += 0x10000UL;
+  }
+  if((fCnt32 < group->fCnt) || (fCnt32 > group->fCntMax)) {
+    return(RADIOLIB_ERR_A_FCNT_DOWN_INVALID);
+  }
+
+  // the MIC is calculated the same way as for unicast frames, over the group address and keys
+  memset(msg, 0x00, RADIOLIB_AES128_BLOCK_SIZE);
+  msg[RADIOLIB_LORAWAN_BLOCK_MAGIC_POS] = RADIOLIB_LORAWAN_MIC_BLOCK_MAGIC;
+  msg[RADIOLIB_LORAWAN_BLOCK_DIR_POS] = RADIOLIB_LORAWAN_DOWNLINK;
+  LoRaWANNode::hton<uint32_t>(&msg[RADIOLIB_LORAWAN_BLOCK_DEV_ADDR_POS], group->addr);
+  LoRaWANNode::hton<uint32_t>(&msg[RADIOLIB_LORAWAN_BLOCK_FCNT_POS], fCnt32);
+  msg[RADIOLIB_LORAWAN_MIC_BLOCK_LEN_POS] = msgLen - sizeof(uint32_t);
+  if(!verifyMIC(msg, RADIOLIB_AES128_BLOCK_SIZE + msgLen, group->nwkSKey)) {
+    return(RADIOLIB_ERR_CRC_MISMATCH);
+  }
+
+  // the session ends with its last frame counter
+  group->fCnt = fCnt32 + 1;
+  if(fCnt32 == group->fCntMax) {
+    group->active = false;
+  }
+
+  processAES(&msg[RADIOLIB_LORAWAN_FRAME_PAYLOAD_POS(0)], payLen, group->appSKey, data, group->addr, fCnt32, RADIOLIB_LORAWAN_DOWNLINK, 0x00, true);
+  *len = payLen;
+  RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Multicast downlink (group %d, FCnt = %lu, FPort = %d)", id, (unsigned long)fCnt32, fPort);
+
+  if(event) {
+    event->dir = RADIOLIB_LORAWAN_DOWNLINK;
+    event->confirmed = false;
+    event->confirming = false;
+    event->frmPending = (fCtrl & RADIOLIB_LORAWAN_FCTRL_FRAME_PENDING) != 0;
+    event->datarate = this->channels[RADIOLIB_LORAWAN_DOWNLINK].dr;
+    event->freq = this->channels[RADIOLIB_LORAWAN_DOWNLINK].freq / 10000.0;
+    event->power = this->txPowerMax - this->txPowerSteps * 2;
+    event->fCnt = fCnt32;
+    event->fPort = fPort;
+    event->multicast = id;
+  }
+
+  return(RADIOLIB_ERR_NONE);
+}
+
 bool LoRaWANNode::execMacCommand(uint8_t cid, uint8_t* optIn, uint8_t lenIn) {
   uint8_t buff[RADIOLIB_LORAWAN_MAX_MAC_COMMAND_LEN_DOWN];
   return(this->execMacCommand(cid, optIn, lenIn, buff));
@@ -2712,6 +2878,7 @@ void LoRaWANNode::setDutyCycle(bool enable, RadioLibTime_t msPerHour) {
   this->dutyCycleEnabled = enable;
   if(!enable) {
     this->dutyCycle = 0;
+    return;
   }
   if(msPerHour == 0) {
     this->dutyCycle = this->band->dutyCycle;
@@ -2747,6 +2914,65 @@ void LoRaWANNode::setCSMA(bool csmaEnabled, uint8_t maxChanges, uint8_t backoffM
   }
 }
 
+int16_t LoRaWANNode::setClass(uint8_t cls) {
+  if((cls != RADIOLIB_LORAWAN_CLASS_A) && (cls != RADIOLIB_LORAWAN_CLASS_C)) {
+    return(RADIOLIB_ERR_UNSUPPORTED);
+  }
+  uint8_t prev = this->lwClass;
+  this->lwClass = cls;
+
+  // when switching back to class A, stop listening outside of the Rx windows
+  if((prev == RADIOLIB_LORAWAN_CLASS_C) && (cls == RADIOLIB_LORAWAN_CLASS_A) && this->isActivated()) {
+    this->phyLayer->clearPacketReceivedAction();
+    return(this->phyLayer->standby());
+  }
+  return(this->receiveClassC());
+}
+
+int16_t LoRaWANNode::setClassCChannel(float freq, uint8_t dr) {
+  if(freq == 0) {
+    this->channelClassC.enabled = false;
+    return(this->receiveClassC());
+  }
+
+  uint32_t freqRaw = (freq * 10000.0) + 0.5;
+  if((freqRaw < this->band->freqMin) || (freqRaw > this->band->freqMax)) {
+    return(RADIOLIB_ERR_INVALID_FREQUENCY);
+  }
+  if((dr >= RADIOLIB_LORAWAN_CHANNEL_NUM_DATARATES) || (this->band->dataRates[dr] == RADIOLIB_LORAWAN_DATA_RATE_UNUSED)) {
+    return(RADIOLIB_ERR_INVALID_DATA_RATE);
+  }
+  this->channelClassC.enabled = true;
+  this->channelClassC.freq = freqRaw;
+  this->channelClassC.dr = dr;
+  return(this->receiveClassC());
+}
+
+int16_t LoRaWANNode::addMulticastGroup(uint8_t id, uint32_t mcAddr, const uint8_t* mcAppSKey, const uint8_t* mcNwkSKey, uint32_t fCntMin, uint32_t fCntMax) {
+  if(!mcAppSKey || !mcNwkSKey) {
+    return(RADIOLIB_ERR_NULL_POINTER);
+  }
+  if((id >= RADIOLIB_LORAWAN_MULTICAST_GROUPS) || (fCntMin > fCntMax)) {
+    return(RADIOLIB_ERR_INVALID_MULTICAST_GROUP);
+  }
+  LoRaWANMulticastGroup_t* group = &this->mcGroups[id];
+  group->addr = mcAddr;
+  memcpy(group->appSKey, mcAppSKey, RADIOLIB_AES128_KEY_SIZE);
+  memcpy(group->nwkSKey, mcNwkSKey, RADIOLIB_AES128_KEY_SIZE);
+  group->fCnt = fCntMin;
+  group->fCntMax = fCntMax;
+  group->active = true;
+  return(RADIOLIB_ERR_NONE);
+}
+
+int16_t LoRaWANNode::removeMulticastGroup(uint8_t id) {
+  if(id >= RADIOLIB_LORAWAN_MULTICAST_GROUPS) {
+    return(RADIOLIB_ERR_INVALID_MULTICAST_GROUP);
+  }
+  this->mcGroups[id].active = false;
+  return(RADIOLIB_ERR_NONE);
+}
+
 void LoRaWANNode::setDeviceStatus(uint8_t battLevel) {
   this->battLevel = battLevel;
 }
@@ -3269,42 +3495,82 @@ RadioLibTime_t LoRaWANNode::timeUntilUplink() {
 }
 
 uint8_t LoRaWANNode::getMaxPayloadLen() {
-  // configure the uplink channel properties
-  this->setPhyProperties(&this->channels[RADIOLIB_LORAWAN_UPLINK], 
-                         RADIOLIB_LORAWAN_UPLINK,
-                         this->txPowerMax - 2*this->txPowerSteps);
-
-  uint8_t minLen = 0;
   uint8_t maxLen = this->band->payloadLenMax[this->channels[RADIOLIB_LORAWAN_UPLINK].dr];
   if(this->TS011) {
     maxLen = RADIOLIB_MIN(maxLen, 222); // payload length is limited to N=222 if under repeater
   }
-  maxLen += 13;                         // mandatory FHDR is 12/13 bytes
 
   // if not limited by dwell-time, just return maximum
   if(!this->dwellTimeUp) {
-    // subtract FHDR (13 bytes) as well as any FOpts
-    return(maxLen - 13 - this->fOptsUpLen);
+    // subtract any FOpts
+    return(maxLen - this->fOptsUpLen);
   }
 
-  // fast exit in case upper limit is already good
-  if(this->phyLayer->getTimeOnAir(maxLen) / 1000 <= this->dwellTimeUp) {
-    // subtract FHDR (13 bytes) as well as any FOpts
-    return(maxLen - 13 - this->fOptsUpLen);
+  // the cache only misses after the datarate or dwell time was changed outside of sendReceive,
+  // then the radio is configured for uplink and a class C device goes back to listening
+  if((this->maxFrameLenDr != this->channels[RADIOLIB_LORAWAN_UPLINK].dr) ||
+     (this->maxFrameLenDwell != this->dwellTimeUp) || (this->maxFrameLenTS011 != this->TS011)) {
+    int16_t state = this->updateMaxFrameLen();
+    (void)this->receiveClassC();
+    if(state != RADIOLIB_ERR_NONE) {
+      return(maxLen - this->fOptsUpLen);
+    }
   }
 
-  // do some binary search to find maximum allowed length
-  uint8_t curLen = (minLen + maxLen) / 2;
-  while(curLen != minLen && curLen != maxLen) {
-    if(this->phyLayer->getTimeOnAir(curLen) / 1000 > this->dwellTimeUp) {
-      maxLen = curLen;
-    } else {
-      minLen = curLen;
-    }
-    curLen = (minLen + maxLen) / 2;
+  // not even the header may fit at low datarates
+  if(this->maxFrameLen < 13 + this->fOptsUpLen) {
+    return(0);
   }
+
   // subtract FHDR (13 bytes) as well as any FOpts
-  return(curLen - 13 - this->fOptsUpLen);
+  return(this->maxFrameLen - 13 - this->fOptsUpLen);
+}
+
+int16_t LoRaWANNode::updateMaxFrameLen() {
+  uint8_t dr = this->channels[RADIOLIB_LORAWAN_UPLINK].dr;
+  if(!this->dwellTimeUp || ((this->maxFrameLenDr == dr) &&
+     (this->maxFrameLenDwell == this->dwellTimeUp) && (this->maxFrameLenTS011 == this->TS011))) {
+    return(RADIOLIB_ERR_NONE);
+  }
+
+  uint8_t minLen = 0;
+  uint8_t maxLen = this->band->payloadLenMax[dr];
+  if(this->TS011) {
+    maxLen = RADIOLIB_MIN(maxLen, 222); // payload length is limited to N=222 if under repeater
+  }
+  maxLen += 13;                         // mandatory FHDR is 12/13 bytes
+
+  // time-on-air depends on the radio configuration, but not on the carrier,
+  // which is not known yet if no uplink channel was selected so far
+  LoRaWANChannel_t chnl = this->channels[RADIOLIB_LORAWAN_UPLINK];
+  if(chnl.freq == 0) {
+    chnl.freq = this->band->freqMin;
+  }
+  int16_t state = this->setPhyProperties(&chnl, 
+                                         RADIOLIB_LORAWAN_UPLINK,
+                                         this->txPowerMax - 2*this->txPowerSteps);
+  RADIOLIB_ASSERT(state);
+
+  // fast exit in case upper limit is already good
+  uint8_t curLen = maxLen;
+  if(this->phyLayer->getTimeOnAir(maxLen) / 1000 > this->dwellTimeUp) {
+    // do some binary search to find maximum allowed length
+    curLen = (minLen + maxLen) / 2;
+    while(curLen != minLen && curLen != maxLen) {
+      if(this->phyLayer->getTimeOnAir(curLen) / 1000 > this->dwellTimeUp) {
+        maxLen = curLen;
+      } else {
+        minLen = curLen;
+      }
+      curLen = (minLen + maxLen) / 2;
+    }
+  }
+
+  this->maxFrameLen = curLen;
+  this->maxFrameLenDr = dr;
+  this->maxFrameLenDwell = this->dwellTimeUp;
+  this->maxFrameLenTS011 = this->TS011;
+  return(RADIOLIB_ERR_NONE);
 }
 
 int16_t LoRaWANNode::findDataRate(uint8_t dr, DataRate_t* dataRate) {
@@ -3390,7 +3656,7 @@ int16_t LoRaWANNode::findDataRate(uint8_t dr, DataRate_t* dataRate) {
   return(state);
 }
 
-void LoRaWANNode::processAES(const uint8_t* in, size_t len, uint8_t* key, uint8_t* out, uint32_t fCnt, uint8_t dir, uint8_t ctrId, bool counter) {
+void LoRaWANNode::processAES(const uint8_t* in, size_t len, uint8_t* key, uint8_t* out, uint32_t addr, uint32_t fCnt, uint8_t dir, uint8_t ctrId, bool counter) {
   // figure out how many encryption blocks are there
   size_t numBlocks = len/RADIOLIB_AES128_BLOCK_SIZE;
   if(len % RADIOLIB_AES128_BLOCK_SIZE) {
@@ -3403,7 +3669,7 @@ void LoRaWANNode::processAES(const uint8_t* in, size_t len, uint8_t* key, uint8_
   encBlock[RADIOLIB_LORAWAN_BLOCK_MAGIC_POS] = RADIOLIB_LORAWAN_ENC_BLOCK_MAGIC;
   encBlock[RADIOLIB_LORAWAN_ENC_BLOCK_COUNTER_ID_POS] = ctrId;
   encBlock[RADIOLIB_LORAWAN_BLOCK_DIR_POS] = dir;
-  LoRaWANNode::hton<uint32_t>(&encBlock[RADIOLIB_LORAWAN_BLOCK_DEV_ADDR_POS], this->devAddr);
+  LoRaWANNode::hton<uint32_t>(&encBlock[RADIOLIB_LORAWAN_BLOCK_DEV_ADDR_POS], addr);
   LoRaWANNode::hton<uint32_t>(&encBlock[RADIOLIB_LORAWAN_BLOCK_FCNT_POS], fCnt);
 
   // now encrypt the input
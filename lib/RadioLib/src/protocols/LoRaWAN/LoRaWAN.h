@@ -76,6 +76,7 @@
 #define RADIOLIB_LORAWAN_UPLINK                             (0x00 << 0)
 #define RADIOLIB_LORAWAN_DOWNLINK                           (0x01 << 0)
 #define RADIOLIB_LORAWAN_DIR_RX2                                (0x02 << 0)
+#define RADIOLIB_LORAWAN_DIR_RXC                                (0x03 << 0)
 #define RADIOLIB_LORAWAN_BAND_DYNAMIC                           (0)
 #define RADIOLIB_LORAWAN_BAND_FIXED                             (1)
 #define RADIOLIB_LORAWAN_CHANNEL_NUM_DATARATES                  (15)
@@ -96,6 +97,9 @@
 #define RADIOLIB_LORAWAN_REJOIN_MAX_COUNT_N                     (10)  // send rejoin request 16384 uplinks
 #define RADIOLIB_LORAWAN_REJOIN_MAX_TIME_N                      (15)  // once every year, not actually implemented
 
+// multicast
+#define RADIOLIB_LORAWAN_MULTICAST_NONE                         (0xFF)
+
 // join request message layout
 #define RADIOLIB_LORAWAN_JOIN_REQUEST_LEN                       (23)
 #define RADIOLIB_LORAWAN_JOIN_REQUEST_JOIN_EUI_POS              (1)
@@ -513,11 +517,38 @@ struct LoRaWANEvent_t {
 
   /*! \brief Number of times this uplink was transmitted (ADR)*/
   uint8_t nbTrans;
+
+  /*! \brief Multicast group the downlink was addressed to, RADIOLIB_LORAWAN_MULTICAST_NONE for unicast */
+  uint8_t multicast;
+};
+
+/*!
+  \struct LoRaWANMulticastGroup_t
+  \brief Session of a multicast group, shared between all devices in that group.
+*/
+struct LoRaWANMulticastGroup_t {
+  /*! \brief Whether downlinks to this group are accepted */
+  bool active;
+
+  /*! \brief Multicast group address (McAddr) */
+  uint32_t addr;
+
+  /*! \brief Application session key of the group (McAppSKey) */
+  uint8_t appSKey[RADIOLIB_AES128_KEY_SIZE];
+
+  /*! \brief Network session key of the group (McNwkSKey) */
+  uint8_t nwkSKey[RADIOLIB_AES128_KEY_SIZE];
+
+  /*! \brief Lowest frame counter that will still be accepted */
+  uint32_t fCnt;
+
+  /*! \brief Last frame counter of the session (inclusive) */
+  uint32_t fCntMax;
 };
 
 /*!
   \class LoRaWANNode
-  \brief LoRaWAN-compatible node (class A device).
+  \brief LoRaWAN-compatible node (class A or class C device).
 */
 class LoRaWANNode {
   public:
@@ -759,6 +790,57 @@ class LoRaWANNode {
     */
     void setCSMA(bool csmaEnabled, uint8_t maxChanges = 4, uint8_t backoffMax = 0, uint8_t difsSlots = 2);
 
+    /*!
+      \brief Set the device class. Call this after beginOTAA() or beginABP() and before restoring
+      the buffers, as the class is part of the saved configuration.
+      A class C device listens continuously on the RX2 channel whenever it is not transmitting
+      or in its class A windows; received frames are retrieved with getDownlinkClassC().
+      \param cls Device class, RADIOLIB_LORAWAN_CLASS_A or RADIOLIB_LORAWAN_CLASS_C.
+      \returns \ref status_codes
+    */
+    int16_t setClass(uint8_t cls);
+
+    /*!
+      \brief Listen on a channel other than RX2 in class C, e.g. the one of a multicast session.
+      \param freq Frequency in MHz, 0 to revert to the RX2 channel.
+      \param dr Data rate to listen at.
+      \returns \ref status_codes
+    */
+    int16_t setClassCChannel(float freq, uint8_t dr);
+
+    /*!
+      \brief Retrieve a downlink received in class C. This does not block, call it periodically
+      or when the radio interrupt fires. Reception continues afterwards.
+      \param dataDown Buffer to save received data into.
+      \param lenDown Pointer to variable that will be used to save the number of received bytes.
+      \param eventDown Pointer to a structure to store extra information about the downlink event
+      (fPort, frame counter, multicast group etc.). If set to NULL, no extra information will be passed to the user.
+      \returns RADIOLIB_LORAWAN_DIR_RXC if a downlink was received, 0 if not, or \ref status_codes in case of an error.
+    */
+    int16_t getDownlinkClassC(uint8_t* dataDown, size_t* lenDown, LoRaWANEvent_t* eventDown = NULL);
+
+    /*!
+      \brief Start accepting downlinks of a multicast group. Multicast downlinks are unconfirmed
+      and are usually sent in class C. The group sessions are not part of the session buffer,
+      so they have to be added again after restoring a session.
+      \param id Group ID, 0 to RADIOLIB_LORAWAN_MULTICAST_GROUPS - 1.
+      \param mcAddr Multicast address of the group.
+      \param mcAppSKey 16-byte application session key of the group.
+      \param mcNwkSKey 16-byte network session key of the group.
+      \param fCntMin Lowest frame counter of the session.
+      \param fCntMax Highest frame counter of the session, the group is removed after it was received.
+      \returns \ref status_codes
+    */
+    int16_t addMulticastGroup(uint8_t id, uint32_t mcAddr, const uint8_t* mcAppSKey, const uint8_t* mcNwkSKey,
+                              uint32_t fCntMin = 0, uint32_t fCntMax = 0xFFFFFFFF);
+
+    /*!
+      \brief Stop accepting downlinks of a multicast group.
+      \param id Group ID, 0 to RADIOLIB_LORAWAN_MULTICAST_GROUPS - 1.
+      \returns \ref status_codes
+    */
+    int16_t removeMulticastGroup(uint8_t id);
+
     /*!
       \brief Set device status.
       \param battLevel Battery level to set. 0 for external power source, 1 for lowest battery,
@@ -827,6 +909,8 @@ class LoRaWANNode {
     /*! 
       \brief Returns the maximum allowed uplink payload size given the current MAC state.
       Most importantly, this includes dwell time limitations and ADR.
+      Under dwell time the limit is cached per datarate; a class C device refreshes it before it starts listening,
+      so this normally does not touch the radio.
     */
     uint8_t getMaxPayloadLen();
 
@@ -853,6 +937,9 @@ class LoRaWANNode {
 #if !RADIOLIB_GODMODE
   protected:
 #endif
+    // allow the uplink queue to use the clock of the radio
+    friend class LoRaWANUplinkQueue;
+
     PhysicalLayer* phyLayer = NULL;
     const LoRaWANBand_t* band = NULL;
 
@@ -916,6 +1003,12 @@ class LoRaWANNode {
     uint16_t dwellTimeUp = 0;
     uint16_t dwellTimeDn = 0;
 
+    // longest uplink frame (including FHDR) allowed by the dwell time, and the state it was found for
+    uint8_t maxFrameLen = 0;
+    uint8_t maxFrameLenDr = RADIOLIB_LORAWAN_DATA_RATE_UNUSED;
+    uint16_t maxFrameLenDwell = 0;
+    bool maxFrameLenTS011 = false;
+
     RadioLibTime_t tUplink = 0;   // scheduled uplink transmission time (internal clock)
     RadioLibTime_t tDownlink = 0; // time at end of downlink reception
 
@@ -971,6 +1064,12 @@ class LoRaWANNode {
     // allow port 226 for devices implementing TS011
     bool TS011 = false;
 
+    // multicast group sessions
+    LoRaWANMulticastGroup_t mcGroups[RADIOLIB_LORAWAN_MULTICAST_GROUPS] = { };
+
+    // channel to listen on in class C, if not set the RX2 channel is used
+    LoRaWANChannel_t channelClassC = RADIOLIB_LORAWAN_CHANNEL_NONE;
+
     // this will reset the device credentials, so the device starts completely new
     void clearNonces();
 
@@ -1007,6 +1106,18 @@ class LoRaWANNode {
     // extract downlink payload and process MAC commands
     int16_t parseDownlink(uint8_t* data, size_t* len, LoRaWANEvent_t* event = NULL);
 
+    // verify and decrypt a downlink addressed to a multicast group (its header is already read)
+    int16_t parseMulticast(uint8_t id, uint8_t* msg, size_t msgLen, uint8_t* data, size_t* len, LoRaWANEvent_t* event);
+
+    // (re)start continuous reception if this is an active class C device
+    int16_t receiveClassC();
+
+    // find the longest uplink frame allowed by the dwell time, unless cached; leaves the radio configured for uplink
+    int16_t updateMaxFrameLen();
+
+    // get the channel used for class C reception
+    const LoRaWANChannel_t* getClassCChannel();
+
     // execute mac command, return the number of processed bytes for sequential processing
     bool execMacCommand(uint8_t cid, uint8_t* optIn, uint8_t lenIn);
     bool execMacCommand(uint8_t cid, uint8_t* optIn, uint8_t lenIn, uint8_t* optOut);
@@ -1097,7 +1208,7 @@ class LoRaWANNode {
     int16_t findDataRate(uint8_t dr, DataRate_t* dataRate);
 
     // function to encrypt and decrypt payloads (regular uplink/downlink)
-    void processAES(const uint8_t* in, size_t len, uint8_t* key, uint8_t* out, uint32_t fCnt, uint8_t dir, uint8_t ctrId, bool counter);
+    void processAES(const uint8_t* in, size_t len, uint8_t* key, uint8_t* out, uint32_t addr, uint32_t fCnt, uint8_t dir, uint8_t ctrId, bool counter);
 
     // 16-bit checksum method that takes a uint8_t array of even length and calculates the checksum
     static uint16_t checkSum16(const uint8_t *key, uint16_t keyLen);
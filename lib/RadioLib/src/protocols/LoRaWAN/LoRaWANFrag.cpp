@@ -0,0 +1,376 @@
+#include "LoRaWANFrag.h"
+#include <string.h>
+
+#if !RADIOLIB_EXCLUDE_LORAWAN
+
+// maximum length of all answers to a single downlink
+#define RADIOLIB_LORAWAN_FRAG_ANSWER_MAX_LEN                    (16)
+
+LoRaWANFragSession::LoRaWANFragSession(uint8_t* buffer, size_t size) {
+  this->buffer = buffer;
+  this->bufferSize = size;
+}
+
+int16_t LoRaWANFragSession::handle(const uint8_t* dataDown, size_t lenDown, uint8_t* dataUp, size_t* lenUp) {
+  if(!dataDown || !dataUp || !lenUp) {
+    return(RADIOLIB_ERR_NULL_POINTER);
+  }
+  *lenUp = 0;
+
+  size_t pos = 0;
+  while(pos < lenDown) {
+    uint8_t cid = dataDown[pos++];
+    const uint8_t* req = &dataDown[pos];
+    size_t remLen = lenDown - pos;
+
+    // answer as built for this command, only appended if it still fits
+    uint8_t ans[5] = { cid };
+    uint8_t ansLen = 0;
+
+    switch(cid) {
+      case(RADIOLIB_LORAWAN_FRAG_PACKAGE_VERSION_REQ): {
+        ans[1] = RADIOLIB_LORAWAN_FRAG_PACKAGE_ID;
+        ans[2] = RADIOLIB_LORAWAN_FRAG_PACKAGE_VERSION;
+        ansLen = 3;
+      } break;
+
+      case(RADIOLIB_LORAWAN_FRAG_SESSION_STATUS_REQ): {
+        if(remLen < 1) {
+          return(RADIOLIB_ERR_DOWNLINK_MALFORMED);
+        }
+        pos += 1;
+
+        // without the participants bit, only devices that still miss fragments answer
+        uint8_t idx = (req[0] >> 1) & 0x03;
+        bool participants = req[0] & 0x01;
+        if(!this->active || (idx != this->index) || (!participants && this->complete)) {
+          break;
+        }
+        uint16_t receivedAndIndex = (this->nbReceived & 0x3FFF) | ((uint16_t)this->index << 14);
+        ans[1] = (uint8_t)receivedAndIndex;
+        ans[2] = (uint8_t)(receivedAndIndex >> 8);
+        ans[3] = (uint8_t)RADIOLIB_MIN(this->getMissing(), 0xFF);
+        ans[4] = this->memoryError ? 0x01 : 0x00;
+        ansLen = 5;
+      } break;
+
+      case(RADIOLIB_LORAWAN_FRAG_SESSION_SETUP_REQ): {
+        if(remLen < 10) {
+          return(RADIOLIB_ERR_DOWNLINK_MALFORMED);
+        }
+        pos += 10;
+        this->setup(req, &ans[1]);
+        ansLen = 2;
+      } break;
+
+      case(RADIOLIB_LORAWAN_FRAG_SESSION_DELETE_REQ): {
+        if(remLen < 1) {
+          return(RADIOLIB_ERR_DOWNLINK_MALFORMED);
+        }
+        pos += 1;
+        uint8_t idx = req[0] & 0x03;
+        ans[1] = idx;
+        if(!this->active || (idx != this->index)) {
+          ans[1] |= RADIOLIB_LORAWAN_FRAG_DELETE_NO_SESSION;
+        } else {
+          this->active = false;
+        }
+        ansLen = 2;
+      } break;
+
+      case(RADIOLIB_LORAWAN_FRAG_DATA_FRAGMENT): {
+        if(remLen < 2) {
+          return(RADIOLIB_ERR_DOWNLINK_MALFORMED);
+        }
+        // the fragment takes up the rest of the downlink
+        pos = lenDown;
+        uint16_t indexAndN = (uint16_t)req[0] | ((uint16_t)req[1] << 8);
+        if(!this->active || ((indexAndN >> 14) != this->index) || (remLen - 2 < this->fragSize)) {
+          break;
+        }
+        this->processFragment(indexAndN & 0x3FFF, &req[2]);
+      } break;
+
+      default:
+        // the length of an unknown command is unknown too, so the rest cannot be parsed
+        RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Unknown fragmentation command 0x%02x", cid);
+        return(RADIOLIB_ERR_INVALID_CID);
+    }
+
+    if(ansLen && (*lenUp + ansLen <= RADIOLIB_LORAWAN_FRAG_ANSWER_MAX_LEN)) {
+      memcpy(&dataUp[*lenUp], ans, ansLen);
+      *lenUp += ansLen;
+    }
+  }
+
+  return(RADIOLIB_ERR_NONE);
+}
+
+bool LoRaWANFragSession::isComplete() {
+  return(this->active && this->complete);
+}
+
+size_t LoRaWANFragSession::getFileSize() {
+  if(!this->active) {
+    return(0);
+  }
+  return((size_t)this->nbFrag*this->fragSize - this->padding);
+}
+
+uint32_t LoRaWANFragSession::getDescriptor() {
+  return(this->descriptor);
+}
+
+uint16_t LoRaWANFragSession::getMissing() {
+  if(this->complete) {
+    return(0);
+  }
+  if(this->decoding && !this->memoryError) {
+    return(this->nbMissing - this->rank);
+  }
+  return(this->nbFrag - this->nbUncoded);
+}
+
+RadioLibTime_t LoRaWANFragSession::getAnswerDelayMax() {
+  return((1UL << (this->ackDelay + 4)) * 1000UL);
+}
+
+void LoRaWANFragSession::setup(const uint8_t* req, uint8_t* status) {
+  uint8_t idx = (req[0] >> 4) & 0x03;
+  uint16_t nb = (uint16_t)req[1] | ((uint16_t)req[2] << 8);
+  uint8_t size = req[3];
+  uint8_t control = req[4];
+
+  *status = idx << 6;
+  if(((control >> 3) & 0x07) != RADIOLIB_LORAWAN_FRAG_ALGO_PARITY) {
+    *status |= RADIOLIB_LORAWAN_FRAG_SETUP_ENCODING_UNSUPPORTED;
+  }
+  if((nb == 0) || (size == 0) || (RADIOLIB_LORAWAN_FRAG_BUFFER_SIZE(nb, size) > this->bufferSize)) {
+    *status |= RADIOLIB_LORAWAN_FRAG_SETUP_NOT_ENOUGH_MEMORY;
+  }
+  // only one session at a time, the server has to delete it before using another index
+  if(this->active && (idx != this->index)) {
+    *status |= RADIOLIB_LORAWAN_FRAG_SETUP_INDEX_UNSUPPORTED;
+  }
+  if(*status & 0x0F) {
+    return;
+  }
+
+  this->index = idx;
+  this->groups = req[0] & 0x0F;
+  this->nbFrag = nb;
+  this->fragSize = size;
+  this->ackDelay = control & 0x07;
+  this->padding = req[5];
+  this->descriptor = (uint32_t)req[6] | ((uint32_t)req[7] << 8) | ((uint32_t)req[8] << 16) | ((uint32_t)req[9] << 24);
+  this->reset();
+  this->active = true;
+  RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Fragmentation session %d: %d fragments of %d bytes", idx, nb, size);
+}
+
+void LoRaWANFragSession::reset() {
+  this->complete = false;
+  this->nbReceived = 0;
+  this->nbUncoded = 0;
+  this->decoding = false;
+  this->memoryError = false;
+  this->nbMissing = 0;
+  this->rank = 0;
+  memset(this->receivedMap(), 0, (this->nbFrag + 7) / 8);
+}
+
+void LoRaWANFragSession::processFragment(uint16_t n, const uint8_t* data) {
+  if(this->complete || (n == 0)) {
+    return;
+  }
+  this->nbReceived++;
+
+  uint8_t row[RADIOLIB_LORAWAN_FRAG_MAX_MISSING / 8] = { 0 };
+  uint8_t tmp[255];
+
+  // uncoded fragment
+  if(n <= this->nbFrag) {
+    uint16_t frag = n - 1;
+    if(!this->decoding || this->memoryError) {
+      if(getBit(this->receivedMap(), frag)) {
+        return;
+      }
+      memcpy(this->fragment(frag), data, this->fragSize);
+      setBit(this->receivedMap(), frag);
+      this->nbUncoded++;
+      if(this->nbUncoded == this->nbFrag) {
+        this->complete = true;
+      }
+      return;
+    }
+
+    // decoding has started, so this is a row with a single coefficient
+    int16_t col = this->findMissing(frag);
+    if(col < 0) {
+      return;
+    }
+    setBit(row, col);
+    memcpy(tmp, data, this->fragSize);
+    this->addRow(row, tmp);
+    return;
+  }
+
+  // coded fragment, the set of missing fragments is fixed from now on
+  if(!this->decoding) {
+    this->startDecoding();
+  }
+  if(this->complete || this->memoryError) {
+    return;
+  }
+
+  // remove the fragments that are already known, what is left is an equation over the missing ones
+  this->parityLine(n - this->nbFrag);
+  const uint8_t* line = this->lineMap();
+  memcpy(tmp, data, this->fragSize);
+  for(uint16_t i = 0; i < this->nbFrag; i++) {
+    if(!getBit(line, i)) {
+      continue;
+    }
+    if(getBit(this->receivedMap(), i)) {
+      const uint8_t* known = this->fragment(i);
+      for(uint8_t j = 0; j < this->fragSize; j++) {
+        tmp[j] ^= known[j];
+      }
+    } else {
+      setBit(row, this->findMissing(i));
+    }
+  }
+  this->addRow(row, tmp);
+}
+
+void LoRaWANFragSession::startDecoding() {
+  this->decoding = true;
+  this->nbMissing = 0;
+  this->rank = 0;
+  memset(this->rows, 0, sizeof(this->rows));
+  for(uint16_t i = 0; i < this->nbFrag; i++) {
+    if(getBit(this->receivedMap(), i)) {
+      continue;
+    }
+    if(this->nbMissing == RADIOLIB_LORAWAN_FRAG_MAX_MISSING) {
+      RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Too many fragments missing to decode");
+      this->memoryError = true;
+      return;
+    }
+    this->missingIdx[this->nbMissing++] = i;
+  }
+  if(this->nbMissing == 0) {
+    this->complete = true;
+  }
+}
+
+void LoRaWANFragSession::addRow(uint8_t* row, uint8_t* data) {
+  // incremental Gaussian elimination over GF(2): the row with its lowest coefficient at p is stored as rows[p],
+  // its data goes to the (otherwise empty) buffer slot of the missing fragment p until the file is solved
+  for(uint16_t p = 0; p < this->nbMissing; p++) {
+    if(!getBit(row, p)) {
+      continue;
+    }
+
+    uint8_t* pivotData = this->fragment(this->missingIdx[p]);
+    if(!getBit(this->rows[p], p)) {
+      memcpy(this->rows[p], row, sizeof(this->rows[p]));
+      memcpy(pivotData, data, this->fragSize);
+      this->rank++;
+      if(this->rank == this->nbMissing) {
+        this->finishDecoding();
+      }
+      return;
+    }
+
+    for(uint8_t j = p / 8; j < sizeof(this->rows[p]); j++) {
+      row[j] ^= this->rows[p][j];
+    }
+    for(uint8_t j = 0; j < this->fragSize; j++) {
+      data[j] ^= pivotData[j];
+    }
+  }
+
+  // the row was a combination of the previous ones, it carried no new information
+}
+
+void LoRaWANFragSession::finishDecoding() {
+  // back substitution, every row only has coefficients at or above its pivot
+  for(uint16_t p = this->nbMissing; p-- > 0;) {
+    uint8_t* pivotData = this->fragment(this->missingIdx[p]);
+    for(uint16_t q = p + 1; q < this->nbMissing; q++) {
+      if(!getBit(this->rows[p], q)) {
+        continue;
+      }
+      const uint8_t* solved = this->fragment(this->missingIdx[q]);
+      for(uint8_t j = 0; j < this->fragSize; j++) {
+        pivotData[j] ^= solved[j];
+      }
+    }
+    setBit(this->receivedMap(), this->missingIdx[p]);
+  }
+  this->complete = true;
+  RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Recovered %d fragments", this->nbMissing);
+}
+
+int16_t LoRaWANFragSession::findMissing(uint16_t frag) {
+  // missing fragments are stored in ascending order
+  int16_t lo = 0;
+  int16_t hi = (int16_t)this->nbMissing - 1;
+  while(lo <= hi) {
+    int16_t mid = (lo + hi) / 2;
+    if(this->missingIdx[mid] == frag) {
+      return(mid);
+    } else if(this->missingIdx[mid] < frag) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return(-1);
+}
+
+uint8_t* LoRaWANFragSession::fragment(uint16_t frag) {
+  return(&this->buffer[(size_t)frag*this->fragSize]);
+}
+
+uint8_t* LoRaWANFragSession::receivedMap() {
+  return(&this->buffer[(size_t)this->nbFrag*this->fragSize]);
+}
+
+uint8_t* LoRaWANFragSession::lineMap() {
+  return(this->receivedMap() + (this->nbFrag + 7) / 8);
+}
+
+void LoRaWANFragSession::parityLine(uint16_t n) {
+  // generator of the parity matrix as specified in TS004, chapter 7
+  uint8_t* line = this->lineMap();
+  memset(line, 0, (this->nbFrag + 7) / 8);
+  uint32_t m = this->nbFrag;
+  uint32_t mod = m + (((m & (m - 1)) == 0) ? 1 : 0);
+  uint32_t x = 1 + 1001UL*n;
+  for(uint16_t i = 0; i < m / 2; i++) {
+    uint32_t r = m;
+    while(r >= m) {
+      x = LoRaWANFragSession::prbs23(x);
+      r = x % mod;
+    }
+    setBit(line, r);
+  }
+}
+
+uint32_t LoRaWANFragSession::prbs23(uint32_t x) {
+  uint32_t b0 = x & 0x01;
+  uint32_t b1 = (x & 0x20) >> 5;
+  return((x >> 1) + ((b0 ^ b1) << 22));
+}
+
+bool LoRaWANFragSession::getBit(const uint8_t* map, uint16_t bit) {
+  return(map[bit / 8] & (1 << (bit % 8)));
+}
+
+void LoRaWANFragSession::setBit(uint8_t* map, uint16_t bit) {
+  map[bit / 8] |= (1 << (bit % 8));
+}
+
+#endif
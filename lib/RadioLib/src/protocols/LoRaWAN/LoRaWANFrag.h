@@ -0,0 +1,141 @@
+#if !defined(_RADIOLIB_LORAWAN_FRAG_H) && !RADIOLIB_EXCLUDE_LORAWAN
+#define _RADIOLIB_LORAWAN_FRAG_H
+
+#include "../../TypeDef.h"
+
+// fPort used by the Fragmented Data Block Transport package (TS004)
+#define RADIOLIB_LORAWAN_FPORT_TS004                            (0xC9 << 0)
+
+// package identification
+#define RADIOLIB_LORAWAN_FRAG_PACKAGE_ID                        (0x03)
+#define RADIOLIB_LORAWAN_FRAG_PACKAGE_VERSION                   (0x01)
+
+// command IDs
+#define RADIOLIB_LORAWAN_FRAG_PACKAGE_VERSION_REQ               (0x00)
+#define RADIOLIB_LORAWAN_FRAG_SESSION_STATUS_REQ                (0x01)
+#define RADIOLIB_LORAWAN_FRAG_SESSION_SETUP_REQ                 (0x02)
+#define RADIOLIB_LORAWAN_FRAG_SESSION_DELETE_REQ                (0x03)
+#define RADIOLIB_LORAWAN_FRAG_DATA_FRAGMENT                     (0x08)
+
+// FragSessionSetupAns status bits                                              MSB   LSB   DESCRIPTION
+#define RADIOLIB_LORAWAN_FRAG_SETUP_ENCODING_UNSUPPORTED        (0x01 << 0) //  0     0     fragmentation algorithm not supported
+#define RADIOLIB_LORAWAN_FRAG_SETUP_NOT_ENOUGH_MEMORY           (0x01 << 1) //  1     1     file does not fit the buffer
+#define RADIOLIB_LORAWAN_FRAG_SETUP_INDEX_UNSUPPORTED           (0x01 << 2) //  2     2     another session index is active
+#define RADIOLIB_LORAWAN_FRAG_SETUP_WRONG_DESCRIPTOR            (0x01 << 3) //  3     3     descriptor rejected
+
+// FragSessionDeleteAns status bits
+#define RADIOLIB_LORAWAN_FRAG_DELETE_NO_SESSION                 (0x01 << 2) //  2     2     session does not exist
+
+// the only fragmentation algorithm defined by TS004: parity check based forward erasure code
+#define RADIOLIB_LORAWAN_FRAG_ALGO_PARITY                       (0x00)
+
+// buffer size needed for a file of NB fragments of SIZE bytes: the file itself and two bitmaps of NB bits
+#define RADIOLIB_LORAWAN_FRAG_BUFFER_SIZE(NB, SIZE)             ((size_t)(NB)*(SIZE) + 2*(((NB) + 7) / 8))
+
+/*!
+  \class LoRaWANFragSession
+  \brief Receiver of the LoRaWAN Fragmented Data Block Transport package (TS004 v1.0.0).
+  The file is sent as a number of uncoded fragments, followed by coded ones (XOR of half of the uncoded fragments).
+  Lost fragments are recovered from the coded ones, so the file can be rebuilt without any retransmission.
+  The session is independent of the radio: pass it every downlink on RADIOLIB_LORAWAN_FPORT_TS004
+  (unicast or multicast), and send any answer it produces as an uplink on the same port.
+*/
+class LoRaWANFragSession {
+  public:
+    /*!
+      \brief Default constructor.
+      \param buffer Buffer for the file. It must be at least RADIOLIB_LORAWAN_FRAG_BUFFER_SIZE(nbFrag, fragSize)
+      for the largest file to be received, the bytes past the file are used as bookkeeping.
+      \param size Size of the buffer in bytes.
+    */
+    LoRaWANFragSession(uint8_t* buffer, size_t size);
+
+    /*!
+      \brief Process a downlink of the fragmentation package. It may contain several commands.
+      \param dataDown Downlink payload.
+      \param lenDown Length of the downlink payload.
+      \param dataUp Buffer for the answer, which should be sent as an uplink on RADIOLIB_LORAWAN_FPORT_TS004.
+      Up to 16 bytes long.
+      \param lenUp Length of the answer, 0 if nothing needs to be sent.
+      \returns \ref status_codes
+    */
+    int16_t handle(const uint8_t* dataDown, size_t lenDown, uint8_t* dataUp, size_t* lenUp);
+
+    /*!
+      \brief Check whether the complete file was received (or rebuilt).
+      \returns True if the file in the buffer is complete.
+    */
+    bool isComplete();
+
+    /*!
+      \brief Get the size of the file, without padding.
+      \returns File size in bytes, 0 if no session was set up.
+    */
+    size_t getFileSize();
+
+    /*!
+      \brief Get the application-specific file descriptor sent with the session setup.
+      \returns 4-byte descriptor.
+    */
+    uint32_t getDescriptor();
+
+    /*!
+      \brief Get the number of fragments still needed to rebuild the file.
+      \returns Number of fragments; this is only exact once coded fragments are being received.
+    */
+    uint16_t getMissing();
+
+    /*!
+      \brief Status answers to multicast requests should be delayed by a random time to avoid
+      all devices answering at once. This returns the upper limit of that delay.
+      \returns Maximum delay in milliseconds.
+    */
+    RadioLibTime_t getAnswerDelayMax();
+
+#if !RADIOLIB_GODMODE
+  private:
+#endif
+    uint8_t* buffer;
+    size_t bufferSize;
+
+    // session parameters
+    bool active = false;
+    uint8_t index = 0;
+    uint8_t groups = 0;
+    uint16_t nbFrag = 0;
+    uint8_t fragSize = 0;
+    uint8_t padding = 0;
+    uint8_t ackDelay = 0;
+    uint32_t descriptor = 0;
+
+    // reception state
+    bool complete = false;
+    uint16_t nbReceived = 0;
+    uint16_t nbUncoded = 0;
+
+    // decoder state, used once coded fragments arrive
+    bool decoding = false;
+    bool memoryError = false;
+    uint16_t nbMissing = 0;
+    uint16_t rank = 0;
+    uint16_t missingIdx[RADIOLIB_LORAWAN_FRAG_MAX_MISSING];
+    uint8_t rows[RADIOLIB_LORAWAN_FRAG_MAX_MISSING][RADIOLIB_LORAWAN_FRAG_MAX_MISSING / 8];
+
+    void setup(const uint8_t* req, uint8_t* status);
+    void reset();
+    void processFragment(uint16_t n, const uint8_t* data);
+    void startDecoding();
+    void addRow(uint8_t* row, uint8_t* data);
+    void finishDecoding();
+    int16_t findMissing(uint16_t frag);
+    uint8_t* fragment(uint16_t frag);
+    uint8_t* receivedMap();
+    uint8_t* lineMap();
+    void parityLine(uint16_t n);
+
+    static uint32_t prbs23(uint32_t x);
+    static bool getBit(const uint8_t* map, uint16_t bit);
+    static void setBit(uint8_t* map, uint16_t bit);
+};
+
+#endif
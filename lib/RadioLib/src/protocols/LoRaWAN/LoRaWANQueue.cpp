@@ -0,0 +1,206 @@
+#include "LoRaWANQueue.h"
+#include <string.h>
+
+#if !RADIOLIB_EXCLUDE_LORAWAN
+
+LoRaWANUplinkQueue::LoRaWANUplinkQueue(LoRaWANNode* node) {
+  this->node = node;
+}
+
+int16_t LoRaWANUplinkQueue::enqueue(const uint8_t* data, size_t len, uint8_t fPort, uint8_t priority, RadioLibTime_t maxDelay) {
+  if(!data) {
+    return(RADIOLIB_ERR_NULL_POINTER);
+  }
+  if((len == 0) || (len > RADIOLIB_LORAWAN_QUEUE_RECORD_MAX_LEN)) {
+    return(RADIOLIB_ERR_PACKET_TOO_LONG);
+  }
+  if((fPort == 0) || (fPort > RADIOLIB_LORAWAN_FPORT_PAYLOAD_MAX)) {
+    return(RADIOLIB_ERR_INVALID_PORT);
+  }
+  if((this->numRecords >= RADIOLIB_LORAWAN_UPLINK_QUEUE_RECORDS) || (this->bufferLen + len > RADIOLIB_LORAWAN_UPLINK_QUEUE_SIZE)) {
+    return(RADIOLIB_ERR_UPLINK_QUEUE_FULL);
+  }
+
+  // the deadline saturates instead of wrapping around
+  RadioLibTime_t now = this->millis();
+  LoRaWANUplinkRecord_t* rec = &this->records[this->numRecords];
+  rec->deadline = (maxDelay > RADIOLIB_LORAWAN_QUEUE_IDLE - now) ? RADIOLIB_LORAWAN_QUEUE_IDLE : now + maxDelay;
+  rec->offset = this->bufferLen;
+  rec->len = len;
+  rec->fPort = fPort;
+  rec->priority = priority;
+  memcpy(&this->buffer[this->bufferLen], data, len);
+  this->bufferLen += len;
+  this->numRecords++;
+  return(RADIOLIB_ERR_NONE);
+}
+
+int16_t LoRaWANUplinkQueue::process(uint8_t* dataDown, size_t* lenDown, LoRaWANEvent_t* eventUp, LoRaWANEvent_t* eventDown) {
+  if(this->numRecords == 0) {
+    return(RADIOLIB_ERR_UPLINK_QUEUE_EMPTY);
+  }
+
+  bool members[RADIOLIB_LORAWAN_UPLINK_QUEUE_RECORDS] = { false };
+  int16_t head = -1;
+  RadioLibTime_t wait = this->schedule(members, &head);
+  if(head < 0) {
+    return(RADIOLIB_ERR_PACKET_TOO_LONG);
+  }
+  if(wait > 0) {
+    return(RADIOLIB_ERR_UPLINK_UNAVAILABLE);
+  }
+
+  // concatenate the records in the order they were queued in
+  uint8_t frame[RADIOLIB_LORAWAN_QUEUE_RECORD_MAX_LEN];
+  size_t len = 0;
+  for(size_t i = 0; i < this->numRecords; i++) {
+    if(members[i]) {
+      memcpy(&frame[len], &this->buffer[this->records[i].offset], this->records[i].len);
+      len += this->records[i].len;
+    }
+  }
+  RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Uplink queue: sending %d bytes on FPort %d", (int)len, this->records[head].fPort);
+
+  // the records are gone once the uplink went out, even if the downlink failed afterwards
+  uint32_t fCntUp = this->node->fCntUp;
+  int16_t state = RADIOLIB_ERR_NONE;
+  if(dataDown && lenDown) {
+    state = this->node->sendReceive(frame, len, this->records[head].fPort, dataDown, lenDown, false, eventUp, eventDown);
+  } else {
+    state = this->node->sendReceive(frame, len, this->records[head].fPort, false, eventUp, eventDown);
+  }
+  if(this->node->fCntUp != fCntUp) {
+    this->remove(members);
+  }
+  return(state);
+}
+
+RadioLibTime_t LoRaWANUplinkQueue::timeUntilUplink() {
+  if(this->numRecords == 0) {
+    return(RADIOLIB_LORAWAN_QUEUE_IDLE);
+  }
+
+  bool members[RADIOLIB_LORAWAN_UPLINK_QUEUE_RECORDS] = { false };
+  int16_t head = -1;
+  return(this->schedule(members, &head));
+}
+
+size_t LoRaWANUplinkQueue::getPending() {
+  return(this->numRecords);
+}
+
+void LoRaWANUplinkQueue::clear() {
+  this->numRecords = 0;
+  this->bufferLen = 0;
+}
+
+RadioLibTime_t LoRaWANUplinkQueue::schedule(bool* members, int16_t* head) {
+  RadioLibTime_t now = this->millis();
+  uint8_t maxLen = this->node->getMaxPayloadLen();
+
+  bool due = false;
+  *head = this->selectHead(now, maxLen, &due);
+  if(*head < 0) {
+    return(0);
+  }
+
+  // fill the frame with records for the same port, in the order they would be sent on their own
+  members[*head] = true;
+  size_t len = this->records[*head].len;
+  bool full = (len == maxLen);
+  bool considered[RADIOLIB_LORAWAN_UPLINK_QUEUE_RECORDS] = { false };
+  considered[*head] = true;
+  while(true) {
+    int16_t next = -1;
+    for(size_t i = 0; i < this->numRecords; i++) {
+      if(!considered[i] && (this->records[i].fPort == this->records[*head].fPort) && ((next < 0) || this->isBefore(i, next))) {
+        next = i;
+      }
+    }
+    if(next < 0) {
+      break;
+    }
+    considered[next] = true;
+    if(len + this->records[next].len <= maxLen) {
+      members[next] = true;
+      len += this->records[next].len;
+    } else {
+      full = true;
+    }
+  }
+
+  // a partial frame waits for more records until the earliest deadline
+  RadioLibTime_t wait = 0;
+  if(!due && !full) {
+    RadioLibTime_t deadline = RADIOLIB_LORAWAN_QUEUE_IDLE;
+    for(size_t i = 0; i < this->numRecords; i++) {
+      if((this->records[i].len <= maxLen) && (this->records[i].deadline < deadline)) {
+        deadline = this->records[i].deadline;
+      }
+    }
+    wait = deadline - now;
+  }
+
+  // either way, the duty cycle has the last word
+  RadioLibTime_t legal = this->node->timeUntilUplink();
+  return(RADIOLIB_MAX(wait, legal));
+}
+
+int16_t LoRaWANUplinkQueue::selectHead(RadioLibTime_t now, uint8_t maxLen, bool* due) {
+  // records that are due go first, otherwise the frame starts with the most urgent record
+  int16_t head = -1;
+  for(uint8_t pass = 0; (pass < 2) && (head < 0); pass++) {
+    for(size_t i = 0; i < this->numRecords; i++) {
+      if(this->records[i].len > maxLen) {
+        continue;
+      }
+      if((pass == 0) && (this->records[i].deadline > now)) {
+        continue;
+      }
+      if((head < 0) || this->isBefore(i, head)) {
+        head = i;
+      }
+    }
+    *due = (pass == 0);
+  }
+  return(head);
+}
+
+bool LoRaWANUplinkQueue::isBefore(size_t a, size_t b) {
+  // higher priority first, then the earlier deadline, then the order of queueing
+  if(this->records[a].priority != this->records[b].priority) {
+    return(this->records[a].priority > this->records[b].priority);
+  }
+  if(this->records[a].deadline != this->records[b].deadline) {
+    return(this->records[a].deadline < this->records[b].deadline);
+  }
+  return(a < b);
+}
+
+void LoRaWANUplinkQueue::remove(const bool* members) {
+  // go backwards, so that removing a record does not move the ones still to be checked
+  for(size_t i = this->numRecords; i-- > 0;) {
+    if(!members[i]) {
+      continue;
+    }
+
+    uint16_t offset = this->records[i].offset;
+    uint8_t len = this->records[i].len;
+    memmove(&this->buffer[offset], &this->buffer[offset + len], this->bufferLen - offset - len);
+    this->bufferLen -= len;
+    for(size_t j = 0; j < this->numRecords; j++) {
+      if(this->records[j].offset > offset) {
+        this->records[j].offset -= len;
+      }
+    }
+
+    memmove(&this->records[i], &this->records[i + 1], (this->numRecords - i - 1) * sizeof(LoRaWANUplinkRecord_t));
+    this->numRecords--;
+  }
+}
+
+RadioLibTime_t LoRaWANUplinkQueue::millis() {
+  return(this->node->phyLayer->getMod()->hal->millis());
+}
+
+#endif
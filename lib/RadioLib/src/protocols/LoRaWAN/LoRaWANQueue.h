@@ -0,0 +1,111 @@
+#if !defined(_RADIOLIB_LORAWAN_QUEUE_H) && !RADIOLIB_EXCLUDE_LORAWAN
+#define _RADIOLIB_LORAWAN_QUEUE_H
+
+#include "../../TypeDef.h"
+#include "LoRaWAN.h"
+
+// returned by LoRaWANUplinkQueue::timeUntilUplink() when there is nothing to send
+#define RADIOLIB_LORAWAN_QUEUE_IDLE                             ((RadioLibTime_t)-1)
+
+// the largest application payload of any LoRaWAN datarate
+#define RADIOLIB_LORAWAN_QUEUE_RECORD_MAX_LEN                   (222)
+
+/*!
+  \struct LoRaWANUplinkRecord_t
+  \brief A single application record waiting in LoRaWANUplinkQueue.
+*/
+struct LoRaWANUplinkRecord_t {
+  /*! \brief Time (in milliseconds, HAL clock) by which the record should be sent */
+  RadioLibTime_t deadline;
+
+  /*! \brief Position of the data in the queue buffer */
+  uint16_t offset;
+
+  /*! \brief Length of the data */
+  uint8_t len;
+
+  /*! \brief FPort the record is sent on */
+  uint8_t fPort;
+
+  /*! \brief Priority, higher is sent first */
+  uint8_t priority;
+};
+
+/*!
+  \class LoRaWANUplinkQueue
+  \brief Queue of small application records that are packed into as few uplinks as possible.
+  Records for the same FPort are concatenated into one frame, up to the maximum payload length
+  at the current datarate (including dwell time limits). The records themselves are not framed,
+  so they should be self-delimiting (e.g. Cayenne LPP, or type-length-value).
+  A frame is sent once one of its records reaches its deadline, or once the frame is full,
+  but never before the duty cycle allows the next uplink.
+*/
+class LoRaWANUplinkQueue {
+  public:
+    /*!
+      \brief Default constructor.
+      \param node The node to send the frames with. It must be activated before calling process().
+    */
+    explicit LoRaWANUplinkQueue(LoRaWANNode* node);
+
+    /*!
+      \brief Add a record to the queue.
+      \param data Record data.
+      \param len Length of the record, at most RADIOLIB_LORAWAN_QUEUE_RECORD_MAX_LEN bytes.
+      \param fPort FPort to send the record on.
+      \param priority Records of higher priority are sent first (default 0).
+      \param maxDelay How long the record may wait for other records to share the frame, in milliseconds.
+      0 (default) means it is sent as soon as the duty cycle allows.
+      \returns \ref status_codes
+    */
+    int16_t enqueue(const uint8_t* data, size_t len, uint8_t fPort = 1, uint8_t priority = 0, RadioLibTime_t maxDelay = 0);
+
+    /*!
+      \brief Send the next frame, if one is due and the duty cycle allows it. This does not wait:
+      use timeUntilUplink() to find out when to call it again (e.g. to sleep until then).
+      \param dataDown Buffer for a downlink payload, may be NULL.
+      \param lenDown Length of the downlink payload, may be NULL.
+      \param eventUp Information about the uplink, may be NULL.
+      \param eventDown Information about a downlink, may be NULL.
+      \returns The result of LoRaWANNode::sendReceive() if a frame was sent (Rx window, or an error),
+      RADIOLIB_ERR_UPLINK_QUEUE_EMPTY if the queue is empty, RADIOLIB_ERR_UPLINK_UNAVAILABLE if no frame
+      is due yet or the duty cycle does not allow an uplink, or RADIOLIB_ERR_PACKET_TOO_LONG if no record
+      fits into an uplink at the current datarate.
+    */
+    int16_t process(uint8_t* dataDown = NULL, size_t* lenDown = NULL, LoRaWANEvent_t* eventUp = NULL, LoRaWANEvent_t* eventDown = NULL);
+
+    /*!
+      \brief Get the time until process() will send the next frame.
+      \returns Time in milliseconds; 0 if a frame can be sent now, RADIOLIB_LORAWAN_QUEUE_IDLE if the queue is empty.
+    */
+    RadioLibTime_t timeUntilUplink();
+
+    /*!
+      \brief Get the number of queued records.
+      \returns Number of records.
+    */
+    size_t getPending();
+
+    /*!
+      \brief Remove all records from the queue.
+    */
+    void clear();
+
+#if !RADIOLIB_GODMODE
+  private:
+#endif
+    LoRaWANNode* node;
+
+    uint8_t buffer[RADIOLIB_LORAWAN_UPLINK_QUEUE_SIZE] = { 0 };
+    size_t bufferLen = 0;
+    LoRaWANUplinkRecord_t records[RADIOLIB_LORAWAN_UPLINK_QUEUE_RECORDS];
+    size_t numRecords = 0;
+
+    RadioLibTime_t schedule(bool* members, int16_t* head);
+    int16_t selectHead(RadioLibTime_t now, uint8_t maxLen, bool* due);
+    bool isBefore(size_t a, size_t b);
+    void remove(const bool* members);
+    RadioLibTime_t millis();
+};
+
+#endif
@@ -0,0 +1,430 @@
+#include "LoRaWANStore.h"
+#include "../../utils/CRC.h"
+#include <string.h>
+
+#if !RADIOLIB_EXCLUDE_LORAWAN
+
+LoRaWANStorage::LoRaWANStorage(size_t sectorSize, uint8_t numSectors, uint8_t writeAlign)
+  : sectorSize(sectorSize), numSectors(numSectors), writeAlign(writeAlign) {
+
+}
+
+LoRaWANSessionStore::LoRaWANSessionStore(LoRaWANStorage* storage) {
+  this->storage = storage;
+}
+
+int16_t LoRaWANSessionStore::restore(LoRaWANNode* node) {
+  if(!node) {
+    return(RADIOLIB_ERR_NULL_POINTER);
+  }
+
+  int16_t state = this->scan();
+  RADIOLIB_ASSERT(state);
+
+  state = node->setBufferNonces(this->image);
+  RADIOLIB_ASSERT(state);
+
+  return(node->setBufferSession(&this->image[RADIOLIB_LORAWAN_NONCES_BUF_SIZE]));
+}
+
+int16_t LoRaWANSessionStore::save(LoRaWANNode* node) {
+  if(!node) {
+    return(RADIOLIB_ERR_NULL_POINTER);
+  }
+
+  // find the end of the journal if restore() was not called
+  int16_t state = RADIOLIB_ERR_NONE;
+  if(!this->scanned) {
+    state = this->scan();
+    if((state != RADIOLIB_ERR_NONE) && (state != RADIOLIB_ERR_STORE_EMPTY)) {
+      return(state);
+    }
+  }
+
+  const uint8_t* nonces = node->getBufferNonces();
+  const uint8_t* session = node->getBufferSession();
+  if(this->needsCompaction || !this->imageValid) {
+    return(this->compact(nonces, session));
+  }
+
+  // only the changed bytes are appended; if that is as large as the whole image, start over with a snapshot
+  uint8_t record[RADIOLIB_LORAWAN_STORE_RECORD_MAX];
+  size_t len = this->buildPatch(nonces, session, record);
+  if(len == 0) {
+    return(RADIOLIB_ERR_NONE);
+  }
+  if(len >= RADIOLIB_LORAWAN_STORE_IMAGE_SIZE) {
+    return(this->compact(nonces, session));
+  }
+
+  len = this->finishRecord(record, RADIOLIB_LORAWAN_STORE_RECORD_PATCH, len);
+  if(this->offset + this->alignUp(len) > this->storage->sectorSize) {
+    return(this->compact(nonces, session));
+  }
+
+  state = this->program(this->sectorAddr(this->sector) + this->offset, record, len);
+  if(state != RADIOLIB_ERR_NONE) {
+    // the tail of this sector is unusable now, the snapshot in the next sector supersedes it
+    RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Session store: append failed (%d), compacting", state);
+    this->needsCompaction = true;
+    return(this->compact(nonces, session));
+  }
+  this->offset += this->alignUp(len);
+
+  memcpy(this->image, nonces, RADIOLIB_LORAWAN_NONCES_BUF_SIZE);
+  memcpy(&this->image[RADIOLIB_LORAWAN_NONCES_BUF_SIZE], session, RADIOLIB_LORAWAN_SESSION_BUF_SIZE);
+  return(RADIOLIB_ERR_NONE);
+}
+
+int16_t LoRaWANSessionStore::clear() {
+  for(uint8_t i = 0; i < this->storage->numSectors; i++) {
+    int16_t state = this->storage->erase(i);
+    RADIOLIB_ASSERT(state);
+  }
+
+  this->imageValid = false;
+  this->needsCompaction = true;
+  this->sector = this->storage->numSectors - 1;
+  this->sequence = 0;
+  this->offset = 0;
+  this->scanned = true;
+  return(RADIOLIB_ERR_NONE);
+}
+
+int16_t LoRaWANSessionStore::scan() {
+  if(!this->storage) {
+    return(RADIOLIB_ERR_NULL_POINTER);
+  }
+
+  // check the storage can hold the journal at all
+  uint8_t align = this->storage->writeAlign;
+  if((this->storage->numSectors < 2) || (align == 0) || (align > RADIOLIB_LORAWAN_STORE_ALIGN_MAX) || (align & (align - 1)) ||
+     (this->alignUp(RADIOLIB_LORAWAN_STORE_HEADER_LEN) + this->alignUp(RADIOLIB_LORAWAN_STORE_RECORD_MAX) > this->storage->sectorSize)) {
+    RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Session store: unsuitable storage");
+    return(RADIOLIB_ERR_STORE_FAILED);
+  }
+
+  this->scanned = true;
+  this->imageValid = false;
+  this->needsCompaction = true;
+  this->sector = this->storage->numSectors - 1;
+  this->sequence = 0;
+  this->offset = 0;
+
+  // the highest sequence number seen in any header, new sectors must be numbered above it
+  uint32_t seqMax = 0;
+  for(uint8_t i = 0; i < this->storage->numSectors; i++) {
+    uint32_t seq = 0;
+    if((this->readHeader(i, &seq) == RADIOLIB_ERR_NONE) && (seq > seqMax)) {
+      seqMax = seq;
+    }
+  }
+  this->sequence = seqMax;
+
+  // replay the newest sector; should its snapshot be damaged, fall back to older sectors
+  uint32_t seqBelow = 0xFFFFFFFF;
+  for(uint8_t attempt = 0; attempt < this->storage->numSectors; attempt++) {
+    int16_t newest = -1;
+    uint32_t seqNewest = 0;
+    for(uint8_t i = 0; i < this->storage->numSectors; i++) {
+      uint32_t seq = 0;
+      if((this->readHeader(i, &seq) == RADIOLIB_ERR_NONE) && (seq < seqBelow) && ((newest < 0) || (seq > seqNewest))) {
+        newest = i;
+        seqNewest = seq;
+      }
+    }
+    if(newest < 0) {
+      break;
+    }
+    seqBelow = seqNewest;
+
+    if(this->replay((uint8_t)newest) == RADIOLIB_ERR_NONE) {
+      RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Session store: sector %d (sequence %lu), offset %lu", newest, (unsigned long)seqNewest, (unsigned long)this->offset);
+      return(RADIOLIB_ERR_NONE);
+    }
+    RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Session store: sector %d has no valid snapshot", newest);
+  }
+
+  return(RADIOLIB_ERR_STORE_EMPTY);
+}
+
+int16_t LoRaWANSessionStore::replay(uint8_t sct) {
+  uint32_t addr = this->sectorAddr(sct);
+  uint32_t end = addr + this->storage->sectorSize;
+  uint32_t pos = addr + this->alignUp(RADIOLIB_LORAWAN_STORE_HEADER_LEN);
+
+  // every sector starts with a snapshot
+  uint8_t record[RADIOLIB_LORAWAN_STORE_RECORD_MAX];
+  size_t len = 0;
+  int16_t state = this->readRecord(pos, end, record, &len);
+  if((state != RADIOLIB_ERR_NONE) || (record[0] != RADIOLIB_LORAWAN_STORE_RECORD_SNAPSHOT) || (len != RADIOLIB_LORAWAN_STORE_IMAGE_SIZE)) {
+    return(RADIOLIB_ERR_STORE_EMPTY);
+  }
+  memcpy(this->image, &record[3], RADIOLIB_LORAWAN_STORE_IMAGE_SIZE);
+  pos += this->alignUp(len + RADIOLIB_LORAWAN_STORE_RECORD_OVERHEAD);
+
+  // apply the following records until the erased tail, or a damaged record (e.g. a write interrupted by reset)
+  bool damaged = false;
+  while(pos < end) {
+    state = this->readRecord(pos, end, record, &len);
+    if(state == RADIOLIB_ERR_STORE_EMPTY) {
+      break;
+    }
+
+    if(state == RADIOLIB_ERR_NONE) {
+      if(record[0] == RADIOLIB_LORAWAN_STORE_RECORD_SNAPSHOT) {
+        if(len == RADIOLIB_LORAWAN_STORE_IMAGE_SIZE) {
+          memcpy(this->image, &record[3], RADIOLIB_LORAWAN_STORE_IMAGE_SIZE);
+        } else {
+          damaged = true;
+        }
+      } else if(!this->applyPatch(&record[3], len)) {
+        damaged = true;
+      }
+    } else {
+      damaged = true;
+    }
+
+    if(damaged) {
+      RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Session store: damaged record at %lu", (unsigned long)pos);
+      break;
+    }
+    pos += this->alignUp(len + RADIOLIB_LORAWAN_STORE_RECORD_OVERHEAD);
+  }
+
+  this->sector = sct;
+  this->offset = pos - addr;
+  this->imageValid = true;
+
+  // appending is only safe to memory that was never written since the last erase
+  this->needsCompaction = damaged || !this->isErased(pos, end);
+  return(RADIOLIB_ERR_NONE);
+}
+
+int16_t LoRaWANSessionStore::compact(const uint8_t* nonces, const uint8_t* session) {
+  uint8_t next = (this->sector + 1) % this->storage->numSectors;
+  int16_t state = this->storage->erase(next);
+  RADIOLIB_ASSERT(state);
+
+  // write the snapshot first and the header last, so that an interrupted compaction leaves no valid sector behind
+  uint8_t record[RADIOLIB_LORAWAN_STORE_RECORD_MAX];
+  memcpy(&record[3], nonces, RADIOLIB_LORAWAN_NONCES_BUF_SIZE);
+  memcpy(&record[3 + RADIOLIB_LORAWAN_NONCES_BUF_SIZE], session, RADIOLIB_LORAWAN_SESSION_BUF_SIZE);
+  size_t len = this->finishRecord(record, RADIOLIB_LORAWAN_STORE_RECORD_SNAPSHOT, RADIOLIB_LORAWAN_STORE_IMAGE_SIZE);
+  uint32_t addr = this->sectorAddr(next);
+  size_t headerLen = this->alignUp(RADIOLIB_LORAWAN_STORE_HEADER_LEN);
+  state = this->program(addr + headerLen, record, len);
+  RADIOLIB_ASSERT(state);
+
+  uint32_t seq = this->sequence + 1;
+  uint8_t header[RADIOLIB_LORAWAN_STORE_HEADER_LEN];
+  for(uint8_t i = 0; i < 4; i++) {
+    header[i] = (uint8_t)(RADIOLIB_LORAWAN_STORE_MAGIC >> 8*i);
+    header[4 + i] = (uint8_t)(seq >> 8*i);
+  }
+  uint16_t crc16 = LoRaWANSessionStore::crc(header, 8);
+  header[8] = crc16 & 0xFF;
+  header[9] = (crc16 >> 8) & 0xFF;
+  state = this->program(addr, header, RADIOLIB_LORAWAN_STORE_HEADER_LEN);
+  RADIOLIB_ASSERT(state);
+
+  RADIOLIB_DEBUG_PROTOCOL_PRINTLN("Session store: snapshot to sector %d (sequence %lu)", next, (unsigned long)seq);
+  this->sector = next;
+  this->sequence = seq;
+  this->offset = headerLen + this->alignUp(len);
+  this->needsCompaction = false;
+  this->imageValid = true;
+  memcpy(this->image, &record[3], RADIOLIB_LORAWAN_STORE_IMAGE_SIZE);
+  return(RADIOLIB_ERR_NONE);
+}
+
+size_t LoRaWANSessionStore::buildPatch(const uint8_t* nonces, const uint8_t* session, uint8_t* record) {
+  uint8_t* payload = &record[3];
+  size_t len = 0;
+  size_t i = 0;
+  while(i < RADIOLIB_LORAWAN_STORE_IMAGE_SIZE) {
+    if(LoRaWANSessionStore::current(nonces, session, i) == this->image[i]) {
+      i++;
+      continue;
+    }
+
+    // extend the segment over short runs of unchanged bytes, these are cheaper than the header of a new segment
+    size_t start = i;
+    size_t end = i + 1;
+    for(size_t j = i + 1; (j < RADIOLIB_LORAWAN_STORE_IMAGE_SIZE) && (j - start < RADIOLIB_LORAWAN_STORE_SEGMENT_MAX_LEN); j++) {
+      if(LoRaWANSessionStore::current(nonces, session, j) != this->image[j]) {
+        end = j + 1;
+      } else if(j + 1 - end > RADIOLIB_LORAWAN_STORE_SEGMENT_OVERHEAD) {
+        break;
+      }
+    }
+
+    size_t segLen = end - start;
+    if(len + RADIOLIB_LORAWAN_STORE_SEGMENT_OVERHEAD + segLen >= RADIOLIB_LORAWAN_STORE_IMAGE_SIZE) {
+      return(RADIOLIB_LORAWAN_STORE_IMAGE_SIZE);
+    }
+    payload[len++] = start & 0xFF;
+    payload[len++] = (start >> 8) & 0xFF;
+    payload[len++] = (uint8_t)segLen;
+    for(size_t j = start; j < end; j++) {
+      payload[len++] = LoRaWANSessionStore::current(nonces, session, j);
+    }
+    i = end;
+  }
+  return(len);
+}
+
+bool LoRaWANSessionStore::applyPatch(const uint8_t* payload, size_t len) {
+  // check all segments before changing anything, a patch is applied completely or not at all
+  size_t pos = 0;
+  while(pos < len) {
+    if(pos + RADIOLIB_LORAWAN_STORE_SEGMENT_OVERHEAD > len) {
+      return(false);
+    }
+    size_t start = payload[pos] | ((size_t)payload[pos + 1] << 8);
+    size_t segLen = payload[pos + 2];
+    pos += RADIOLIB_LORAWAN_STORE_SEGMENT_OVERHEAD;
+    if((segLen == 0) || (start + segLen > RADIOLIB_LORAWAN_STORE_IMAGE_SIZE) || (pos + segLen > len)) {
+      return(false);
+    }
+    pos += segLen;
+  }
+
+  pos = 0;
+  while(pos < len) {
+    size_t start = payload[pos] | ((size_t)payload[pos + 1] << 8);
+    size_t segLen = payload[pos + 2];
+    pos += RADIOLIB_LORAWAN_STORE_SEGMENT_OVERHEAD;
+    memcpy(&this->image[start], &payload[pos], segLen);
+    pos += segLen;
+  }
+  return(true);
+}
+
+int16_t LoRaWANSessionStore::readHeader(uint8_t sct, uint32_t* seq) {
+  uint8_t header[RADIOLIB_LORAWAN_STORE_HEADER_LEN];
+  int16_t state = this->storage->read(this->sectorAddr(sct), header, RADIOLIB_LORAWAN_STORE_HEADER_LEN);
+  RADIOLIB_ASSERT(state);
+
+  uint32_t magic = 0;
+  *seq = 0;
+  for(uint8_t i = 0; i < 4; i++) {
+    magic |= (uint32_t)header[i] << 8*i;
+    *seq |= (uint32_t)header[4 + i] << 8*i;
+  }
+  uint16_t crc16 = header[8] | ((uint16_t)header[9] << 8);
+  if((magic != RADIOLIB_LORAWAN_STORE_MAGIC) || (crc16 != LoRaWANSessionStore::crc(header, 8))) {
+    return(RADIOLIB_ERR_STORE_EMPTY);
+  }
+  return(RADIOLIB_ERR_NONE);
+}
+
+int16_t LoRaWANSessionStore::readRecord(uint32_t addr, uint32_t end, uint8_t* record, size_t* len) {
+  if(addr + RADIOLIB_LORAWAN_STORE_RECORD_OVERHEAD > end) {
+    return(RADIOLIB_ERR_STORE_EMPTY);
+  }
+
+  int16_t state = this->storage->read(addr, record, 3);
+  RADIOLIB_ASSERT(state);
+  if(record[0] == RADIOLIB_LORAWAN_STORE_RECORD_ERASED) {
+    return(RADIOLIB_ERR_STORE_EMPTY);
+  }
+
+  *len = record[1] | ((size_t)record[2] << 8);
+  if(((record[0] != RADIOLIB_LORAWAN_STORE_RECORD_SNAPSHOT) && (record[0] != RADIOLIB_LORAWAN_STORE_RECORD_PATCH)) ||
+     (*len > RADIOLIB_LORAWAN_STORE_IMAGE_SIZE) || (addr + *len + RADIOLIB_LORAWAN_STORE_RECORD_OVERHEAD > end)) {
+    return(RADIOLIB_ERR_CHECKSUM_MISMATCH);
+  }
+
+  state = this->storage->read(addr + 3, &record[3], *len + 2);
+  RADIOLIB_ASSERT(state);
+  uint16_t crc16 = record[3 + *len] | ((uint16_t)record[4 + *len] << 8);
+  if(crc16 != LoRaWANSessionStore::crc(record, 3 + *len)) {
+    return(RADIOLIB_ERR_CHECKSUM_MISMATCH);
+  }
+  return(RADIOLIB_ERR_NONE);
+}
+
+int16_t LoRaWANSessionStore::program(uint32_t addr, const uint8_t* data, size_t len) {
+  // write the aligned part directly, and the rest padded with erased bytes
+  uint8_t align = this->storage->writeAlign;
+  size_t body = len & ~((size_t)align - 1);
+  int16_t state = RADIOLIB_ERR_NONE;
+  if(body > 0) {
+    state = this->storage->write(addr, data, body);
+    RADIOLIB_ASSERT(state);
+  }
+  if(body < len) {
+    uint8_t tail[RADIOLIB_LORAWAN_STORE_ALIGN_MAX];
+    memset(tail, 0xFF, align);
+    memcpy(tail, &data[body], len - body);
+    state = this->storage->write(addr + body, tail, align);
+    RADIOLIB_ASSERT(state);
+  }
+
+  // read back, so that a failed write is not left as the tail of the journal
+  uint8_t chunk[RADIOLIB_LORAWAN_STORE_ALIGN_MAX];
+  for(size_t pos = 0; pos < len; pos += sizeof(chunk)) {
+    size_t chunkLen = (len - pos < sizeof(chunk)) ? (len - pos) : sizeof(chunk);
+    state = this->storage->read(addr + pos, chunk, chunkLen);
+    RADIOLIB_ASSERT(state);
+    if(memcmp(chunk, &data[pos], chunkLen) != 0) {
+      return(RADIOLIB_ERR_STORE_FAILED);
+    }
+  }
+  return(RADIOLIB_ERR_NONE);
+}
+
+bool LoRaWANSessionStore::isErased(uint32_t addr, uint32_t end) {
+  uint8_t chunk[RADIOLIB_LORAWAN_STORE_ALIGN_MAX];
+  for(uint32_t pos = addr; pos < end; pos += sizeof(chunk)) {
+    size_t chunkLen = (end - pos < sizeof(chunk)) ? (end - pos) : sizeof(chunk);
+    if(this->storage->read(pos, chunk, chunkLen) != RADIOLIB_ERR_NONE) {
+      return(false);
+    }
+    for(size_t i = 0; i < chunkLen; i++) {
+      if(chunk[i] != 0xFF) {
+        return(false);
+      }
+    }
+  }
+  return(true);
+}
+
+size_t LoRaWANSessionStore::finishRecord(uint8_t* record, uint8_t type, size_t len) {
+  record[0] = type;
+  record[1] = len & 0xFF;
+  record[2] = (len >> 8) & 0xFF;
+  uint16_t crc16 = LoRaWANSessionStore::crc(record, 3 + len);
+  record[3 + len] = crc16 & 0xFF;
+  record[4 + len] = (crc16 >> 8) & 0xFF;
+  return(len + RADIOLIB_LORAWAN_STORE_RECORD_OVERHEAD);
+}
+
+size_t LoRaWANSessionStore::alignUp(size_t len) {
+  size_t align = this->storage->writeAlign;
+  return((len + align - 1) & ~(align - 1));
+}
+
+uint32_t LoRaWANSessionStore::sectorAddr(uint8_t sct) {
+  return((uint32_t)sct * this->storage->sectorSize);
+}
+
+uint8_t LoRaWANSessionStore::current(const uint8_t* nonces, const uint8_t* session, size_t i) {
+  if(i < RADIOLIB_LORAWAN_NONCES_BUF_SIZE) {
+    return(nonces[i]);
+  }
+  return(session[i - RADIOLIB_LORAWAN_NONCES_BUF_SIZE]);
+}
+
+uint16_t LoRaWANSessionStore::crc(const uint8_t* data, size_t len) {
+  RadioLibCRCInstance.size = 16;
+  RadioLibCRCInstance.poly = RADIOLIB_CRC_CCITT_POLY;
+  RadioLibCRCInstance.init = RADIOLIB_CRC_CCITT_INIT;
+  RadioLibCRCInstance.out = RADIOLIB_CRC_CCITT_OUT;
+  RadioLibCRCInstance.refIn = false;
+  RadioLibCRCInstance.refOut = false;
+  return((uint16_t)RadioLibCRCInstance.checksum(data, len));
+}
+
+#endif
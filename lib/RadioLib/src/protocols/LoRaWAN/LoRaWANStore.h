@@ -0,0 +1,170 @@
+#if !defined(_RADIOLIB_LORAWAN_STORE_H) && !RADIOLIB_EXCLUDE_LORAWAN
+#define _RADIOLIB_LORAWAN_STORE_H
+
+#include "../../TypeDef.h"
+#include "LoRaWAN.h"
+
+// sector header: magic, sequence number, CRC
+#define RADIOLIB_LORAWAN_STORE_MAGIC                            (0x31534C52UL)  // "RLS1"
+#define RADIOLIB_LORAWAN_STORE_HEADER_LEN                       (10)
+
+// record types, an erased byte marks the end of the journal
+#define RADIOLIB_LORAWAN_STORE_RECORD_SNAPSHOT                  (0x01)
+#define RADIOLIB_LORAWAN_STORE_RECORD_PATCH                     (0x02)
+#define RADIOLIB_LORAWAN_STORE_RECORD_ERASED                    (0xFF)
+
+// record: type (1 byte), payload length (2 bytes), payload, CRC (2 bytes)
+#define RADIOLIB_LORAWAN_STORE_RECORD_OVERHEAD                  (5)
+
+// patch segment: offset (2 bytes), length (1 byte), data
+#define RADIOLIB_LORAWAN_STORE_SEGMENT_OVERHEAD                 (3)
+#define RADIOLIB_LORAWAN_STORE_SEGMENT_MAX_LEN                  (0xFF)
+
+// the persisted image: Nonces buffer followed by the Session buffer
+#define RADIOLIB_LORAWAN_STORE_IMAGE_SIZE                       ((size_t)RADIOLIB_LORAWAN_NONCES_BUF_SIZE + (size_t)RADIOLIB_LORAWAN_SESSION_BUF_SIZE)
+#define RADIOLIB_LORAWAN_STORE_RECORD_MAX                       (RADIOLIB_LORAWAN_STORE_IMAGE_SIZE + RADIOLIB_LORAWAN_STORE_RECORD_OVERHEAD)
+
+// largest supported write granularity
+#define RADIOLIB_LORAWAN_STORE_ALIGN_MAX                        (16)
+
+/*!
+  \class LoRaWANStorage
+  \brief Non-volatile memory used by LoRaWANSessionStore, e.g. a flash partition.
+  It is split into equally sized sectors, each of which can be erased separately.
+  Erased memory must read as 0xFF, and erased bytes can be written once until the next erase.
+  Implementations must provide all the pure virtual methods.
+*/
+class LoRaWANStorage {
+  public:
+    /*!
+      \brief Size of one erasable sector in bytes.
+    */
+    const size_t sectorSize;
+
+    /*!
+      \brief Number of sectors, at least 2.
+    */
+    const uint8_t numSectors;
+
+    /*!
+      \brief Write granularity in bytes (power of 2, at most RADIOLIB_LORAWAN_STORE_ALIGN_MAX).
+      All writes start at a multiple of this and have a length that is a multiple of this.
+    */
+    const uint8_t writeAlign;
+
+    /*!
+      \brief Default constructor.
+      \param sectorSize Size of one erasable sector in bytes.
+      \param numSectors Number of sectors, at least 2.
+      \param writeAlign Write granularity in bytes (power of 2), defaults to 1.
+    */
+    LoRaWANStorage(size_t sectorSize, uint8_t numSectors, uint8_t writeAlign = 1);
+
+    /*!
+      \brief Virtual destructor.
+    */
+    virtual ~LoRaWANStorage() = default;
+
+    /*!
+      \brief Read from the storage.
+      \param addr Address relative to the start of the first sector.
+      \param data Buffer to read into.
+      \param len Number of bytes to read.
+      \returns \ref status_codes
+    */
+    virtual int16_t read(uint32_t addr, uint8_t* data, size_t len) = 0;
+
+    /*!
+      \brief Write to erased storage.
+      \param addr Address relative to the start of the first sector.
+      \param data Data to write.
+      \param len Number of bytes to write.
+      \returns \ref status_codes
+    */
+    virtual int16_t write(uint32_t addr, const uint8_t* data, size_t len) = 0;
+
+    /*!
+      \brief Erase a single sector.
+      \param sector Index of the sector.
+      \returns \ref status_codes
+    */
+    virtual int16_t erase(uint8_t sector) = 0;
+};
+
+/*!
+  \class LoRaWANSessionStore
+  \brief Journal of the LoRaWAN Nonces and Session buffers in wear-levelled non-volatile memory.
+  Every save only appends the bytes that changed since the previous one (usually the frame counters),
+  so saving after each uplink costs a few bytes instead of the complete buffers.
+  When a sector is full, a complete snapshot is written to the next sector of the ring,
+  which spreads erase cycles over all sectors. Restoring replays the newest sector.
+*/
+class LoRaWANSessionStore {
+  public:
+    /*!
+      \brief Default constructor.
+      \param storage Non-volatile memory to keep the journal in. Each sector must fit at least
+      a header and one snapshot (RADIOLIB_LORAWAN_STORE_RECORD_MAX bytes); the larger the sectors,
+      the fewer snapshots are written. A 4 kB sector holds several hundred uplinks.
+    */
+    explicit LoRaWANSessionStore(LoRaWANStorage* storage);
+
+    /*!
+      \brief Restore the newest saved state to a node. Call this after beginOTAA/beginABP
+      and before activating the node.
+      \param node The node to restore.
+      \returns \ref status_codes, RADIOLIB_ERR_STORE_EMPTY if nothing was saved yet,
+      otherwise the result of LoRaWANNode::setBufferNonces/setBufferSession.
+    */
+    int16_t restore(LoRaWANNode* node);
+
+    /*!
+      \brief Save the state of a node. Call this after every activation attempt and every uplink.
+      Only the bytes that changed since the last save or restore are written.
+      \param node The node to save.
+      \returns \ref status_codes
+    */
+    int16_t save(LoRaWANNode* node);
+
+    /*!
+      \brief Erase all stored state, e.g. to force a new join.
+      \returns \ref status_codes
+    */
+    int16_t clear();
+
+#if !RADIOLIB_GODMODE
+  private:
+#endif
+    LoRaWANStorage* storage;
+
+    // the image as it is stored at the moment
+    uint8_t image[RADIOLIB_LORAWAN_STORE_IMAGE_SIZE] = { 0 };
+    bool imageValid = false;
+
+    // position of the journal
+    uint8_t sector = 0;
+    uint32_t sequence = 0;
+    uint32_t offset = 0;
+
+    // set when the journal tail cannot be appended to, the next save starts a new sector
+    bool needsCompaction = true;
+    bool scanned = false;
+
+    int16_t scan();
+    int16_t replay(uint8_t sct);
+    int16_t compact(const uint8_t* nonces, const uint8_t* session);
+    size_t buildPatch(const uint8_t* nonces, const uint8_t* session, uint8_t* record);
+    bool applyPatch(const uint8_t* payload, size_t len);
+    int16_t readHeader(uint8_t sct, uint32_t* seq);
+    int16_t readRecord(uint32_t addr, uint32_t end, uint8_t* record, size_t* len);
+    int16_t program(uint32_t addr, const uint8_t* data, size_t len);
+    bool isErased(uint32_t addr, uint32_t end);
+
+    size_t finishRecord(uint8_t* record, uint8_t type, size_t len);
+    size_t alignUp(size_t len);
+    uint32_t sectorAddr(uint8_t sct);
+    static uint8_t current(const uint8_t* nonces, const uint8_t* session, size_t i);
+    static uint16_t crc(const uint8_t* data, size_t len);
+};
+
+#endif
@@ -727,6 +727,7 @@ class PhysicalLayer {
     friend class BellClient;
     friend class FT8Client;
     friend class LoRaWANNode;
+    friend class LoRaWANUplinkQueue;
     friend class M17Client;
 };
 
@@ -1,10 +1,29 @@
 #include "CRC.h"
 
+// shorter buffers are not worth building a new table for
+#define RADIOLIB_CRC_TABLE_MIN_LEN                              (32)
+
 RadioLibCRC::RadioLibCRC() {
 
 }
 
 uint32_t RadioLibCRC::checksum(const uint8_t* buff, size_t len) {
+  #if RADIOLIB_CRC_TABLE
+  // callers reconfigure the shared instance before each use,
+  // so the table is rebuilt only when the configuration actually changed
+  bool match = this->tableValid && (this->tableSize == this->size) &&
+               (this->tablePoly == this->poly) && (this->tableRefIn == this->refIn);
+  if((this->size >= 8) && (match || (len >= RADIOLIB_CRC_TABLE_MIN_LEN))) {
+    if(!match) {
+      buildTable();
+    }
+    return(checksumTable(buff, len));
+  }
+  #endif
+  return(checksumBitwise(buff, len));
+}
+
+uint32_t RadioLibCRC::checksumBitwise(const uint8_t* buff, size_t len) {
   uint32_t crc = this->init;
   size_t pos = 0;
   for(size_t i = 0; i < 8*len; i++) {
@@ -32,4 +51,71 @@ uint32_t RadioLibCRC::checksum(const uint8_t* buff, size_t len) {
   return(crc);
 }
 
+#if RADIOLIB_CRC_TABLE
+void RadioLibCRC::buildTable() {
+  uint32_t mask = (uint32_t)0xFFFFFFFF >> (32 - this->size);
+  if(this->refIn) {
+    // reflected input is the same as running the whole register mirrored,
+    // least significant bit first, with the polynomial mirrored as well
+    uint32_t poly = rlb_reflect(this->poly, this->size);
+    for(uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for(uint8_t b = 0; b < 8; b++) {
+        crc = (crc & 1) ? ((crc >> 1) ^ poly) : (crc >> 1);
+      }
+      this->table[i] = crc;
+    }
+  } else {
+    uint32_t top = (uint32_t)1 << (this->size - 1);
+    for(uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i << (this->size - 8);
+      for(uint8_t b = 0; b < 8; b++) {
+        crc = (crc & top) ? ((crc << 1) ^ this->poly) : (crc << 1);
+      }
+      this->table[i] = crc & mask;
+    }
+  }
+
+  this->tableSize = this->size;
+  this->tablePoly = this->poly;
+  this->tableRefIn = this->refIn;
+  this->tableValid = true;
+}
+
+uint32_t RadioLibCRC::checksumTable(const uint8_t* buff, size_t len) {
+  uint32_t mask = (uint32_t)0xFFFFFFFF >> (32 - this->size);
+  uint32_t crc;
+  if(this->refIn) {
+    // the register is kept mirrored, see buildTable()
+    crc = rlb_reflect(this->init & mask, this->size);
+    for(size_t i = 0; i < len; i++) {
+      crc = (crc >> 8) ^ this->table[(crc ^ buff[i]) & 0xFF];
+    }
+
+    // mirror back only if the result is not to be reflected anyway
+    if(this->refOut) {
+      crc ^= rlb_reflect(this->out & mask, this->size);
+    } else {
+      crc = rlb_reflect(crc, this->size) ^ this->out;
+    }
+
+  } else {
+    uint8_t shift = this->size - 8;
+    crc = this->init & mask;
+    for(size_t i = 0; i < len; i++) {
+      crc = (crc << 8) ^ this->table[((crc >> shift) ^ buff[i]) & 0xFF];
+    }
+    crc &= mask;
+
+    crc ^= this->out;
+    if(this->refOut) {
+      crc = rlb_reflect(crc, this->size);
+    }
+  }
+
+  crc &= mask;
+  return(crc);
+}
+#endif
+
 RadioLibCRC RadioLibCRCInstance;
@@ -57,6 +57,23 @@ class RadioLibCRC {
       \returns The resulting checksum.
     */
     uint32_t checksum(const uint8_t* buff, size_t len);
+
+#if !RADIOLIB_GODMODE
+  private:
+#endif
+    uint32_t checksumBitwise(const uint8_t* buff, size_t len);
+
+#if RADIOLIB_CRC_TABLE
+    uint32_t checksumTable(const uint8_t* buff, size_t len);
+    void buildTable();
+
+    // one step of 8 bits for each byte value, for the configuration below
+    uint32_t table[256];
+    bool tableValid = false;
+    uint8_t tableSize = 0;
+    uint32_t tablePoly = 0;
+    bool tableRefIn = false;
+#endif
 };
 
 // the global singleton
@@ -2,13 +2,75 @@
 
 #include <string.h>
 
-RadioLibAES128::RadioLibAES128() {
+#if defined(RADIOLIB_ESP32) && RADIOLIB_AES_ESP32_HW
+#include "mbedtls/aes.h"
+
+// mbedTLS runs AES on the ESP32 peripheral
+static bool rlb_aesEsp32Block(const uint8_t* key, const uint8_t* in, uint8_t* out, bool encrypt) {
+  mbedtls_aes_context ctx;
+  mbedtls_aes_init(&ctx);
+  int err;
+  if(encrypt) {
+    err = mbedtls_aes_setkey_enc(&ctx, key, 8*RADIOLIB_AES128_KEY_SIZE);
+  } else {
+    err = mbedtls_aes_setkey_dec(&ctx, key, 8*RADIOLIB_AES128_KEY_SIZE);
+  }
+  if(err == 0) {
+    err = mbedtls_aes_crypt_ecb(&ctx, encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT, in, out);
+  }
+  mbedtls_aes_free(&ctx);
+  return(err == 0);
+}
+#endif
 
+RadioLibAES128::RadioLibAES128() {
+  #if defined(RADIOLIB_ESP32) && RADIOLIB_AES_ESP32_HW
+  this->blockCb = rlb_aesEsp32Block;
+  #endif
 }
 
 void RadioLibAES128::init(uint8_t* key) {
   this->keyPtr = key;
+  memcpy(this->key, key, RADIOLIB_AES128_KEY_SIZE);
+  #if RADIOLIB_AES_TTABLE
+  this->keyExpansionWords(this->roundKeyWords, key);
+  #else
   this->keyExpansion(this->roundKey, key);
+  #endif
+}
+
+void RadioLibAES128::setBlockBackend(RadioLibAES128BlockCb_t cb) {
+  this->blockCb = cb;
+}
+
+void RadioLibAES128::encryptBlock(uint8_t* block) {
+  if(this->blockCb && this->blockCb(this->key, block, block, true)) {
+    return;
+  }
+  #if RADIOLIB_AES_TTABLE
+  this->cipherWords(block, this->roundKeyWords);
+  #else
+  this->cipher((state_t*)block, this->roundKey);
+  #endif
+}
+
+void RadioLibAES128::decryptBlock(uint8_t* block) {
+  if(this->blockCb && this->blockCb(this->key, block, block, false)) {
+    return;
+  }
+  #if RADIOLIB_AES_TTABLE
+  // decryption is rare enough (no LoRaWAN path uses it) to stay byte-oriented
+  uint8_t roundKey[RADIOLIB_AES128_KEY_EXP_SIZE];
+  for(size_t i = 0; i < RADIOLIB_AES128_KEY_EXP_SIZE / 4; i++) {
+    roundKey[4*i] = this->roundKeyWords[i] >> 24;
+    roundKey[4*i + 1] = this->roundKeyWords[i] >> 16;
+    roundKey[4*i + 2] = this->roundKeyWords[i] >> 8;
+    roundKey[4*i + 3] = this->roundKeyWords[i];
+  }
+  this->decipher((state_t*)block, roundKey);
+  #else
+  this->decipher((state_t*)block, this->roundKey);
+  #endif
 }
 
 size_t RadioLibAES128::encryptECB(uint8_t* in, size_t len, uint8_t* out) {
@@ -21,7 +83,7 @@ size_t RadioLibAES128::encryptECB(uint8_t* in, size_t len, uint8_t* out) {
   memcpy(out, in, len);
 
   for(size_t i = 0; i < num_blocks; i++) {
-    this->cipher((state_t*)(out + (RADIOLIB_AES128_BLOCK_SIZE * i)), this->roundKey);
+    this->encryptBlock(out + (RADIOLIB_AES128_BLOCK_SIZE * i));
   }
 
   return(num_blocks*RADIOLIB_AES128_BLOCK_SIZE);
@@ -37,7 +99,7 @@ size_t RadioLibAES128::decryptECB(uint8_t* in, size_t len, uint8_t* out) {
   memcpy(out, in, len);
 
   for(size_t i = 0; i < num_blocks; i++) {
-    this->decipher((state_t*)(out + (RADIOLIB_AES128_BLOCK_SIZE * i)), this->roundKey);
+    this->decryptBlock(out + (RADIOLIB_AES128_BLOCK_SIZE * i));
   }
 
   return(num_blocks*RADIOLIB_AES128_BLOCK_SIZE);
@@ -48,38 +110,38 @@ void RadioLibAES128::generateCMAC(uint8_t* in, size_t len, uint8_t* cmac) {
   uint8_t key2[RADIOLIB_AES128_BLOCK_SIZE];
   this->generateSubkeys(key1, key2);
 
+  // an empty message is a single, padded block
   size_t num_blocks = len / RADIOLIB_AES128_BLOCK_SIZE;
   bool flag = true;
-  if(len % RADIOLIB_AES128_BLOCK_SIZE) {
+  if((len % RADIOLIB_AES128_BLOCK_SIZE) || (len == 0)) {
     num_blocks++;
     flag = false;
   }
 
-  uint8_t* buff = new uint8_t[num_blocks * RADIOLIB_AES128_BLOCK_SIZE];
-  memset(buff, 0, num_blocks * RADIOLIB_AES128_BLOCK_SIZE);
-  memcpy(buff, in, len);
-  if (flag) {
-    this->blockXor(&buff[(num_blocks - 1)*RADIOLIB_AES128_BLOCK_SIZE], &buff[(num_blocks - 1)*RADIOLIB_AES128_BLOCK_SIZE], key1);
-  } else {
-    buff[len] = 0x80;
-    this->blockXor(&buff[(num_blocks - 1)*RADIOLIB_AES128_BLOCK_SIZE], &buff[(num_blocks - 1)*RADIOLIB_AES128_BLOCK_SIZE], key2);
-  }
-
+  // chain the input in place, only the last block needs a copy for padding
   uint8_t X[] = {
     0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00
   };
-  uint8_t Y[RADIOLIB_AES128_BLOCK_SIZE];
-
   for(size_t i = 0; i < num_blocks - 1; i++) {
-    this->blockXor(Y, &buff[i*RADIOLIB_AES128_BLOCK_SIZE], X);
-    this->encryptECB(Y, RADIOLIB_AES128_BLOCK_SIZE, X);
+    this->blockXor(X, &in[i*RADIOLIB_AES128_BLOCK_SIZE], X);
+    this->encryptBlock(X);
   }
-  this->blockXor(Y, &buff[(num_blocks - 1)*RADIOLIB_AES128_BLOCK_SIZE], X);
-  this->encryptECB(Y, RADIOLIB_AES128_BLOCK_SIZE, cmac);
-  delete[] buff;
+
+  uint8_t last[RADIOLIB_AES128_BLOCK_SIZE] = { 0 };
+  size_t rem = len - (num_blocks - 1)*RADIOLIB_AES128_BLOCK_SIZE;
+  memcpy(last, &in[(num_blocks - 1)*RADIOLIB_AES128_BLOCK_SIZE], rem);
+  if (flag) {
+    this->blockXor(last, last, key1);
+  } else {
+    last[rem] = 0x80;
+    this->blockXor(last, last, key2);
+  }
+  this->blockXor(X, last, X);
+  this->encryptBlock(X);
+  memcpy(cmac, X, RADIOLIB_AES128_BLOCK_SIZE);
 }
 
 bool RadioLibAES128::verifyCMAC(uint8_t* in, size_t len, const uint8_t* cmac) {
@@ -124,6 +186,70 @@ void RadioLibAES128::keyExpansion(uint8_t* roundKey, const uint8_t* key) {
   }
 }
 
+#if RADIOLIB_AES_TTABLE
+void RadioLibAES128::keyExpansionWords(uint32_t* roundKey, const uint8_t* key) {
+  for(uint8_t i = 0; i < RADIOLIB_AES128_N_K; i++) {
+    roundKey[i] = ((uint32_t)key[4*i] << 24) | ((uint32_t)key[4*i + 1] << 16) | ((uint32_t)key[4*i + 2] << 8) | key[4*i + 3];
+  }
+
+  for(uint8_t i = RADIOLIB_AES128_N_K; i < RADIOLIB_AES128_N_B * (RADIOLIB_AES128_N_R + 1); i++) {
+    uint32_t tmp = roundKey[i - 1];
+    if(i % RADIOLIB_AES128_N_K == 0) {
+      // RotWord, SubWord and the round constant in one go
+      tmp = ((uint32_t)RADIOLIB_NONVOLATILE_READ_BYTE(&aesSbox[(tmp >> 16) & 0xFF]) << 24) ^
+            ((uint32_t)RADIOLIB_NONVOLATILE_READ_BYTE(&aesSbox[(tmp >> 8) & 0xFF]) << 16) ^
+            ((uint32_t)RADIOLIB_NONVOLATILE_READ_BYTE(&aesSbox[tmp & 0xFF]) << 8) ^
+            (uint32_t)RADIOLIB_NONVOLATILE_READ_BYTE(&aesSbox[tmp >> 24]) ^
+            ((uint32_t)aesRcon[i/RADIOLIB_AES128_N_K] << 24);
+    }
+    roundKey[i] = roundKey[i - RADIOLIB_AES128_N_K] ^ tmp;
+  }
+}
+
+// T-table lookups, the rotations give the tables for the other rows
+#define RADIOLIB_AES_TE(X)      RADIOLIB_NONVOLATILE_READ_DWORD(&aesTe0[(X) & 0xFF])
+#define RADIOLIB_AES_ROR(X, N)  (((X) >> (N)) | ((X) << (32 - (N))))
+#define RADIOLIB_AES_SBOX(X)    ((uint32_t)RADIOLIB_NONVOLATILE_READ_BYTE(&aesSbox[(X) & 0xFF]))
+
+void RadioLibAES128::cipherWords(uint8_t* block, const uint32_t* roundKey) {
+  // the state as four big-endian columns
+  uint32_t s[4];
+  for(uint8_t i = 0; i < 4; i++) {
+    s[i] = (((uint32_t)block[4*i] << 24) | ((uint32_t)block[4*i + 1] << 16) | ((uint32_t)block[4*i + 2] << 8) | block[4*i + 3]) ^ roundKey[i];
+  }
+
+  // SubBytes, ShiftRows, MixColumns and AddRoundKey, all by table
+  uint32_t t[4];
+  for(uint8_t round = 1; round < RADIOLIB_AES128_N_R; round++) {
+    roundKey += 4;
+    for(uint8_t i = 0; i < 4; i++) {
+      uint32_t t1 = RADIOLIB_AES_TE(s[(i + 1) % 4] >> 16);
+      uint32_t t2 = RADIOLIB_AES_TE(s[(i + 2) % 4] >> 8);
+      uint32_t t3 = RADIOLIB_AES_TE(s[(i + 3) % 4]);
+      t[i] = RADIOLIB_AES_TE(s[i] >> 24) ^ RADIOLIB_AES_ROR(t1, 8) ^ RADIOLIB_AES_ROR(t2, 16) ^ RADIOLIB_AES_ROR(t3, 24) ^ roundKey[i];
+    }
+    memcpy(s, t, sizeof(s));
+  }
+
+  // the last round has no MixColumns
+  roundKey += 4;
+  for(uint8_t i = 0; i < 4; i++) {
+    t[i] = (RADIOLIB_AES_SBOX(s[i] >> 24) << 24) ^
+           (RADIOLIB_AES_SBOX(s[(i + 1) % 4] >> 16) << 16) ^
+           (RADIOLIB_AES_SBOX(s[(i + 2) % 4] >> 8) << 8) ^
+           RADIOLIB_AES_SBOX(s[(i + 3) % 4]) ^
+           roundKey[i];
+  }
+
+  for(uint8_t i = 0; i < 4; i++) {
+    block[4*i] = t[i] >> 24;
+    block[4*i + 1] = t[i] >> 16;
+    block[4*i + 2] = t[i] >> 8;
+    block[4*i + 3] = t[i];
+  }
+}
+#endif
+
 void RadioLibAES128::cipher(state_t* state, uint8_t* roundKey) {
   this->addRoundKey(0, state, roundKey);
   for(uint8_t round = 1; round < RADIOLIB_AES128_N_R; round++) {
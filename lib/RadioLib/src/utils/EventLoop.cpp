@@ -0,0 +1,232 @@
+#include "EventLoop.h"
+#include <string.h>
+
+// number of interrupts raised by each slot; only the interrupt writes its counter,
+// poll() compares it with the number it has handled, so no locking is needed
+static volatile uint8_t eventLoopIrqCount[RADIOLIB_EVENT_LOOP_RADIOS] = { 0 };
+
+// optional function to wake up whoever calls poll()
+static void (*eventLoopNotifyAction)(void) = NULL;
+
+// one interrupt service routine per slot, as the actions do not take any arguments
+template<uint8_t N>
+#if defined(ESP8266) || defined(ESP32)
+  IRAM_ATTR
+#endif
+static void RadioLibEventLoopOnAction(void) {
+  eventLoopIrqCount[N] = eventLoopIrqCount[N] + 1;
+  if(eventLoopNotifyAction) {
+    eventLoopNotifyAction();
+  }
+}
+
+static void (* const eventLoopActions[])(void) = {
+  RadioLibEventLoopOnAction<0>,
+  RadioLibEventLoopOnAction<1>,
+#if RADIOLIB_EVENT_LOOP_RADIOS > 2
+  RadioLibEventLoopOnAction<2>,
+#endif
+#if RADIOLIB_EVENT_LOOP_RADIOS > 3
+  RadioLibEventLoopOnAction<3>,
+#endif
+#if RADIOLIB_EVENT_LOOP_RADIOS > 4
+  RadioLibEventLoopOnAction<4>,
+#endif
+#if RADIOLIB_EVENT_LOOP_RADIOS > 5
+  RadioLibEventLoopOnAction<5>,
+#endif
+#if RADIOLIB_EVENT_LOOP_RADIOS > 6
+  RadioLibEventLoopOnAction<6>,
+#endif
+#if RADIOLIB_EVENT_LOOP_RADIOS > 7
+  RadioLibEventLoopOnAction<7>,
+#endif
+};
+
+RadioLibEventLoop::RadioLibEventLoop() {
+  memset(this->radios, 0, sizeof(this->radios));
+}
+
+int16_t RadioLibEventLoop::attach(PhysicalLayer* phy, RadioLibEventCb_t cb, void* ctx) {
+  if(!phy || !cb) {
+    return(RADIOLIB_ERR_NULL_POINTER);
+  }
+
+  for(uint8_t id = 0; id < RADIOLIB_EVENT_LOOP_RADIOS; id++) {
+    if(this->radios[id].phy == phy) {
+      return(id);
+    }
+  }
+
+  for(uint8_t id = 0; id < RADIOLIB_EVENT_LOOP_RADIOS; id++) {
+    if(this->radios[id].phy) {
+      continue;
+    }
+
+    this->radios[id].phy = phy;
+    this->radios[id].cb = cb;
+    this->radios[id].ctx = ctx;
+    this->radios[id].op = RADIOLIB_EVENT_OP_IDLE;
+    this->radios[id].rxData = NULL;
+    this->radios[id].rxLen = 0;
+    this->radios[id].handled = eventLoopIrqCount[id];
+
+    // on most modules these share a single pin, so this only installs the same routine again
+    phy->setPacketSentAction(eventLoopActions[id]);
+    phy->setPacketReceivedAction(eventLoopActions[id]);
+    phy->setChannelScanAction(eventLoopActions[id]);
+    return(id);
+  }
+
+  return(RADIOLIB_ERR_EVENT_LOOP_FULL);
+}
+
+int16_t RadioLibEventLoop::detach(uint8_t id) {
+  if((id >= RADIOLIB_EVENT_LOOP_RADIOS) || !this->radios[id].phy) {
+    return(RADIOLIB_ERR_EVENT_LOOP_INVALID_RADIO);
+  }
+
+  PhysicalLayer* phy = this->radios[id].phy;
+  phy->clearPacketSentAction();
+  phy->clearPacketReceivedAction();
+  phy->clearChannelScanAction();
+  memset(&this->radios[id], 0, sizeof(Radio_t));
+  return(RADIOLIB_ERR_NONE);
+}
+
+int16_t RadioLibEventLoop::startTransmit(uint8_t id, const uint8_t* data, size_t len) {
+  int16_t state = this->start(id, RADIOLIB_EVENT_OP_TX);
+  RADIOLIB_ASSERT(state);
+
+  state = this->radios[id].phy->startTransmit(data, len);
+  if(state != RADIOLIB_ERR_NONE) {
+    this->radios[id].op = RADIOLIB_EVENT_OP_IDLE;
+  }
+  return(state);
+}
+
+int16_t RadioLibEventLoop::startReceive(uint8_t id, uint8_t* data, size_t len) {
+  if(!data) {
+    return(RADIOLIB_ERR_NULL_POINTER);
+  }
+
+  int16_t state = this->start(id, RADIOLIB_EVENT_OP_RX);
+  RADIOLIB_ASSERT(state);
+
+  this->radios[id].rxData = data;
+  this->radios[id].rxLen = len;
+  state = this->radios[id].phy->startReceive();
+  if(state != RADIOLIB_ERR_NONE) {
+    this->radios[id].op = RADIOLIB_EVENT_OP_IDLE;
+  }
+  return(state);
+}
+
+int16_t RadioLibEventLoop::startChannelScan(uint8_t id) {
+  int16_t state = this->start(id, RADIOLIB_EVENT_OP_CAD);
+  RADIOLIB_ASSERT(state);
+
+  state = this->radios[id].phy->startChannelScan();
+  if(state != RADIOLIB_ERR_NONE) {
+    this->radios[id].op = RADIOLIB_EVENT_OP_IDLE;
+  }
+  return(state);
+}
+
+int16_t RadioLibEventLoop::standby(uint8_t id) {
+  if((id >= RADIOLIB_EVENT_LOOP_RADIOS) || !this->radios[id].phy) {
+    return(RADIOLIB_ERR_EVENT_LOOP_INVALID_RADIO);
+  }
+
+  this->radios[id].op = RADIOLIB_EVENT_OP_IDLE;
+  return(this->radios[id].phy->standby());
+}
+
+size_t RadioLibEventLoop::poll() {
+  size_t num = 0;
+  for(uint8_t id = 0; id < RADIOLIB_EVENT_LOOP_RADIOS; id++) {
+    Radio_t* radio = &this->radios[id];
+    uint8_t count = eventLoopIrqCount[id];
+    if(!radio->phy || (count == radio->handled)) {
+      continue;
+    }
+    radio->handled = count;
+
+    // the operation is finished before the handler is called, so that it may start the next one
+    uint8_t op = radio->op;
+    radio->op = RADIOLIB_EVENT_OP_IDLE;
+    int16_t state = RADIOLIB_ERR_NONE;
+    uint8_t event = 0;
+    switch(op) {
+      case(RADIOLIB_EVENT_OP_TX):
+        state = radio->phy->finishTransmit();
+        event = RADIOLIB_EVENT_TX_DONE;
+        break;
+
+      case(RADIOLIB_EVENT_OP_RX): {
+        size_t len = radio->phy->getPacketLength();
+        if(len > radio->rxLen) {
+          len = radio->rxLen;
+        }
+        state = radio->phy->readData(radio->rxData, len);
+        radio->rxLen = len;
+        event = RADIOLIB_EVENT_RX_DONE;
+      } break;
+
+      case(RADIOLIB_EVENT_OP_CAD):
+        state = radio->phy->getChannelScanResult();
+        event = RADIOLIB_EVENT_CAD_DONE;
+        break;
+
+      default:
+        // nothing was started, e.g. an interrupt after standby()
+        continue;
+    }
+
+    RADIOLIB_DEBUG_BASIC_PRINTLN("Event loop: radio %d, event %d, state %d", id, event, state);
+    radio->cb(id, event, state, radio->ctx);
+    num++;
+  }
+  return(num);
+}
+
+bool RadioLibEventLoop::isPending() {
+  for(uint8_t id = 0; id < RADIOLIB_EVENT_LOOP_RADIOS; id++) {
+    if(this->radios[id].phy && (eventLoopIrqCount[id] != this->radios[id].handled)) {
+      return(true);
+    }
+  }
+  return(false);
+}
+
+size_t RadioLibEventLoop::getPacketLength(uint8_t id) {
+  if(id >= RADIOLIB_EVENT_LOOP_RADIOS) {
+    return(0);
+  }
+  return(this->radios[id].rxLen);
+}
+
+uint8_t RadioLibEventLoop::getOperation(uint8_t id) {
+  if(id >= RADIOLIB_EVENT_LOOP_RADIOS) {
+    return(RADIOLIB_EVENT_OP_IDLE);
+  }
+  return(this->radios[id].op);
+}
+
+void RadioLibEventLoop::setNotifyAction(void (*func)(void)) {
+  eventLoopNotifyAction = func;
+}
+
+int16_t RadioLibEventLoop::start(uint8_t id, uint8_t op) {
+  if((id >= RADIOLIB_EVENT_LOOP_RADIOS) || !this->radios[id].phy) {
+    return(RADIOLIB_ERR_EVENT_LOOP_INVALID_RADIO);
+  }
+  if(this->radios[id].op != RADIOLIB_EVENT_OP_IDLE) {
+    return(RADIOLIB_ERR_EVENT_LOOP_BUSY);
+  }
+
+  // interrupts raised before this operation was started do not belong to it
+  this->radios[id].handled = eventLoopIrqCount[id];
+  this->radios[id].op = op;
+  return(RADIOLIB_ERR_NONE);
+}
@@ -0,0 +1,149 @@
+#if !defined(_RADIOLIB_EVENT_LOOP_H)
+#define _RADIOLIB_EVENT_LOOP_H
+
+#include "../TypeDef.h"
+#include "../protocols/PhysicalLayer/PhysicalLayer.h"
+
+#if RADIOLIB_EVENT_LOOP_RADIOS > 8
+  #error "RADIOLIB_EVENT_LOOP_RADIOS must be at most 8"
+#endif
+
+// events passed to the completion handlers
+#define RADIOLIB_EVENT_TX_DONE                                  (0x01)
+#define RADIOLIB_EVENT_RX_DONE                                  (0x02)
+#define RADIOLIB_EVENT_CAD_DONE                                 (0x03)
+
+// operation a radio is busy with
+#define RADIOLIB_EVENT_OP_IDLE                                  (0x00)
+#define RADIOLIB_EVENT_OP_TX                                    (0x01)
+#define RADIOLIB_EVENT_OP_RX                                    (0x02)
+#define RADIOLIB_EVENT_OP_CAD                                   (0x03)
+
+/*!
+  \brief Completion handler of a RadioLibEventLoop, called from RadioLibEventLoop::poll().
+  \param id ID of the radio, as returned by RadioLibEventLoop::attach.
+  \param event The operation that finished: RADIOLIB_EVENT_TX_DONE, RADIOLIB_EVENT_RX_DONE or RADIOLIB_EVENT_CAD_DONE.
+  \param state Result of finishing the operation: finishTransmit, readData or getChannelScanResult.
+  \param ctx User context passed to RadioLibEventLoop::attach.
+*/
+typedef void (*RadioLibEventCb_t)(uint8_t id, uint8_t event, int16_t state, void* ctx);
+
+/*!
+  \class RadioLibEventLoop
+  \brief Drives several radios from one loop, without polling any of them.
+  The DIO interrupt of each radio only counts the interrupt (there is no SPI access in the interrupt),
+  poll() then finishes the operation that was started on the radio and calls its completion handler.
+  Handlers may start the next operation right away (e.g. receive after transmit), so operations
+  can be chained without blocking. Only one event loop should exist, as the interrupt slots are shared.
+  Radios used by LoRaWANNode must not be attached, as the node sets its own interrupt actions.
+*/
+class RadioLibEventLoop {
+  public:
+    /*!
+      \brief Default constructor.
+    */
+    RadioLibEventLoop();
+
+    /*!
+      \brief Attach a radio. It must be initialized (begin) already.
+      \param phy The radio.
+      \param cb Completion handler.
+      \param ctx User context passed to the handler, may be NULL.
+      \returns ID of the radio (0 or more) or \ref status_codes
+    */
+    int16_t attach(PhysicalLayer* phy, RadioLibEventCb_t cb, void* ctx = NULL);
+
+    /*!
+      \brief Detach a radio and remove its interrupt actions.
+      \param id ID of the radio.
+      \returns \ref status_codes
+    */
+    int16_t detach(uint8_t id);
+
+    /*!
+      \brief Start transmitting. The handler is called with RADIOLIB_EVENT_TX_DONE once done.
+      \param id ID of the radio.
+      \param data Data to send, must remain valid until the handler is called.
+      \param len Number of bytes to send.
+      \returns \ref status_codes
+    */
+    int16_t startTransmit(uint8_t id, const uint8_t* data, size_t len);
+
+    /*!
+      \brief Start receiving. The handler is called with RADIOLIB_EVENT_RX_DONE once a packet was read
+      into the buffer; reception must be started again for the next packet.
+      \param id ID of the radio.
+      \param data Buffer for the packet.
+      \param len Size of the buffer, longer packets are truncated.
+      \returns \ref status_codes
+    */
+    int16_t startReceive(uint8_t id, uint8_t* data, size_t len);
+
+    /*!
+      \brief Start a channel scan. The handler is called with RADIOLIB_EVENT_CAD_DONE,
+      state is RADIOLIB_PREAMBLE_DETECTED or RADIOLIB_CHANNEL_FREE.
+      \param id ID of the radio.
+      \returns \ref status_codes
+    */
+    int16_t startChannelScan(uint8_t id);
+
+    /*!
+      \brief Abort the current operation and put the radio in standby, the handler is not called.
+      \param id ID of the radio.
+      \returns \ref status_codes
+    */
+    int16_t standby(uint8_t id);
+
+    /*!
+      \brief Finish the operations of all radios that raised an interrupt and call their handlers.
+      Call this from the main loop or a task, never from an interrupt.
+      \returns Number of handlers called.
+    */
+    size_t poll();
+
+    /*!
+      \brief Check whether any radio raised an interrupt that poll() has not handled yet.
+      Useful to decide whether it is safe to go to sleep.
+      \returns True if poll() has work to do.
+    */
+    bool isPending();
+
+    /*!
+      \brief Get the length of the packet received by the last RADIOLIB_EVENT_RX_DONE.
+      \param id ID of the radio.
+      \returns Length in bytes (after truncation to the buffer size).
+    */
+    size_t getPacketLength(uint8_t id);
+
+    /*!
+      \brief Get the operation a radio is busy with.
+      \param id ID of the radio.
+      \returns One of RADIOLIB_EVENT_OP_*.
+    */
+    uint8_t getOperation(uint8_t id);
+
+    /*!
+      \brief Set a function that is called from the interrupt whenever any radio raises one,
+      e.g. to wake up the task that calls poll(). It must be interrupt-safe.
+      \param func Function to call, or NULL.
+    */
+    static void setNotifyAction(void (*func)(void));
+
+#if !RADIOLIB_GODMODE
+  private:
+#endif
+    struct Radio_t {
+      PhysicalLayer* phy;
+      RadioLibEventCb_t cb;
+      void* ctx;
+      uint8_t op;
+      uint8_t* rxData;
+      size_t rxLen;
+      uint8_t handled;
+    };
+    Radio_t radios[RADIOLIB_EVENT_LOOP_RADIOS];
+
+    int16_t start(uint8_t id, uint8_t op);
+};
+
+#endif
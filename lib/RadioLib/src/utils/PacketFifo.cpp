@@ -0,0 +1,109 @@
+#include "PacketFifo.h"
+
+RadioLibPacketFifo::RadioLibPacketFifo(Module* mod, uint32_t regFifo, uint32_t regIrqFlags, uint8_t flagFifoLevel,
+  uint8_t flagPacketSent, uint8_t flagPayloadReady, uint8_t flagCrcOk, uint8_t size, uint8_t threshold) {
+  this->mod = mod;
+  this->regFifo = regFifo;
+  this->regIrqFlags = regIrqFlags;
+  this->flagFifoLevel = flagFifoLevel;
+  this->flagPacketSent = flagPacketSent;
+  this->flagPayloadReady = flagPayloadReady;
+  this->flagCrcOk = flagCrcOk;
+  this->size = size;
+  this->threshold = threshold;
+}
+
+int16_t RadioLibPacketFifo::transmit(const uint8_t* data, size_t len, size_t queued, RadioLibTime_t timeout) {
+  // with FifoLevel cleared, there are at most threshold bytes waiting; keep one byte of margin
+  size_t chunk = this->size - this->threshold - 1;
+  size_t sent = queued;
+  RadioLibTime_t start = this->mod->hal->millis();
+  while(true) {
+    uint8_t flags = this->mod->SPIreadRegister(this->regIrqFlags);
+    if(sent < len) {
+      if(!(flags & this->flagFifoLevel)) {
+        size_t num = RADIOLIB_MIN(len - sent, chunk);
+        this->mod->SPIwriteRegisterBurst(this->regFifo, const_cast<uint8_t*>(&data[sent]), num);
+        sent += num;
+      }
+
+    } else if(flags & this->flagPacketSent) {
+      return(RADIOLIB_ERR_NONE);
+
+    } else {
+      // only yield once the whole packet is in the FIFO, otherwise it could run dry
+      this->mod->hal->yield();
+
+    }
+
+    if(this->mod->hal->millis() - start > timeout) {
+      return(RADIOLIB_ERR_TX_TIMEOUT);
+    }
+  }
+}
+
+int16_t RadioLibPacketFifo::receive(uint8_t* data, size_t len, size_t pktLen, size_t skip, bool crc, size_t* rcvLen, RadioLibTime_t timeout) {
+  // FifoLevel means more than threshold bytes are waiting
+  size_t chunk = RADIOLIB_MAX(this->threshold, 1);
+  bool variable = (pktLen == 0);
+  bool started = false;
+  size_t pos = 0;
+  RadioLibTime_t start = this->mod->hal->millis();
+
+  // the packet is complete only with PayloadReady, which also tells the CRC result
+  uint8_t flags = 0;
+  while(true) {
+    flags = this->mod->SPIreadRegister(this->regIrqFlags);
+    bool ready = flags & this->flagPayloadReady;
+    if(!ready && !(flags & this->flagFifoLevel)) {
+      if(this->mod->hal->millis() - start > timeout) {
+        return(RADIOLIB_ERR_RX_TIMEOUT);
+      }
+
+      // same as on transmit, only yield while nothing has been received yet
+      if(!started) {
+        this->mod->hal->yield();
+      }
+      continue;
+    }
+
+    started = true;
+    size_t avail = chunk;
+    if(variable) {
+      pktLen = this->mod->SPIreadRegister(this->regFifo);
+      variable = false;
+      avail--;
+    }
+
+    // once the payload is ready, all of the remaining packet is in the FIFO
+    size_t num = ready ? (pktLen - pos) : RADIOLIB_MIN(avail, pktLen - pos);
+    this->read(data, len, skip, pos, num);
+    pos += num;
+    if(ready) {
+      break;
+    }
+  }
+
+  *rcvLen = (pktLen > skip) ? pktLen - skip : 0;
+  if(crc && !(flags & this->flagCrcOk)) {
+    return(RADIOLIB_ERR_CRC_MISMATCH);
+  }
+  return(RADIOLIB_ERR_NONE);
+}
+
+void RadioLibPacketFifo::read(uint8_t* data, size_t len, size_t skip, size_t pos, size_t num) {
+  // read into a bounce buffer, the range may start with skipped bytes or end beyond the user buffer
+  uint8_t buff[RADIOLIB_STATIC_ARRAY_SIZE];
+  while(num > 0) {
+    size_t part = RADIOLIB_MIN(num, sizeof(buff));
+    this->mod->SPIreadRegisterBurst(this->regFifo, part, buff);
+    for(size_t i = 0; i < part; i++) {
+      size_t j = pos + i;
+      if((j >= skip) && (j - skip < len)) {
+        data[j - skip] = buff[i];
+      }
+    }
+    pos += part;
+    num -= part;
+  }
+}
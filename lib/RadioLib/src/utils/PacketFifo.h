@@ -0,0 +1,74 @@
+#if !defined(_RADIOLIB_PACKET_FIFO_H)
+#define _RADIOLIB_PACKET_FIFO_H
+
+#include "../TypeDef.h"
+#include "../Module.h"
+
+/*!
+  \class RadioLibPacketFifo
+  \brief Streams packets longer than the FIFO through the packet engine of SX127x (FSK/OOK) and RF69.
+  Both chips have a 64-byte FIFO with a FifoLevel flag (set while more than FifoThreshold bytes are waiting),
+  so the FIFO is refilled during transmission and drained during reception, based on that flag.
+  Blocking methods of the drivers use this; it does not configure the radio on its own.
+*/
+class RadioLibPacketFifo {
+  public:
+    /*!
+      \brief Default constructor.
+      \param mod Module of the radio.
+      \param regFifo Address of the FIFO register.
+      \param regIrqFlags Address of the IRQ flags register with the FIFO and packet flags.
+      \param flagFifoLevel Mask of the FifoLevel flag.
+      \param flagPacketSent Mask of the PacketSent flag.
+      \param flagPayloadReady Mask of the PayloadReady flag.
+      \param flagCrcOk Mask of the CrcOk flag.
+      \param size FIFO size in bytes.
+      \param threshold Currently configured FIFO threshold.
+    */
+    RadioLibPacketFifo(Module* mod, uint32_t regFifo, uint32_t regIrqFlags, uint8_t flagFifoLevel,
+      uint8_t flagPacketSent, uint8_t flagPayloadReady, uint8_t flagCrcOk, uint8_t size, uint8_t threshold);
+
+    /*!
+      \brief Feed the rest of a packet to the FIFO and wait until it was sent.
+      The transmitter must already be running with the first part of the packet in the FIFO.
+      \param data Complete packet payload.
+      \param len Payload length.
+      \param queued Number of payload bytes already written to the FIFO.
+      \param timeout Timeout in milliseconds.
+      \returns \ref status_codes
+    */
+    int16_t transmit(const uint8_t* data, size_t len, size_t queued, RadioLibTime_t timeout);
+
+    /*!
+      \brief Drain a packet from the FIFO while it is being received. The receiver must already be running.
+      With CRC checking enabled, CRC auto-clear must be off: otherwise the radio silently drops a failed packet
+      from the FIFO and the bytes of the next one would be appended to the part already read.
+      \param data Buffer for the payload; bytes that do not fit are dropped.
+      \param len Size of the buffer.
+      \param pktLen Packet length in fixed length mode; 0 in variable length mode,
+      where the packet length is taken from the first byte.
+      \param skip Number of bytes at the start of the packet that are not payload (e.g. node address).
+      \param crc Whether the packet CRC is checked by the radio.
+      \param rcvLen Will be set to the payload length of the received packet, which may be more than len.
+      \param timeout Timeout in milliseconds.
+      \returns \ref status_codes
+    */
+    int16_t receive(uint8_t* data, size_t len, size_t pktLen, size_t skip, bool crc, size_t* rcvLen, RadioLibTime_t timeout);
+
+#if !RADIOLIB_GODMODE
+  private:
+#endif
+    Module* mod;
+    uint32_t regFifo;
+    uint32_t regIrqFlags;
+    uint8_t flagFifoLevel;
+    uint8_t flagPacketSent;
+    uint8_t flagPayloadReady;
+    uint8_t flagCrcOk;
+    uint8_t size;
+    uint8_t threshold;
+
+    void read(uint8_t* data, size_t len, size_t skip, size_t pos, size_t num);
+};
+
+#endif
@@ -0,0 +1,177 @@
+/**
+ * @file       StreamTrace.h
+ * @license    This project is released under the MIT License (MIT)
+ * @date       Oct 2026
+ *
+ * Non-blocking capture of Stream traffic. Instead of echoing every byte to
+ * a debug port (which throttles fast links), StreamTracer records
+ * (timestamp, direction, bytes) into a caller-provided RAM ring that can be
+ * written out later, e.g. to an SD card, and replayed on a host with
+ * extras/replay.
+ *
+ * Capture format (all integers little endian):
+ *   file header:  "ATRC" version(1) reserved(3)
+ *   record:       micros(4) direction(1) length(2) data(length)
+ */
+
+#ifndef StreamTrace_h
+#define StreamTrace_h
+
+#define STREAM_TRACE_VERSION    1
+#define STREAM_TRACE_HDR_LEN    7
+// Records are split once they reach this size so a long transfer does not
+// pin a huge record at the ring tail
+#define STREAM_TRACE_MAX_RECORD 1024
+
+enum StreamTraceDir {
+  STREAM_TRACE_TX = 0,  // host -> device
+  STREAM_TRACE_RX = 1,  // device -> host
+};
+
+class StreamTraceBuffer
+{
+  public:
+    // buf is typically ps_malloc()'d; the ring never allocates itself.
+    // A default-constructed buffer ignores traffic until begin() is called.
+    StreamTraceBuffer(uint8_t* buf = NULL, size_t size = 0)
+    {
+      begin(buf, size);
+    }
+
+    void begin(uint8_t* buf, size_t size) {
+      _buf  = buf;
+      _size = size;
+      clear();
+    }
+
+    void clear() {
+      _head = _tail = _used = 0;
+      _open = false;
+      _dropped = 0;
+    }
+
+    // Appends one byte, coalescing with the previous record when it has the
+    // same direction. Oldest records are discarded when the ring is full.
+    void append(uint8_t dir, uint8_t ch) {
+      if (!_buf || _size <= STREAM_TRACE_HDR_LEN) return;
+      bool startNew = !_open || _openDir != dir || _openLen >= STREAM_TRACE_MAX_RECORD;
+      if (!startNew) {
+        if (!reserve(1)) return;
+        // Making room may have evicted the open record itself
+        startNew = !_open;
+      }
+      if (startNew) {
+        if (!reserve(STREAM_TRACE_HDR_LEN + 1)) return;
+        _openPos = _head;
+        _openDir = dir;
+        _openLen = 0;
+        _open = true;
+        uint32_t ts = micros();
+        put((uint8_t)ts); put((uint8_t)(ts >> 8));
+        put((uint8_t)(ts >> 16)); put((uint8_t)(ts >> 24));
+        put(dir);
+        put(0); put(0);
+      }
+      put(ch);
+      _openLen++;
+      poke(_openPos + 5, (uint8_t)_openLen);
+      poke(_openPos + 6, (uint8_t)(_openLen >> 8));
+    }
+
+    // Writes the capture (file header + records) and empties the ring.
+    // Call from a context where blocking I/O is acceptable.
+    size_t dump(Print& out) {
+      size_t n = 0;
+      static const uint8_t hdr[8] = { 'A', 'T', 'R', 'C', STREAM_TRACE_VERSION, 0, 0, 0 };
+      n += out.write(hdr, sizeof(hdr));
+      size_t pos = _tail;
+      size_t left = _used;
+      while (left) {
+        size_t chunk = left;
+        if (pos + chunk > _size) chunk = _size - pos;
+        n += out.write(_buf + pos, chunk);
+        pos = (pos + chunk) % _size;
+        left -= chunk;
+      }
+      clear();
+      return n;
+    }
+
+    size_t used() const { return _used; }
+    size_t capacity() const { return _size; }
+    // Records discarded to make room since the last clear()/dump()
+    uint32_t dropped() const { return _dropped; }
+
+  private:
+    void put(uint8_t b) {
+      _buf[_head] = b;
+      _head = (_head + 1) % _size;
+      _used++;
+    }
+
+    void poke(size_t pos, uint8_t b) { _buf[pos % _size] = b; }
+
+    uint8_t peekAt(size_t pos) const { return _buf[pos % _size]; }
+
+    // Frees space by dropping whole records from the tail
+    bool reserve(size_t need) {
+      if (need > _size) return false;
+      while (_size - _used < need) {
+        if (_used == 0) return false;
+        if (_open && _tail == _openPos) {
+          // The open record is the only one left; restart it
+          _open = false;
+        }
+        size_t len = STREAM_TRACE_HDR_LEN + (peekAt(_tail + 5) | (peekAt(_tail + 6) << 8));
+        _tail = (_tail + len) % _size;
+        _used -= len;
+        _dropped++;
+      }
+      return true;
+    }
+
+    uint8_t* _buf;
+    size_t   _size;
+    size_t   _head;
+    size_t   _tail;
+    size_t   _used;
+    size_t   _openPos;
+    uint16_t _openLen;
+    uint8_t  _openDir;
+    bool     _open;
+    uint32_t _dropped;
+};
+
+class StreamTracer
+  : public Stream
+{
+  public:
+    StreamTracer(Stream& data, StreamTraceBuffer& trace)
+      : _data(data), _trace(trace)
+    {}
+
+    virtual ~StreamTracer() {}
+
+    virtual size_t write(uint8_t ch) {
+      _trace.append(STREAM_TRACE_TX, ch);
+      return _data.write(ch);
+    }
+    virtual size_t write(const uint8_t* buf, size_t size) {
+      for (size_t i = 0; i < size; i++) { _trace.append(STREAM_TRACE_TX, buf[i]); }
+      return _data.write(buf, size);
+    }
+    virtual int read() {
+      int ch = _data.read();
+      if (ch != -1) { _trace.append(STREAM_TRACE_RX, ch); }
+      return ch;
+    }
+    virtual int available() { return _data.available(); }
+    virtual int peek()      { return _data.peek();      }
+    virtual void flush()    { _data.flush();            }
+
+  private:
+    Stream&            _data;
+    StreamTraceBuffer& _trace;
+};
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file       StreamReplay.h
+ * @license    This project is released under the MIT License (MIT)
+ * @date       Oct 2026
+ *
+ * Mock Stream that replays a StreamTrace capture. Recorded RX bytes are
+ * handed to the reader, and each RX record only becomes available once the
+ * code under test has written all TX bytes recorded before it, so a parser
+ * sees the same request/response ordering as in the field. Written bytes
+ * are compared with the recorded TX traffic.
+ */
+
+#ifndef StreamReplay_h
+#define StreamReplay_h
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../../StreamTrace.h"
+
+struct StreamReplayRecord {
+  uint32_t       micros;
+  uint8_t        dir;
+  uint16_t       len;
+  const uint8_t* data;
+};
+
+class StreamReplay
+  : public Stream
+{
+  public:
+    // records must stay valid for the lifetime of the replay
+    StreamReplay(const StreamReplayRecord* records, size_t count)
+      : _rec(records), _count(count)
+    {
+      rewind();
+    }
+
+    void rewind() {
+      _txRec = _rxRec = 0;
+      _txOff = _rxOff = 0;
+      _mismatches = 0;
+      _extraTx = 0;
+      _firstMismatch = -1;
+      _txPos = 0;
+      skipTo(_txRec, STREAM_TRACE_TX);
+      skipTo(_rxRec, STREAM_TRACE_RX);
+    }
+
+    virtual size_t write(uint8_t ch) {
+      if (_txRec >= _count) {
+        _extraTx++;
+        return 1;
+      }
+      if (_rec[_txRec].data[_txOff] != ch) {
+        if (_firstMismatch < 0) _firstMismatch = (long)_txPos;
+        _mismatches++;
+      }
+      _txPos++;
+      if (++_txOff >= _rec[_txRec].len) {
+        _txOff = 0;
+        _txRec++;
+        skipTo(_txRec, STREAM_TRACE_TX);
+      }
+      return 1;
+    }
+    using Print::write;
+
+    virtual int available() {
+      if (!rxReady()) return 0;
+      return _rec[_rxRec].len - _rxOff;
+    }
+    virtual int peek() {
+      if (!rxReady()) return -1;
+      return _rec[_rxRec].data[_rxOff];
+    }
+    virtual int read() {
+      if (!rxReady()) return -1;
+      int ch = _rec[_rxRec].data[_rxOff];
+      if (++_rxOff >= _rec[_rxRec].len) {
+        _rxOff = 0;
+        _rxRec++;
+        skipTo(_rxRec, STREAM_TRACE_RX);
+      }
+      return ch;
+    }
+    virtual void flush() {}
+
+    // All recorded RX bytes consumed and all TX bytes written
+    bool finished() const { return _rxRec >= _count && _txRec >= _count; }
+    uint32_t mismatches() const { return _mismatches; }
+    // Offset in the TX stream of the first differing byte, -1 if none
+    long firstMismatch() const { return _firstMismatch; }
+    // Bytes written after the recorded TX traffic ran out
+    uint32_t extraTx() const { return _extraTx; }
+
+  private:
+    void skipTo(size_t& idx, uint8_t dir) {
+      while (idx < _count && (_rec[idx].dir != dir || _rec[idx].len == 0)) idx++;
+    }
+
+    // An RX record is released once every TX record before it is written;
+    // _txRec always points at the next pending TX record (or _count)
+    bool rxReady() const {
+      return _rxRec < _count && _txRec > _rxRec;
+    }
+
+    const StreamReplayRecord* _rec;
+    size_t   _count;
+    size_t   _txRec;
+    size_t   _txOff;
+    size_t   _rxRec;
+    size_t   _rxOff;
+    size_t   _txPos;
+    uint32_t _mismatches;
+    uint32_t _extraTx;
+    long     _firstMismatch;
+};
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file       at_replay.cpp
+ * @license    This project is released under the MIT License (MIT)
+ * @date       Oct 2026
+ *
+ * Host tool for StreamTrace captures.
+ *
+ *   g++ -O2 -std=c++11 -Ihost at_replay.cpp -o at_replay
+ *   ./at_replay capture.bin          # print the decoded timeline
+ *   ./at_replay -r capture.bin       # replay through StreamReplay and time it
+ *
+ * To test a parser, build it against host/Arduino.h (or a fuller shim) and
+ * hand it a StreamReplay instead of the modem serial port.
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "StreamReplay.h"
+
+static bool loadCapture(const char* path, std::vector<uint8_t>& raw,
+                        std::vector<StreamReplayRecord>& records) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  uint8_t chunk[4096];
+  size_t  n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) raw.insert(raw.end(), chunk, chunk + n);
+  fclose(f);
+
+  if (raw.size() < 8 || memcmp(raw.data(), "ATRC", 4) != 0) {
+    fprintf(stderr, "%s: not a StreamTrace capture\n", path);
+    return false;
+  }
+  if (raw[4] != STREAM_TRACE_VERSION) {
+    fprintf(stderr, "%s: unsupported version %u\n", path, raw[4]);
+    return false;
+  }
+
+  size_t pos = 8;
+  while (pos + STREAM_TRACE_HDR_LEN <= raw.size()) {
+    const uint8_t*     p = raw.data() + pos;
+    StreamReplayRecord r;
+    r.micros = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    r.dir    = p[4];
+    r.len    = p[5] | (p[6] << 8);
+    r.data   = p + STREAM_TRACE_HDR_LEN;
+    if (pos + STREAM_TRACE_HDR_LEN + r.len > raw.size()) {
+      fprintf(stderr, "warning: truncated record at offset %zu\n", pos);
+      break;
+    }
+    records.push_back(r);
+    pos += STREAM_TRACE_HDR_LEN + r.len;
+  }
+  return true;
+}
+
+static void printTimeline(const std::vector<StreamReplayRecord>& records) {
+  uint32_t t0 = records.empty() ? 0 : records[0].micros;
+  for (const StreamReplayRecord& r : records) {
+    printf("%10.3f ms %s ", (r.micros - t0) / 1000.0, r.dir == STREAM_TRACE_TX ? ">>" : "<<");
+    for (uint16_t i = 0; i < r.len; i++) {
+      uint8_t c = r.data[i];
+      if (c == '\r') printf("\\r");
+      else if (c == '\n') printf("\\n");
+      else if (c >= 0x20 && c < 0x7F) putchar(c);
+      else printf("\\x%02X", c);
+    }
+    putchar('\n');
+  }
+}
+
+// Drives the mock as the host side would: write each TX record, then drain
+// whatever RX the replay releases
+static int replay(const std::vector<StreamReplayRecord>& records) {
+  StreamReplay stream(records.data(), records.size());
+  size_t   txBytes = 0, rxBytes = 0;
+  uint32_t start = micros();
+  for (const StreamReplayRecord& r : records) {
+    if (r.dir == STREAM_TRACE_TX) {
+      stream.write(r.data, r.len);
+      txBytes += r.len;
+    }
+    while (stream.available()) {
+      stream.read();
+      rxBytes++;
+    }
+  }
+  uint32_t elapsed = micros() - start;
+
+  printf("records: %zu, tx: %zu bytes, rx: %zu bytes\n", records.size(), txBytes, rxBytes);
+  if (!records.empty()) {
+    printf("field duration: %.3f ms\n", (records.back().micros - records[0].micros) / 1000.0);
+  }
+  printf("replay time:    %.3f ms\n", elapsed / 1000.0);
+  printf("mismatches: %u, extra tx: %u, finished: %s\n", stream.mismatches(),
+         stream.extraTx(), stream.finished() ? "yes" : "no");
+  return (stream.mismatches() == 0 && stream.finished()) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  bool        doReplay = false;
+  const char* path     = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-r") == 0) doReplay = true;
+    else path = argv[i];
+  }
+  if (!path) {
+    fprintf(stderr, "usage: %s [-r] capture.bin\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint8_t>            raw;
+  std::vector<StreamReplayRecord> records;
+  if (!loadCapture(path, raw, records)) return 2;
+
+  if (doReplay) return replay(records);
+  printTimeline(records);
+  return 0;
+}
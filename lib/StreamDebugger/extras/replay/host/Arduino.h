@@ -0,0 +1,43 @@
+/**
+ * Minimal Arduino shim for building the replay tools on a desktop host.
+ * Only what StreamTrace.h / StreamReplay.h need is provided.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+
+inline uint32_t micros() {
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint32_t millis() { return micros() / 1000; }
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t ch) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size) {
+      size_t n = 0;
+      while (size--) { n += write(*buf++); }
+      return n;
+    }
+};
+
+class Stream
+  : public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+};
+
+#endif
@@ -0,0 +1,333 @@
+/**
+ * @file      TinyGsmCertStore.tpp
+ * @license   MIT
+ * @date      2026-10-17
+ *
+ * Upload-once certificate handling for the A76xx / SIM76xx family.
+ *
+ * cert_sync() stores each PEM under a content-addressed name
+ * ("ca_cert.pem" becomes "ca_cert-1a2b3c4d.pem", the suffix being a hash of
+ * the PEM). +CCERTLIST then tells whether the modem already holds exactly
+ * this content, so the +CCERTDOWN upload only happens when the certificate
+ * changed or the modem was swapped. Because the hash lives in the modem's
+ * own file name it survives ESP32 reflashes and needs no NVS.
+ *
+ * cert_upload() keeps the caller's file name (downloadCertificate()) and
+ * records the content hash in a small marker file next to it
+ * ("ca.pem" gets "ca.pem.1a2b3c4d.der"), so an unchanged certificate is not
+ * uploaded again either.
+ *
+ * cert_bind() issues the +CSSLCFG binding for an SSL context only when it
+ * differs from the last one issued. The modem forgets its SSL context
+ * configuration on reset, so call cert_forget() whenever it was power cycled
+ * outside of init()/restart().
+ */
+#ifndef SRC_TINYGSMCERTSTORE_H_
+#define SRC_TINYGSMCERTSTORE_H_
+
+#include "TinyGsmCommon.h"
+
+#define TINY_GSM_MODEM_HAS_CERT_STORE
+
+#ifndef TINY_GSM_CERT_LIST_SIZE
+#define TINY_GSM_CERT_LIST_SIZE 16
+#endif
+#define TINY_GSM_CERT_CTX_COUNT 10
+
+enum TinyGsmCertSlot {
+    CERT_SLOT_CA = 0,
+    CERT_SLOT_CLIENT_CERT,
+    CERT_SLOT_CLIENT_KEY,
+    CERT_SLOT_COUNT
+};
+
+template <class modemType>
+class TinyGsmCertStore
+{
+public:
+    /**
+     * @brief Lists the certificate files stored on the modem
+     *
+     * @param names Array that receives the file names, may be NULL
+     * @param maxNames Capacity of names
+     * @return Number of files on the modem, -1 if the query failed
+     */
+    int cert_list(String names[], int maxNames)
+    {
+        _listCount = 0;
+        _listValid = false;
+        int count = 0;
+        thisModem().sendAT("+CCERTLIST");
+        // +CCERTLIST: "<name>" per file, then OK
+        while (true) {
+            int8_t res = thisModem().waitResponse(5000UL, GF("+CCERTLIST: "), GFP(GSM_OK), GFP(GSM_ERROR));
+            if (res == 2) break;
+            if (res != 1) return -1;
+            thisModem().streamSkipUntil('"');
+            String name = thisModem().stream.readStringUntil('"');
+            thisModem().streamSkipUntil('\n');
+            if (names && count < maxNames) names[count] = name;
+            if (_listCount < TINY_GSM_CERT_LIST_SIZE) {
+                _list[_listCount++] = cert_hash(name.c_str(), name.length());
+            }
+            count++;
+        }
+        // A list too long for the cache cannot answer "not present" reliably
+        _listValid = count <= TINY_GSM_CERT_LIST_SIZE;
+        return count;
+    }
+
+    /**
+     * @brief Checks whether a certificate file exists on the modem
+     *
+     * The file list is queried once and cached until cert_forget().
+     */
+    bool cert_exists(const String &filename)
+    {
+        if (!_listValid && cert_list(NULL, 0) < 0) return false;
+        uint32_t h = cert_hash(filename.c_str(), filename.length());
+        for (uint8_t i = 0; i < _listCount; i++) {
+            if (_list[i] == h) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Makes sure the modem holds pem, uploading it only if needed
+     *
+     * Older versions of the same certificate (same base name, different
+     * hash) are deleted after a successful upload.
+     *
+     * @param filename Base name ending in ".pem" or ".der", e.g. "ca_cert.pem"
+     * @param pem Certificate content
+     * @return Name of the file on the modem, empty on failure
+     */
+    String cert_sync(const char *filename, const char *pem)
+    {
+        String base = filename;
+        if (!pem || (!base.endsWith(".pem") && !base.endsWith(".der"))) {
+            DBG("The file name must have type like \".pem\" or \".der\". ");
+            return "";
+        }
+        String ext = base.substring(base.length() - 4);
+        base.remove(base.length() - 4);
+
+        char suffix[10];
+        snprintf(suffix, sizeof(suffix), "-%08lx", (unsigned long)cert_hash(pem, strlen(pem)));
+        String stored = base + suffix + ext;
+        if (stored.length() - 4 > 108) {
+            DBG("The length of filename is from 5 to 108 bytes.");
+            return "";
+        }
+        // Names are kept so older copies can be removed after an upload
+        String old[TINY_GSM_CERT_LIST_SIZE];
+        int count = -1;
+        if (!_listValid) count = cert_list(old, TINY_GSM_CERT_LIST_SIZE);
+        if (cert_exists(stored)) {
+            _reused++;
+            return stored;
+        }
+        if (count < 0) count = cert_list(old, TINY_GSM_CERT_LIST_SIZE);
+
+        if (!cert_download(stored, pem, strlen(pem))) return "";
+        _uploaded++;
+        _uploadedBytes += strlen(pem);
+
+        String prefix = base + "-";
+        for (int i = 0; i < count && i < TINY_GSM_CERT_LIST_SIZE; i++) {
+            if (old[i].startsWith(prefix) && old[i].endsWith(ext) &&
+                    old[i].length() == stored.length()) {
+                cert_delete(old[i]);
+            }
+        }
+        // The next lookup re-reads the list
+        _listValid = false;
+        return stored;
+    }
+
+    /**
+     * @brief Makes sure the modem holds pem under filename
+     *
+     * The file keeps the caller's name. The content hash is kept in a marker
+     * file on the modem ("<filename>.<hash>.der"), so calling this on every
+     * boot uploads nothing unless pem changed. Copies stored by cert_sync()
+     * under the same base name are removed.
+     *
+     * @param filename Name ending in ".pem" or ".der", e.g. "ca_cert.pem"
+     * @param pem Certificate content
+     * @return true if the modem holds pem under filename
+     */
+    bool cert_upload(const String &filename, const char *pem)
+    {
+        if (!pem || (!filename.endsWith(".pem") && !filename.endsWith(".der"))) {
+            DBG("The file name must have type like \".pem\" or \".der\". ");
+            return false;
+        }
+        char hash[9];
+        snprintf(hash, sizeof(hash), "%08lx", (unsigned long)cert_hash(pem, strlen(pem)));
+        String marker = filename + "." + hash + ".der";
+        // Without room for a marker every call uploads
+        bool tracked = marker.length() <= 108;
+
+        String old[TINY_GSM_CERT_LIST_SIZE];
+        int count = cert_list(old, TINY_GSM_CERT_LIST_SIZE);
+        if (tracked && cert_exists(filename) && cert_exists(marker)) {
+            _reused++;
+            return true;
+        }
+
+        // A stale marker must be gone before the file changes, or an upload
+        // that fails halfway would leave it vouching for the wrong content
+        String ext = filename.substring(filename.length() - 4);
+        String base = filename.substring(0, filename.length() - 4);
+        for (int i = 0; i < count && i < TINY_GSM_CERT_LIST_SIZE; i++) {
+            if (old[i].startsWith(filename + ".") && old[i].endsWith(".der") &&
+                    old[i].length() == filename.length() + 13) {
+                cert_delete(old[i]);
+            }
+        }
+        _listValid = false;
+        if (!cert_download(filename, pem, strlen(pem))) return false;
+        _uploaded++;
+        _uploadedBytes += strlen(pem);
+        if (tracked) cert_download(marker, hash, 8);
+
+        // Content-addressed copies from cert_sync() of the same name
+        for (int i = 0; i < count && i < TINY_GSM_CERT_LIST_SIZE; i++) {
+            if (old[i].startsWith(base + "-") && old[i].endsWith(ext) &&
+                    old[i].length() == filename.length() + 9) {
+                cert_delete(old[i]);
+            }
+        }
+        // The file may be bound already; make sure the next connect re-applies it
+        cert_forget();
+        return true;
+    }
+
+    /**
+     * @brief Deletes a file stored with cert_upload() and its marker
+     *
+     * @return true if the certificate file was deleted
+     */
+    bool cert_remove(const String &filename)
+    {
+        String old[TINY_GSM_CERT_LIST_SIZE];
+        int count = cert_list(old, TINY_GSM_CERT_LIST_SIZE);
+        for (int i = 0; i < count && i < TINY_GSM_CERT_LIST_SIZE; i++) {
+            if (old[i].startsWith(filename + ".") && old[i].endsWith(".der") &&
+                    old[i].length() == filename.length() + 13) {
+                cert_delete(old[i]);
+            }
+        }
+        bool ok = cert_delete(filename);
+        cert_forget();
+        return ok;
+    }
+
+    /**
+     * @brief Points an SSL context at a certificate file
+     *
+     * Skips the +CSSLCFG command when the context is already bound to it.
+     *
+     * @param ctx SSL context index (0-9)
+     * @param slot Which certificate of the context to set
+     * @param filename File on the modem
+     * @return true if the context is bound to filename
+     */
+    bool cert_bind(uint8_t ctx, TinyGsmCertSlot slot, const String &filename)
+    {
+        static const char *const keys[CERT_SLOT_COUNT] = { "cacert", "clientcert", "clientkey" };
+        if (ctx >= TINY_GSM_CERT_CTX_COUNT || slot >= CERT_SLOT_COUNT) return false;
+        uint32_t h = cert_hash(filename.c_str(), filename.length());
+        if (_bound[ctx][slot] == h) return true;
+        thisModem().sendAT("+CSSLCFG=\"", keys[slot], "\",", ctx, ",\"", filename, "\"");
+        if (thisModem().waitResponse(5000UL) != 1) {
+            _bound[ctx][slot] = 0;
+            return false;
+        }
+        _bound[ctx][slot] = h;
+        return true;
+    }
+
+    /**
+     * @brief Drops the cached file list and context bindings
+     *
+     * Needed after the modem was reset, which clears the SSL contexts.
+     */
+    void cert_forget()
+    {
+        _listValid = false;
+        _listCount = 0;
+        memset(_bound, 0, sizeof(_bound));
+    }
+
+    // Certificates found already on the modem / uploaded, since boot
+    uint32_t cert_reused() const
+    {
+        return _reused;
+    }
+    uint32_t cert_uploaded() const
+    {
+        return _uploaded;
+    }
+    uint32_t cert_uploaded_bytes() const
+    {
+        return _uploadedBytes;
+    }
+
+protected:
+    // +CCERTDOWN of len bytes under name
+    bool cert_download(const String &name, const char *data, size_t len)
+    {
+        thisModem().sendAT("+CCERTDOWN=\"", name, "\",", len);
+        if (thisModem().waitResponse(10000UL, ">") != 1) {
+            return false;
+        }
+        thisModem().stream.write((const uint8_t *)data, len);
+        if (thisModem().waitResponse(10000UL) != 1) {
+            DBG("Download certificate failed !");
+            _listValid = false;
+            return false;
+        }
+        return true;
+    }
+
+    bool cert_delete(const String &name)
+    {
+        thisModem().sendAT("+CCERTDELE=\"", name, "\"");
+        return thisModem().waitResponse(3000UL) == 1;
+    }
+
+    // FNV-1a; never 0, which marks an unbound slot
+    static uint32_t cert_hash(const char *data, size_t len)
+    {
+        uint32_t h = 2166136261UL;
+        for (size_t i = 0; i < len; i++) {
+            h ^= (uint8_t)data[i];
+            h *= 16777619UL;
+        }
+        return h ? h : 1;
+    }
+
+    /*
+     * CRTP Helper
+     */
+    inline const modemType &thisModem() const
+    {
+        return static_cast<const modemType &>(*this);
+    }
+    inline modemType &thisModem()
+    {
+        return static_cast<modemType &>(*this);
+    }
+
+    uint32_t _list[TINY_GSM_CERT_LIST_SIZE];
+    uint8_t  _listCount = 0;
+    bool     _listValid = false;
+    uint32_t _bound[TINY_GSM_CERT_CTX_COUNT][CERT_SLOT_COUNT] = {};
+    uint32_t _reused = 0;
+    uint32_t _uploaded = 0;
+    uint32_t _uploadedBytes = 0;
+};
+
+#endif  // SRC_TINYGSMCERTSTORE_H_
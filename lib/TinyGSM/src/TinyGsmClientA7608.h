@@ -19,6 +19,7 @@
 #include "TinyGsmClientA76xx.h"
 #include "TinyGsmMqttA76xx.h"
 #include "TinyGsmHttpsComm.h"
+#include "TinyGsmCertStore.tpp"
 #include "TinyGsmTCP.tpp"
 #include "TinyGsmFSComm.tpp"
 
@@ -34,13 +35,15 @@ class TinyGsmA7608 :    public TinyGsmA76xx<TinyGsmA7608>,
                         public TinyGsmTCP<TinyGsmA7608, TINY_GSM_MUX_COUNT>,
                         public TinyGsmMqttA76xx<TinyGsmA7608, TINY_GSM_MQTT_CLI_COUNT>,
                         public TinyGsmHttpsComm<TinyGsmA7608,ASR_A7608X>,
-                        public TinyGsmFSComm<TinyGsmA7608,ASR_A7608X>
+                        public TinyGsmFSComm<TinyGsmA7608,ASR_A7608X>,
+                        public TinyGsmCertStore<TinyGsmA7608>
                         {
   friend class TinyGsmA76xx<TinyGsmA7608>;
   friend class TinyGsmTCP<TinyGsmA7608, TINY_GSM_MUX_COUNT>;
   friend class TinyGsmMqttA76xx<TinyGsmA7608, TINY_GSM_MQTT_CLI_COUNT>;
   friend class TinyGsmHttpsComm<TinyGsmA7608,ASR_A7608X>;
   friend class TinyGsmFSComm<TinyGsmA7608,ASR_A7608X>;
+  friend class TinyGsmCertStore<TinyGsmA7608>;
   /*
    * Inner Client
    */
@@ -123,6 +126,9 @@ class TinyGsmA7608 :    public TinyGsmA76xx<TinyGsmA7608>,
 
     if (!testAT()) { return false; }
 
+    // A reset cleared the SSL context bindings
+    cert_forget();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
@@ -518,6 +524,7 @@ class TinyGsmA7608 :    public TinyGsmA76xx<TinyGsmA7608>,
       }
     } while (millis() - startMillis < timeout_ms);
   finish:
+    TINY_GSM_AT_RESPONSE(index);
     if (!index) {
       data.trim();
       if (data.length()) { DBG("### Unhandled:", data); }
@@ -19,6 +19,7 @@
 #include "TinyGsmClientA76xx.h"
 #include "TinyGsmMqttA76xx.h"
 #include "TinyGsmHttpsComm.h"
+#include "TinyGsmCertStore.tpp"
 #include "TinyGsmTCP.tpp"
 #include "TinyGsmFSComm.tpp"
 
@@ -41,12 +42,14 @@ class TinyGsmA7670 :  public TinyGsmA76xx<TinyGsmA7670>,
                       public TinyGsmTCP<TinyGsmA7670, TINY_GSM_MUX_COUNT>,
                       public TinyGsmMqttA76xx<TinyGsmA7670, TINY_GSM_MQTT_CLI_COUNT>,
                       public TinyGsmHttpsComm<TinyGsmA7670,ASR_A7670X>, 
-                      public TinyGsmFSComm<TinyGsmA7670,ASR_A7670X>{
+                      public TinyGsmFSComm<TinyGsmA7670,ASR_A7670X>,
+                      public TinyGsmCertStore<TinyGsmA7670> {
   friend class TinyGsmA76xx<TinyGsmA7670>;
   friend class TinyGsmTCP<TinyGsmA7670, TINY_GSM_MUX_COUNT>;
   friend class TinyGsmMqttA76xx<TinyGsmA7670, TINY_GSM_MQTT_CLI_COUNT>;
   friend class TinyGsmHttpsComm<TinyGsmA7670,ASR_A7670X>;
   friend class TinyGsmFSComm<TinyGsmA7670,ASR_A7670X>;
+  friend class TinyGsmCertStore<TinyGsmA7670>;
 
   /*
    * Inner Client
@@ -130,6 +133,9 @@ class TinyGsmA7670 :  public TinyGsmA76xx<TinyGsmA7670>,
 
     if (!testAT()) { return false; }
 
+    // A reset cleared the SSL context bindings
+    cert_forget();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
@@ -525,6 +531,7 @@ class TinyGsmA7670 :  public TinyGsmA76xx<TinyGsmA7670>,
       }
     } while (millis() - startMillis < timeout_ms);
   finish:
+    TINY_GSM_AT_RESPONSE(index);
     if (!index) {
       data.trim();
       if (data.length()) { DBG("### Unhandled:", data); }
@@ -22,6 +22,7 @@
 #include "TinyGsmSSL.tpp"
 #include "TinyGsmMqttA76xx.h"
 #include "TinyGsmHttpsComm.h"
+#include "TinyGsmCertStore.tpp"
 
 // Websocket callback function
 typedef void (*websocket_cb_t)(const uint8_t* buffer, size_t length);
@@ -31,12 +32,14 @@ class TinyGsmA76xxSSL : public TinyGsmA76xx<TinyGsmA76xxSSL>,
                         public TinyGsmTCP<TinyGsmA76xxSSL, TINY_GSM_MUX_COUNT>,
                         public TinyGsmSSL<TinyGsmA76xxSSL>,
                         public TinyGsmMqttA76xx<TinyGsmA76xxSSL, TINY_GSM_MQTT_CLI_COUNT>,
-                        public TinyGsmHttpsComm<TinyGsmA76xxSSL,ASR_A7670X> {
+                        public TinyGsmHttpsComm<TinyGsmA76xxSSL,ASR_A7670X>,
+                        public TinyGsmCertStore<TinyGsmA76xxSSL> {
   friend class TinyGsmA76xx<TinyGsmA76xxSSL>;
   friend class TinyGsmTCP<TinyGsmA76xxSSL, TINY_GSM_MUX_COUNT>;
   friend class TinyGsmSSL<TinyGsmA76xxSSL>;
   friend class TinyGsmMqttA76xx<TinyGsmA76xxSSL, TINY_GSM_MQTT_CLI_COUNT>;
   friend class TinyGsmHttpsComm<TinyGsmA76xxSSL,ASR_A7670X>;
+  friend class TinyGsmCertStore<TinyGsmA76xxSSL>;
 
   /*
    * Inner Client
@@ -156,6 +159,9 @@ class TinyGsmA76xxSSL : public TinyGsmA76xx<TinyGsmA76xxSSL>,
 
     if (!testAT()) { return false; }
 
+    // A reset cleared the SSL context bindings
+    cert_forget();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
@@ -386,22 +392,12 @@ class TinyGsmA76xxSSL : public TinyGsmA76xx<TinyGsmA76xxSSL>,
       DBG("The length of filename is from 5 to 108 bytes.");
       return false;
     }
-    sendAT("+CCERTDOWN=", "\"", filename, "\"", ",", strlen(buffer));
-    if (waitResponse(10000UL, ">") == 1) {
-      stream.write(buffer);
-    } else {
-      return false;
-    }
-    if (waitResponse(3000UL) != 1) {
-      DBG("Download certificate failed !");
-      return false;
-    }
-    return true;
+    // Skipped when the modem already holds this content under filename
+    return cert_upload(filename, buffer);
   }
 
   bool deleteCertificateImpl(const char* filename) {
-    sendAT("+CCERTDELE=\"", filename, "\"");
-    if (waitResponse(3000UL) != 1) {
+    if (!cert_remove(filename)) {
       DBG("Delete certificate failed !");
       return false;
     }
@@ -450,24 +446,18 @@ class TinyGsmA76xxSSL : public TinyGsmA76xx<TinyGsmA76xxSSL>,
       if (certificates[mux] != "") {
         // apply the correct certificate to the connection
         // AT+CSSLCFG="cacert",<ssl_ctx_index>,<ca_file>
-        sendAT(GF("+CSSLCFG=\"cacert\","), mux, ',', GF("\""), certificates[mux].c_str(),
-               GF("\""));
-        if (waitResponse(5000L) != 1) return false;
+        if (!cert_bind(mux, CERT_SLOT_CA, certificates[mux])) return false;
         authmode = 1;
       }
 
       if (client_certificate[mux] != "") {
         // AT+CSSLCFG="clientcert",<ssl_ctx_index>,<clientcert_file>
-        sendAT(GF("+CSSLCFG=\"clientcert\","), mux, ',', GF("\""),
-               client_certificate[mux].c_str(), GF("\""));
-        if (waitResponse(5000L) != 1) return false;
+        if (!cert_bind(mux, CERT_SLOT_CLIENT_CERT, client_certificate[mux])) return false;
       }
 
       if (client_private_key[mux] != "") {
         // AT+CSSLCFG="clientkey",<ssl_ctx_index>,<clientkey_file>
-        sendAT(GF("+CSSLCFG=\"clientkey\","), mux, ',', GF("\""),
-               client_private_key[mux].c_str(), GF("\""));
-        if (waitResponse(5000L) != 1) return false;
+        if (!cert_bind(mux, CERT_SLOT_CLIENT_KEY, client_private_key[mux])) return false;
       }
 
       if (client_private_key_password[mux] != "") {
@@ -968,6 +958,7 @@ class TinyGsmA76xxSSL : public TinyGsmA76xx<TinyGsmA76xxSSL>,
       }
     } while (millis() - startMillis < timeout_ms);
   finish:
+    TINY_GSM_AT_RESPONSE(index);
     if (!index) {
       data.trim();
       if (data.length()) { DBG("### Unhandled:", data); }
@@ -30,6 +30,7 @@
 #include "TinyGsmGPS_EX.tpp"
 #include "TinyGsmMqttA76xx.h"
 #include "TinyGsmHttpsComm.h"
+#include "TinyGsmCertStore.tpp"
 #include "TinyGsmTextToSpeech.tpp"
 #include "TinyGsmFSComm.tpp"
 
@@ -126,7 +127,8 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
                        public TinyGsmTextToSpeech<TinyGsmSim7600>,
                        public TinyGsmMqttA76xx<TinyGsmSim7600, TINY_GSM_MQTT_CLI_COUNT>,
                        public TinyGsmHttpsComm<TinyGsmSim7600, QUALCOMM_SIM7600G>,
-                       public TinyGsmFSComm<TinyGsmSim7600, QUALCOMM_SIM7600G> {
+                       public TinyGsmFSComm<TinyGsmSim7600, QUALCOMM_SIM7600G>,
+                       public TinyGsmCertStore<TinyGsmSim7600> {
   friend class TinyGsmModem<TinyGsmSim7600>;
   friend class TinyGsmGPRS<TinyGsmSim7600>;
   friend class TinyGsmTCP<TinyGsmSim7600, TINY_GSM_MUX_COUNT>;
@@ -143,6 +145,7 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
   friend class TinyGsmGPSEx<TinyGsmSim7600>;
   friend class TinyGsmTextToSpeech<TinyGsmSim7600>;
   friend class TinyGsmFSComm<TinyGsmSim7600, QUALCOMM_SIM7600G>;
+  friend class TinyGsmCertStore<TinyGsmSim7600>;
 
   /*
    * Inner Client
@@ -246,6 +249,9 @@ class TinyGsmSim7600 : public TinyGsmModem<TinyGsmSim7600>,
 
     if (!testAT()) { return false; }
 
+    // A reset cleared the SSL context bindings
+    cert_forget();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
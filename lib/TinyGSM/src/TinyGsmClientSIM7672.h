@@ -28,6 +28,7 @@
 #include "TinyGsmNTP.tpp"
 #include "TinyGsmMqttA76xx.h"
 #include "TinyGsmHttpsComm.h"
+#include "TinyGsmCertStore.tpp"
 #include "TinyGsmGPS_EX.tpp"
 #include "TinyGsmFSComm.tpp"
 
@@ -88,7 +89,8 @@ class TinyGsmSim7672 : public TinyGsmModem<TinyGsmSim7672>,
                        public TinyGsmMqttA76xx<TinyGsmSim7672, TINY_GSM_MQTT_CLI_COUNT>,
                        public TinyGsmGPSEx<TinyGsmSim7672>,
                        public TinyGsmHttpsComm<TinyGsmSim7672,QUALCOMM_SIM7670G>,
-                       public TinyGsmFSComm<TinyGsmSim7672,QUALCOMM_SIM7670G> 
+                       public TinyGsmFSComm<TinyGsmSim7672,QUALCOMM_SIM7670G>,
+                       public TinyGsmCertStore<TinyGsmSim7672>
 {
   friend class TinyGsmModem<TinyGsmSim7672>;
   friend class TinyGsmGPRS<TinyGsmSim7672>;
@@ -105,6 +107,7 @@ class TinyGsmSim7672 : public TinyGsmModem<TinyGsmSim7672>,
   friend class TinyGsmHttpsComm<TinyGsmSim7672,QUALCOMM_SIM7670G>;
   friend class TinyGsmGPSEx<TinyGsmSim7672>;
   friend class TinyGsmFSComm<TinyGsmSim7672,QUALCOMM_SIM7670G>;
+  friend class TinyGsmCertStore<TinyGsmSim7672>;
 
 
   /*
@@ -209,6 +212,9 @@ class TinyGsmSim7672 : public TinyGsmModem<TinyGsmSim7672>,
 
     if (!testAT()) { return false; }
 
+    // A reset cleared the SSL context bindings
+    cert_forget();
+
     sendAT(GF("E0"));  // Echo Off
     if (waitResponse() != 1) { return false; }
 
@@ -1168,6 +1174,7 @@ class TinyGsmSim7672 : public TinyGsmModem<TinyGsmSim7672>,
       }
     } while (millis() - startMillis < timeout_ms);
   finish:
+    TINY_GSM_AT_RESPONSE(index);
     if (!index) {
       data.trim();
       if (data.length()) { DBG("### Unhandled:", data); }
@@ -32,12 +32,19 @@
 #define TINY_GSM_YIELD_MS 0
 #endif
 
-#ifdef BOARD_HAS_PSRAM
+#if defined(TINY_GSM_USE_POOL)
+// Buffers come from the long-lived arena in TinyGsmPool.h
+#define TINY_GSM_MALLOC(n)     TinyGsmPool::shared().alloc(n)
+#define TINY_GSM_REALLOC(p, n) TinyGsmPool::shared().realloc(p, n)
+#define TINY_GSM_FREE(p)       TinyGsmPool::shared().free(p)
+#elif defined(BOARD_HAS_PSRAM)
 #define TINY_GSM_MALLOC       ps_malloc
 #define TINY_GSM_REALLOC      ps_realloc
+#define TINY_GSM_FREE         free
 #else
 #define TINY_GSM_MALLOC       malloc
 #define TINY_GSM_REALLOC      realloc
+#define TINY_GSM_FREE         free
 #endif
 
 
@@ -46,6 +53,17 @@
   { delay(TINY_GSM_YIELD_MS); }
 #endif
 
+// Optional instrumentation hooks, e.g. for AT command latency metrics.
+// TINY_GSM_AT_SENT() runs after each command is flushed to the modem,
+// TINY_GSM_AT_RESPONSE(index) when waitResponse() returns (0 = timeout).
+#ifndef TINY_GSM_AT_SENT
+#define TINY_GSM_AT_SENT()
+#endif
+
+#ifndef TINY_GSM_AT_RESPONSE
+#define TINY_GSM_AT_RESPONSE(index)
+#endif
+
 #define TINY_GSM_ATTR_NOT_AVAILABLE \
   __attribute__((error("Not available on this modem type")))
 #define TINY_GSM_ATTR_NOT_IMPLEMENTED __attribute__((error("Not implemented")))
@@ -125,6 +143,10 @@ uint32_t TinyGsmAutoBaud(T& SerialAT, uint32_t minimum = 9600,
   return 0;
 }
 
+#if defined(TINY_GSM_USE_POOL)
+#include "TinyGsmPool.h"
+#endif
+
 enum ModemPlatform {
     ASR_A7670X,
     ASR_A7608X,
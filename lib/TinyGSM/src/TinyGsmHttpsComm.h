@@ -26,6 +26,16 @@ enum HttpMethod {
   TINYGSM_HTTP_PATCH,
 };
 
+// Counters behind https_report(); times are in milliseconds
+struct HttpsStats {
+  uint32_t sessions;      // +HTTPINIT issued
+  uint32_t reused;        // https_begin() served by an open session
+  uint32_t requests;      // +HTTPACTION issued
+  uint32_t setupMs;       // spent in +HTTPTERM/+HTTPINIT
+  uint32_t actionMs;      // from +HTTPACTION to its result
+  uint32_t lastActionMs;
+};
+
 
 template <class modemType, ModemPlatform platform>
 class TinyGsmHttpsComm {
@@ -37,18 +47,17 @@ class TinyGsmHttpsComm {
    * It prepares the necessary resources and configurations for the subsequent HTTPS
    * operations.
    *
+   * With keep-alive enabled an already open session is reused, so the
+   * modem can keep its connection (and TLS session) to the server.
+   *
    * @return true if the initialization is successful, false otherwise.
    */
   bool https_begin() {
-    https_end();
-
-    delay(100);
-
-    thisModem().sendAT("+HTTPINIT");
-    if (thisModem().waitResponse(10000UL) != 1) { return false; }
-
-
-    return true;
+    if (_keepAlive && _sessionOpen) {
+      _stats.reused++;
+      return true;
+    }
+    return https_open_session();
   }
 
   /**
@@ -56,11 +65,68 @@ class TinyGsmHttpsComm {
    *
    * This function is used to end the HTTPS connection.
    * It releases the resources allocated during the connection and cleans up the related
-   * configurations.
+   * configurations. With keep-alive enabled the session stays open until
+   * https_close() is called.
    */
   void https_end() {
+    if (_keepAlive && _sessionOpen) { return; }
+    https_close();
+  }
+
+  /**
+   * @brief Terminate the HTTP service regardless of keep-alive.
+   */
+  void https_close() {
     thisModem().sendAT("+HTTPTERM");
     thisModem().waitResponse(3000);
+    _sessionOpen = false;
+  }
+
+  /**
+   * @brief Keep one HTTP session open across requests.
+   *
+   * A HEAD or manifest check followed by the body fetch then costs one
+   * +HTTPINIT and, when the firmware keeps the connection to an unchanged
+   * host, one TLS handshake. Headers set with https_add_header() persist
+   * for the whole session. Call https_close() when done, and
+   * https_forget_session() if the modem was reset behind the library's back.
+   *
+   * @param enable true to keep sessions open
+   */
+  void https_set_keep_alive(bool enable) {
+    _keepAlive = enable;
+  }
+
+  void https_forget_session() {
+    _sessionOpen = false;
+  }
+
+  const HttpsStats& https_stats() const {
+    return _stats;
+  }
+
+  /**
+   * @brief Print request timing and what keep-alive saved.
+   *
+   * The saving is estimated from the average cost of the sessions that were
+   * set up; that modem-awake time is also where the energy goes.
+   */
+  void https_report(Print& out) const {
+    uint32_t avgSetup  = _stats.sessions ? _stats.setupMs / _stats.sessions : 0;
+    uint32_t avgAction = _stats.requests ? _stats.actionMs / _stats.requests : 0;
+    out.print("HTTPS: ");
+    out.print(_stats.requests);
+    out.print(" requests, ");
+    out.print(_stats.sessions);
+    out.print(" sessions (");
+    out.print(_stats.reused);
+    out.print(" reused), setup avg ");
+    out.print(avgSetup);
+    out.print(" ms, request avg ");
+    out.print(avgAction);
+    out.print(" ms, saved ~");
+    out.print(_stats.reused * avgSetup);
+    out.println(" ms");
   }
 
   /**
@@ -75,17 +141,11 @@ class TinyGsmHttpsComm {
    * @return true if the URL and SSL version are set successfully, false otherwise.
    */
   bool https_set_url(const String& url, ServerSSLVersion ssl_version = TINYGSM_SSL_AUTO, bool enableSNI = true) {
-    // https://github.com/Xinyuan-LilyGO/LilyGO-T-A76XX/issues/243
-    // Set SSL Version
-    thisModem().sendAT("+CSSLCFG=\"sslversion\",0,", ssl_version);
-    thisModem().waitResponse();
-
-    // Set SNI
-    thisModem().sendAT("+CSSLCFG=\"enableSNI\",0,", enableSNI ? 1 : 0);
-    thisModem().waitResponse();
-
-    thisModem().sendAT("+HTTPPARA=\"URL\",", "\"", url, "\"");
-    return thisModem().waitResponse(3000) == 1;
+    if (https_apply_url(url, ssl_version, enableSNI)) { return true; }
+    if (!_keepAlive || !_sessionOpen) { return false; }
+    // The kept session may have died with a modem reset; start a new one
+    if (!https_open_session()) { return false; }
+    return https_apply_url(url, ssl_version, enableSNI);
   }
 
   /**
@@ -235,15 +295,20 @@ class TinyGsmHttpsComm {
   int https_get(size_t* bodyLength = NULL) {
     thisModem().sendAT("+HTTPACTION=0");
     if (thisModem().waitResponse(3000) != 1) { return false; }
-    if (thisModem().waitResponse(60000UL, "+HTTPACTION: ") == 1) {
-      int    action = thisModem().streamGetIntBefore(',');
-      int    status = thisModem().streamGetIntBefore(',');
-      size_t length = thisModem().streamGetLongLongBefore('\r');
-      log_d("Method:%d http code:%d length:%u", action, status, length);
-      if (bodyLength) { *bodyLength = length; }
-      return status;
-    }
-    return -1;
+    return https_wait_action(bodyLength);
+  }
+
+  /**
+   * @brief Send a HEAD request, e.g. to check a resource before fetching it.
+   *
+   * @param bodyLength Receives the Content-Length the server reported. Defaults
+   * to NULL.
+   * @return The HTTP status code of the response, -1 on failure.
+   */
+  int https_head(size_t* bodyLength = NULL) {
+    thisModem().sendAT("+HTTPACTION=", TINYGSM_HTTP_HEAD);
+    if (thisModem().waitResponse(3000) != 1) { return -1; }
+    return https_wait_action(bodyLength);
   }
 
   /**
@@ -268,7 +333,7 @@ class TinyGsmHttpsComm {
       return "";
     }
     if (thisModem().stream.readBytes(buffer, length) != length) {
-      free(buffer);
+      TINY_GSM_FREE(buffer);
       log_e("readbytes is failed");
       return "";
     }
@@ -276,7 +341,7 @@ class TinyGsmHttpsComm {
     // wait ok
     thisModem().waitResponse();
     String header = String((const char*)buffer);
-    free(buffer);
+    TINY_GSM_FREE(buffer);
     return header;
   }
 
@@ -326,19 +391,19 @@ class TinyGsmHttpsComm {
     log_v("malloc memory %u bytes", total + 1);
     thisModem().sendAT("+HTTPREAD=0,", total);
     if (thisModem().waitResponse(3000) != 1) {
-      free(buffer);
+      TINY_GSM_FREE(buffer);
       return "";
     }
     do {
       if (!https_wait_body_respond()) {
-        free(buffer);
+        TINY_GSM_FREE(buffer);
         return "";
       }
       int length = thisModem().streamGetIntBefore('\n');
       log_v("length = %d total:%d offset:%d", length, total, offset);
       if (length == -9999) { break; }
       if (thisModem().stream.readBytes(buffer + offset, length) != length) {
-        free(buffer);
+        TINY_GSM_FREE(buffer);
         return "";
       }
       offset += length;
@@ -346,7 +411,7 @@ class TinyGsmHttpsComm {
     thisModem().waitResponse(5000UL, "+HTTPREAD: 0");
     buffer[total] = '\0';
     String body   = String((const char*)buffer);
-    free(buffer);
+    TINY_GSM_FREE(buffer);
     return body;
   }
 
@@ -511,6 +576,58 @@ class TinyGsmHttpsComm {
   }
 
  private:
+  bool https_apply_url(const String& url, ServerSSLVersion ssl_version, bool enableSNI) {
+    // https://github.com/Xinyuan-LilyGO/LilyGO-T-A76XX/issues/243
+    // The SSL context only needs configuring once per session
+    if (_sslVersion != ssl_version || _sni != (enableSNI ? 1 : 0)) {
+      // Set SSL Version
+      thisModem().sendAT("+CSSLCFG=\"sslversion\",0,", ssl_version);
+      thisModem().waitResponse();
+
+      // Set SNI
+      thisModem().sendAT("+CSSLCFG=\"enableSNI\",0,", enableSNI ? 1 : 0);
+      thisModem().waitResponse();
+
+      _sslVersion = ssl_version;
+      _sni        = enableSNI ? 1 : 0;
+    }
+
+    thisModem().sendAT("+HTTPPARA=\"URL\",", "\"", url, "\"");
+    return thisModem().waitResponse(3000) == 1;
+  }
+
+  bool https_open_session() {
+    uint32_t start = millis();
+    https_close();
+
+    delay(100);
+
+    thisModem().sendAT("+HTTPINIT");
+    bool ok = thisModem().waitResponse(10000UL) == 1;
+    _stats.sessions++;
+    _stats.setupMs += millis() - start;
+    _sessionOpen = ok;
+    _sslVersion  = -1;
+    _sni         = -1;
+    return ok;
+  }
+
+  int https_wait_action(size_t* bodyLength) {
+    uint32_t start = millis();
+    int      status = -1;
+    if (thisModem().waitResponse(60000UL, "+HTTPACTION:") == 1) {
+      int    action = thisModem().streamGetIntBefore(',');
+      status        = thisModem().streamGetIntBefore(',');
+      size_t length = thisModem().streamGetLongLongBefore('\r');
+      log_d("Method:%d http code:%d length:%u", action, status, length);
+      if (bodyLength) { *bodyLength = length; }
+    }
+    _stats.requests++;
+    _stats.lastActionMs = millis() - start;
+    _stats.actionMs += _stats.lastActionMs;
+    return status;
+  }
+
   bool https_wait_header_respond() {
     const char* header_respond = "+HTTPHEAD: ";
     switch (platform) {
@@ -539,14 +656,7 @@ class TinyGsmHttpsComm {
     }
     thisModem().sendAT("+HTTPACTION=", method);
     if (thisModem().waitResponse(3000) != 1) { return -1; }
-    if (thisModem().waitResponse(60000UL, "+HTTPACTION:") == 1) {
-      int    action = thisModem().streamGetIntBefore(',');
-      int    status = thisModem().streamGetIntBefore(',');
-      size_t length = thisModem().streamGetLongLongBefore('\r');
-      log_d("Method:%d http code:%d length:%u", action, status, length);
-      return status;
-    }
-    return -1;
+    return https_wait_action(NULL);
   }
   /*
    * CRTP Helper
@@ -558,4 +668,10 @@ class TinyGsmHttpsComm {
   inline modemType& thisModem() {
     return static_cast<modemType&>(*this);
   }
+
+  bool       _keepAlive   = false;
+  bool       _sessionOpen = false;
+  int8_t     _sslVersion  = -1;
+  int8_t     _sni         = -1;
+  HttpsStats _stats       = {};
 };
@@ -328,17 +328,17 @@ public:
         }
         thisModem().sendAT("+SHREAD=0,", total);
         if (thisModem().waitResponse(3000) != 1) {
-            free(buffer);
+            TINY_GSM_FREE(buffer);
             return "";
         }
         do {
             if (thisModem().waitResponse(30000UL, "+SHREAD: ") != 1) {
-                free(buffer);
+                TINY_GSM_FREE(buffer);
                 return "";
             }
             int length = thisModem().streamGetIntBefore('\n');
             if (thisModem().stream.readBytes(buffer + offset, length) != length) {
-                free(buffer);
+                TINY_GSM_FREE(buffer);
                 return "";
             }
             offset += length;
@@ -346,7 +346,7 @@ public:
         thisModem().waitResponse(5000UL, "+SHREAD: 0");
         buffer[total] = '\0';
         String body   = String((const char *)buffer);
-        free(buffer);
+        TINY_GSM_FREE(buffer);
         return body;
     }
 
@@ -27,6 +27,7 @@ class TinyGsmModem {
   inline void sendAT(Args... cmd) {
     thisModem().streamWrite("AT", cmd..., thisModem().gsmNL);
     thisModem().stream.flush();
+    TINY_GSM_AT_SENT();
     TINY_GSM_YIELD(); /* DBG("### AT:", cmd...); */
   }
   void setBaud(uint32_t baud) {
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "TinyGsmCommon.h"
+#include "TinyGsmCertStore.tpp"
 
 #define TINY_GSM_MQTT_CLI_COUNT 2
 
@@ -16,12 +17,23 @@ class TinyGsmMqttA76xx
 {
 public:
     typedef void (*callback_t)(const char *, const uint8_t *, uint32_t);
+    // Streaming receive: begin(client, topic, payload_total_len) once per message
+    // (topic is only valid during the call),
+    // chunk(client, data, len, offset) for each piece of payload as it is read
+    // from the modem, end(client, complete) when +CMQTTRXEND arrives or the
+    // message is abandoned
+    typedef void (*stream_begin_t)(uint8_t, const char *, uint32_t);
+    typedef void (*stream_chunk_t)(uint8_t, const uint8_t *, size_t, uint32_t);
+    typedef void (*stream_end_t)(uint8_t, bool);
 protected:
     bool __ssl = false;
     bool __sni = false;
     uint8_t *buffer = NULL;
     uint32_t bufferSize = 256;
     callback_t callback;
+    stream_begin_t stream_begin = NULL;
+    stream_chunk_t stream_chunk = NULL;
+    stream_end_t stream_end = NULL;
     const char  *cert_pem;           /*!< SSL server certification, PEM format as string, if the client requires to verify server */
     const char  *client_cert_pem;    /*!< SSL client certification, PEM format as string, if the server requires to verify client */
     const char  *client_key_pem;     /*!< SSL client key, PEM format as string, if the server requires to verify client */
@@ -71,7 +83,7 @@ public:
     bool mqtt_end()
     {
         if (this->buffer) {
-            free(this->buffer);
+            TINY_GSM_FREE(this->buffer);
             this->buffer = NULL;
         }
         _isConnected = false;
@@ -116,43 +128,27 @@ public:
         }
 
         if (this->cert_pem || this->client_cert_pem || this->client_key_pem) {
+            // Uploaded only when the modem does not hold this exact PEM yet
             if (this->cert_pem) {
-                thisModem().sendAT("+CCERTDOWN=\"ca_cert.pem\",", strlen(this->cert_pem));
-                if (thisModem().waitResponse(10000UL, ">") == 1) {
-                    thisModem().stream.write(this->cert_pem);
-                }
-                if (thisModem().waitResponse() != 1) {
+                String file = thisModem().cert_sync("ca_cert.pem", this->cert_pem);
+                if (file == "" || !thisModem().cert_bind(0, CERT_SLOT_CA, file)) {
                     ESP_LOGE("A76XX", "Write ca_cert pem failed!");
                     return false;
                 }
-                thisModem().sendAT("+CSSLCFG=\"cacert\",0,\"ca_cert.pem\"");
-                thisModem().waitResponse();
-
             }
             if (this->client_cert_pem) {
-                thisModem().sendAT("+CCERTDOWN=\"cert.pem\",", strlen(this->client_cert_pem));
-                if (thisModem().waitResponse(10000UL, ">") == 1) {
-                    thisModem().stream.write(this->client_cert_pem);
-                }
-                if (thisModem().waitResponse() != 1) {
+                String file = thisModem().cert_sync("cert.pem", this->client_cert_pem);
+                if (file == "" || !thisModem().cert_bind(0, CERT_SLOT_CLIENT_CERT, file)) {
                     ESP_LOGE("A76XX", "Write cert pem failed!");
                     return false;
                 }
-                thisModem().sendAT("+CSSLCFG=\"clientcert\",0,\"cert.pem\"");
-                thisModem().waitResponse();
-
             }
             if (this->client_key_pem) {
-                thisModem().sendAT("+CCERTDOWN=\"key_cert.pem\",", strlen(this->client_key_pem));
-                if (thisModem().waitResponse(10000UL, ">") == 1) {
-                    thisModem().stream.write(this->client_key_pem);
-                }
-                if (thisModem().waitResponse() != 1) {
+                String file = thisModem().cert_sync("key_cert.pem", this->client_key_pem);
+                if (file == "" || !thisModem().cert_bind(0, CERT_SLOT_CLIENT_KEY, file)) {
                     ESP_LOGE("A76XX", "Write key_cert failed!");
                     return false;
                 }
-                thisModem().sendAT("+CSSLCFG=\"clientkey\",0,\"key_cert.pem\"");
-                thisModem().waitResponse();
             }
 
             // authMethod:
@@ -249,7 +245,21 @@ public:
     bool mqtt_publish(uint8_t clientIndex, const char *topic, const char *playload,
                       uint8_t qos = 0, uint32_t timeout = 60)
     {
-        if (clientIndex > muxCount) {
+        return mqtt_publish(clientIndex, topic, (const uint8_t *)playload, strlen(playload), qos, timeout);
+    }
+
+    /**
+     * @brief Publish a binary payload of up to 10240 bytes.
+     *
+     * Returns once the modem accepted the message. The broker result arrives
+     * later as a +CMQTTPUB URC, which has no message id, and any AT command
+     * sent before it arrives may swallow it, so use mqtt_publish_wait() when
+     * results must be matched to messages.
+     */
+    bool mqtt_publish(uint8_t clientIndex, const char *topic, const uint8_t *payload, size_t length,
+                      uint8_t qos = 0, uint32_t timeout = 60)
+    {
+        if (clientIndex > muxCount || length == 0) {
             return false;
         }
         // +CMQTTTOPIC: (0-1),(1-1024)
@@ -269,11 +279,11 @@ public:
         // AT+CMQTTPAYLOAD Input the publish message body
         // +CMQTTPAYLOAD: (0-1),(1-10240)
         // <client_index>,<req_length>
-        thisModem().sendAT("+CMQTTPAYLOAD=", clientIndex, ',', strlen(playload));
+        thisModem().sendAT("+CMQTTPAYLOAD=", clientIndex, ',', length);
         if (thisModem().waitResponse(10000UL, ">") != 1) {
             return false;
         }
-        thisModem().stream.write(playload);
+        thisModem().stream.write(payload, length);
         thisModem().stream.println();
         // Wait return OK
         if (thisModem().waitResponse() != 1) {
@@ -288,6 +298,27 @@ public:
         return true;
     }
 
+    /**
+     * @brief Publish a binary payload and wait for its +CMQTTPUB result.
+     *
+     * Returns the err field of the URC (0 = acknowledged by the broker), or
+     * -1 if the modem refused the message or no result arrived within
+     * timeout seconds.
+     */
+    int mqtt_publish_wait(uint8_t clientIndex, const char *topic, const uint8_t *payload, size_t length,
+                          uint8_t qos = 0, uint32_t timeout = 60)
+    {
+        if (!mqtt_publish(clientIndex, topic, payload, length, qos, timeout)) {
+            return -1;
+        }
+        // +CMQTTPUB: <client_index>,<err>
+        if (thisModem().waitResponse(timeout * 1000UL, "+CMQTTPUB: ") != 1) {
+            return -1;
+        }
+        thisModem().streamGetIntBefore(',');
+        return thisModem().streamGetIntBefore('\n');
+    }
+
     bool mqtt_subscribe(uint8_t clientIndex, const char *topic, uint8_t qos = 0, uint8_t dup = 0)
     {
         if (clientIndex > muxCount) {
@@ -400,6 +431,19 @@ public:
     {
         this->callback = cb;
     }
+
+    /**
+     * @brief Deliver received messages incrementally instead of through the
+     * single buffered callback. The RX buffer is only used as a bounce window
+     * of bufferSize bytes, so payloads of any size need constant memory.
+     * Pass NULLs to return to mqtt_set_callback() delivery.
+     */
+    void mqtt_set_stream_callbacks(stream_begin_t begin, stream_chunk_t chunk, stream_end_t end)
+    {
+        this->stream_begin = begin;
+        this->stream_chunk = chunk;
+        this->stream_end = end;
+    }
     /*
 
     +CMQTTRXSTART: 0,17,2039
@@ -415,66 +459,116 @@ public:
     // +CMQTTRXTOPIC: <client_index>, <sub_topic_len><sub_topic>
     bool mqtt_handle(uint32_t timeout = 100)
     {
-        //TODO:More than 1500 bytes will carry the Modem return flag
+        // Payloads larger than the modem's segment size (1500 bytes) arrive as
+        // several +CMQTTRXPAYLOAD blocks between RXSTART and RXEND
         // +CMQTTCONNLOST: 1,1
-        if (thisModem().waitResponse(timeout, "+CMQTTRXSTART:") == 1) {
+        if (thisModem().waitResponse(timeout, "+CMQTTRXSTART:") != 1) {
+            return false;
+        }
+        uint8_t clientIndex = thisModem().streamGetIntBefore(',');
+        size_t topic_total_len =  thisModem().streamGetIntBefore(',');
+        size_t payload_total_len =  thisModem().streamGetIntBefore('\n');
+        if (thisModem().waitResponse(timeout, "+CMQTTRXTOPIC:") != 1) {
+            return false;
+        }
+        thisModem().streamSkipUntil('\n');
+
+        // Topic always goes to the front of the buffer, excess is dropped
+        size_t topicSize = topic_total_len > bufferSize - 1 ? bufferSize - 1 : topic_total_len;
+        thisModem().stream.readBytes(buffer, topicSize);
+        mqttDiscard(topic_total_len - topicSize);
+        buffer[topicSize] = '\0';
+        topicSize += 1;
+
+        bool streaming = this->stream_chunk != NULL;
+        if (streaming && this->stream_begin) {
+            this->stream_begin(clientIndex, (const char *)buffer, payload_total_len);
+        }
+
+        // Streaming reuses the whole buffer as a window once the topic was
+        // handed over; buffered delivery appends after the topic
+        size_t windowStart = streaming ? 0 : topicSize;
+        size_t windowSize = bufferSize - windowStart;
+        size_t bufferOffset = windowStart;
+        size_t recvSize = 0;
+        bool complete = true;
+
+        uint32_t startMillis = millis();
+        while (recvSize < payload_total_len) {
+            if (thisModem().waitResponse(timeout, "+CMQTTRXPAYLOAD:") != 1) {
+                if (millis() - startMillis > 10000UL) {
+                    DBG("Payload timeout!");
+                    complete = false;
+                    break;
+                }
+                continue;
+            }
             thisModem().streamSkipUntil(',');
-            size_t topicSize = 0;
-            size_t plyloadSize = 0;
-            size_t topic_total_len =  thisModem().streamGetIntBefore(',');
-            size_t payload_total_len =  thisModem().streamGetIntBefore('\n');
-            if (thisModem().waitResponse(timeout, "+CMQTTRXTOPIC:") == 1) {
-
-                thisModem().streamSkipUntil('\n');
-                topicSize = topic_total_len > bufferSize ? bufferSize - 1 : topic_total_len;
-                thisModem().stream.readBytes(buffer, topicSize);
-                buffer[topicSize] = '\0';
-                topicSize += 1;
-
-                if (topicSize == bufferSize) {
+            size_t packetSize = thisModem().streamGetIntBefore('\n');
+            if (streaming) {
+                while (packetSize) {
+                    size_t n = packetSize > windowSize ? windowSize : packetSize;
+                    n = thisModem().stream.readBytes(buffer, n);
+                    if (n == 0) {
+                        complete = false;
+                        break;
+                    }
+                    this->stream_chunk(clientIndex, buffer, n, recvSize);
+                    recvSize += n;
+                    packetSize -= n;
+                }
+                if (!complete) break;
+            } else {
+                size_t room = bufferSize - bufferOffset;
+                size_t n = packetSize > room ? room : packetSize;
+                thisModem().stream.readBytes(buffer + bufferOffset, n);
+                if (n < packetSize) {
                     DBG("Buffer overflow!");
-                    thisModem().waitResponse(10000UL);
-                    return false;
+                    mqttDiscard(packetSize - n);
                 }
-                size_t recvSize = 0;
-                size_t remainingSize = bufferSize - topicSize;
-                size_t bufferOffset = topicSize;
-
-                do {
-                    if (thisModem().waitResponse(timeout, "+CMQTTRXPAYLOAD:") == 1) {
-                        thisModem().streamSkipUntil(',');
-                        int packetSize = thisModem().streamGetIntBefore('\n');
-
-                        plyloadSize = packetSize > remainingSize ? remainingSize : packetSize;
-
-                        if (bufferOffset >= bufferSize) {
-                            DBG("Buffer overflow!");
-                            break;
-                        }
-                        thisModem().stream.readBytes(buffer + bufferOffset, plyloadSize);
-
-                        remainingSize -= plyloadSize;
-                        bufferOffset += plyloadSize;
-                        recvSize += packetSize;
-
-                    }
-                } while (recvSize != payload_total_len);
+                bufferOffset += n;
+                recvSize += packetSize;
+            }
+            startMillis = millis();
+        }
 
-                if (thisModem().waitResponse(timeout, "+CMQTTRXEND: 0") == 1) {
-                    if (this->callback) {
-                        this->callback((const char *)buffer, buffer + topicSize, recvSize);
-                    }
-                    memset(this->buffer, 0, bufferSize);
-                    return true;
-                }
+        if (complete) {
+            if (thisModem().waitResponse(timeout, "+CMQTTRXEND:") == 1) {
+                thisModem().streamSkipUntil('\n');
+            } else {
+                complete = false;
+            }
+        }
 
+        if (streaming) {
+            if (this->stream_end) {
+                this->stream_end(clientIndex, complete);
             }
+            return complete;
         }
-        return false;
+        if (complete && this->callback) {
+            this->callback((const char *)buffer, buffer + topicSize, bufferOffset - topicSize);
+        }
+        return complete;
     }
 
 
 protected:
+    // Read and drop bytes that do not fit the receive buffer
+    void mqttDiscard(size_t len)
+    {
+        while (len) {
+            uint32_t startMillis = millis();
+            while (!thisModem().stream.available() && millis() - startMillis < 1000) {
+                TINY_GSM_YIELD();
+            }
+            if (thisModem().stream.read() < 0) {
+                return;
+            }
+            len--;
+        }
+    }
+
     bool mqttWillTopic(uint8_t clientIndex, const char *topic)
     {
         if (clientIndex > muxCount) {
@@ -58,7 +58,7 @@ public:
     bool mqtt_end()
     {
         if (this->buffer) {
-            free(this->buffer);
+            TINY_GSM_FREE(this->buffer);
             this->buffer = NULL;
         }
         mqtt_disconnect();
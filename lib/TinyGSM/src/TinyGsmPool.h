@@ -0,0 +1,200 @@
+/**
+ * @file      TinyGsmPool.h
+ * @license   LGPL-3.0
+ * @date      2026-10-17
+ *
+ * Long-lived arena for large I/O buffers.
+ *
+ * The arena is carved out of the heap (PSRAM when available) once at boot
+ * and never handed back, so repeated multi-megabyte download buffers and the
+ * library's temporary HTTP/MQTT buffers cannot fragment the system heap.
+ * Define TINY_GSM_USE_POOL before including TinyGSM to route
+ * TINY_GSM_MALLOC / TINY_GSM_REALLOC / TINY_GSM_FREE through it.
+ *
+ * Not thread safe; use it from the task that drives the modem.
+ */
+#pragma once
+
+#include "TinyGsmCommon.h"
+
+#ifdef BOARD_HAS_PSRAM
+#define TINY_GSM_POOL_HEAP_MALLOC   ps_malloc
+#define TINY_GSM_POOL_HEAP_REALLOC  ps_realloc
+#else
+#define TINY_GSM_POOL_HEAP_MALLOC   malloc
+#define TINY_GSM_POOL_HEAP_REALLOC  realloc
+#endif
+
+// Payload alignment, also the block header size
+#define TINY_GSM_POOL_ALIGN 16
+
+class TinyGsmPool {
+ public:
+  static TinyGsmPool& shared() {
+    static TinyGsmPool pool;
+    return pool;
+  }
+
+  /**
+   * @brief Hand the pool its arena. Call once, early in setup().
+   * @param mem  Memory that stays owned by the pool, NULL allocates it
+   * @param size Arena size in bytes
+   * @return true if the arena is usable
+   */
+  bool begin(void* mem, size_t size) {
+    if (_base) { return true; }
+    if (!mem) { mem = TINY_GSM_POOL_HEAP_MALLOC(size); }
+    if (!mem || size < 2 * TINY_GSM_POOL_ALIGN) { return false; }
+    // Align the start, trim the end to whole units
+    uintptr_t start = ((uintptr_t)mem + TINY_GSM_POOL_ALIGN - 1) &
+                      ~(uintptr_t)(TINY_GSM_POOL_ALIGN - 1);
+    size -= start - (uintptr_t)mem;
+    size &= ~(size_t)(TINY_GSM_POOL_ALIGN - 1);
+    _base       = (uint8_t*)start;
+    _size       = size;
+    Block* b    = blockAt(0);
+    b->size     = size;
+    b->used     = 0;
+    _used       = 0;
+    _highWater  = 0;
+    _failures   = 0;
+    return true;
+  }
+
+  void* alloc(size_t n) {
+    if (!n) { return NULL; }
+    size_t need = blockSize(n);
+    for (size_t off = 0; _base && off < _size; off += blockAt(off)->size) {
+      Block* b = blockAt(off);
+      if (b->used || b->size < need) { continue; }
+      split(off, need);
+      b->used = 1;
+      _used += b->size;
+      if (_used > _highWater) { _highWater = _used; }
+      return payload(b);
+    }
+    // Arena full (or not set up): fall back to the heap so callers keep working
+    _failures++;
+    return TINY_GSM_POOL_HEAP_MALLOC(n);
+  }
+
+  void* realloc(void* p, size_t n) {
+    if (!p) { return alloc(n); }
+    if (!owns(p)) { return TINY_GSM_POOL_HEAP_REALLOC(p, n); }
+    Block* b    = header(p);
+    size_t need = blockSize(n);
+    if (b->size >= need) { return p; }
+    // Grow in place into a free neighbour
+    size_t off  = (uint8_t*)b - _base;
+    size_t next = off + b->size;
+    if (next < _size && !blockAt(next)->used && b->size + blockAt(next)->size >= need) {
+      _used -= b->size;
+      b->size += blockAt(next)->size;
+      split(off, need);
+      _used += b->size;
+      if (_used > _highWater) { _highWater = _used; }
+      return p;
+    }
+    void* q = alloc(n);
+    if (!q) { return NULL; }
+    memcpy(q, p, b->size - TINY_GSM_POOL_ALIGN);
+    free(p);
+    return q;
+  }
+
+  void free(void* p) {
+    if (!p) { return; }
+    if (!owns(p)) {
+      ::free(p);
+      return;
+    }
+    Block* b = header(p);
+    if (!b->used) { return; }
+    b->used = 0;
+    _used -= b->size;
+    coalesce();
+  }
+
+  bool owns(const void* p) const {
+    return _base && (const uint8_t*)p >= _base && (const uint8_t*)p < _base + _size;
+  }
+
+  size_t capacity() const { return _size; }
+  size_t used() const { return _used; }
+  size_t highWater() const { return _highWater; }
+  // Allocations the arena could not satisfy (served by the heap instead)
+  uint32_t failures() const { return _failures; }
+
+  size_t largestFree() const {
+    size_t best = 0;
+    for (size_t off = 0; _base && off < _size; off += blockAt(off)->size) {
+      const Block* b = blockAt(off);
+      if (!b->used && b->size > best) { best = b->size; }
+    }
+    return best > TINY_GSM_POOL_ALIGN ? best - TINY_GSM_POOL_ALIGN : 0;
+  }
+
+  void report(Print& out) const {
+    out.print("Pool: used ");
+    out.print(_used / 1024);
+    out.print("/");
+    out.print(_size / 1024);
+    out.print(" KB, high water ");
+    out.print(_highWater / 1024);
+    out.print(" KB, largest free ");
+    out.print(largestFree() / 1024);
+    out.print(" KB, failures ");
+    out.println(_failures);
+  }
+
+ private:
+  struct Block {
+    uint32_t size;  // including this header
+    uint32_t used;
+  };
+
+  TinyGsmPool() {}
+
+  static size_t blockSize(size_t n) {
+    return ((n + TINY_GSM_POOL_ALIGN - 1) & ~(size_t)(TINY_GSM_POOL_ALIGN - 1)) +
+           TINY_GSM_POOL_ALIGN;
+  }
+  Block* blockAt(size_t off) const {
+    return reinterpret_cast<Block*>(_base + off);
+  }
+  static void* payload(Block* b) {
+    return reinterpret_cast<uint8_t*>(b) + TINY_GSM_POOL_ALIGN;
+  }
+  static Block* header(void* p) {
+    return reinterpret_cast<Block*>(static_cast<uint8_t*>(p) - TINY_GSM_POOL_ALIGN);
+  }
+
+  // Cut a free tail off the block at off when it is worth keeping
+  void split(size_t off, size_t need) {
+    Block* b = blockAt(off);
+    if (b->size - need < 2 * TINY_GSM_POOL_ALIGN) { return; }
+    Block* rest = blockAt(off + need);
+    rest->size  = b->size - need;
+    rest->used  = 0;
+    b->size     = need;
+  }
+
+  void coalesce() {
+    size_t off = 0;
+    while (off < _size) {
+      Block* b    = blockAt(off);
+      size_t next = off + b->size;
+      if (!b->used && next < _size && !blockAt(next)->used) {
+        b->size += blockAt(next)->size;
+        continue;
+      }
+      off = next;
+    }
+  }
+
+  uint8_t* _base      = NULL;
+  size_t   _size      = 0;
+  size_t   _used      = 0;
+  size_t   _highWater = 0;
+  uint32_t _failures  = 0;
+};
@@ -0,0 +1,184 @@
+#include "Metrics.h"
+
+MetricsRegistry metrics;
+
+// Sinks for registrations that do not fit; their values are never exported
+static MetricCounter   scratchCounter;
+static MetricGauge     scratchGauge;
+static MetricHistogram scratchHistogram;
+
+void MetricHistogram::record(uint32_t sample) {
+    uint8_t i = 0;
+    while (i < numBounds && sample > bounds[i]) i++;
+    buckets[i]++;
+    count++;
+    sum += sample;
+    if (sample > max) max = sample;
+}
+
+MetricCounter *MetricsRegistry::counter(const char *name) {
+    for (uint8_t i = 0; i < _numCounters; i++) {
+        if (strcmp(_counters[i].name, name) == 0) return &_counters[i];
+    }
+    if (_numCounters >= METRICS_MAX_COUNTERS) return &scratchCounter;
+    MetricCounter *c = &_counters[_numCounters++];
+    c->name = name;
+    c->value = 0;
+    return c;
+}
+
+MetricGauge *MetricsRegistry::gauge(const char *name) {
+    for (uint8_t i = 0; i < _numGauges; i++) {
+        if (strcmp(_gauges[i].name, name) == 0) return &_gauges[i];
+    }
+    if (_numGauges >= METRICS_MAX_GAUGES) return &scratchGauge;
+    MetricGauge *g = &_gauges[_numGauges++];
+    g->name = name;
+    g->value = 0;
+    return g;
+}
+
+MetricHistogram *MetricsRegistry::histogram(const char *name, const uint32_t *bounds, uint8_t numBounds) {
+    for (uint8_t i = 0; i < _numHistograms; i++) {
+        if (strcmp(_histograms[i].name, name) == 0) return &_histograms[i];
+    }
+    if (_numHistograms >= METRICS_MAX_HISTOGRAMS) {
+        scratchHistogram.bounds = bounds;
+        scratchHistogram.numBounds = min(numBounds, (uint8_t)METRICS_MAX_BUCKETS);
+        return &scratchHistogram;
+    }
+    MetricHistogram *h = &_histograms[_numHistograms++];
+    memset(h, 0, sizeof(*h));
+    h->name = name;
+    h->bounds = bounds;
+    h->numBounds = min(numBounds, (uint8_t)METRICS_MAX_BUCKETS);
+    return h;
+}
+
+void MetricsRegistry::reset() {
+    for (uint8_t i = 0; i < _numCounters; i++) _counters[i].value = 0;
+    for (uint8_t i = 0; i < _numGauges; i++) _gauges[i].value = 0;
+    for (uint8_t i = 0; i < _numHistograms; i++) {
+        MetricHistogram &h = _histograms[i];
+        memset(h.buckets, 0, sizeof(h.buckets));
+        h.count = 0;
+        h.sum = 0;
+        h.max = 0;
+    }
+}
+
+size_t MetricsRegistry::writeJson(Print &out) const {
+    size_t n = 0;
+    n += out.print("{\"uptime\":");
+    n += out.print(millis());
+
+    n += out.print(",\"counters\":{");
+    for (uint8_t i = 0; i < _numCounters; i++) {
+        if (i) n += out.print(',');
+        n += out.print('"'); n += out.print(_counters[i].name); n += out.print("\":");
+        n += out.print(_counters[i].value);
+    }
+
+    n += out.print("},\"gauges\":{");
+    for (uint8_t i = 0; i < _numGauges; i++) {
+        if (i) n += out.print(',');
+        n += out.print('"'); n += out.print(_gauges[i].name); n += out.print("\":");
+        n += out.print(_gauges[i].value);
+    }
+
+    n += out.print("},\"histograms\":{");
+    for (uint8_t i = 0; i < _numHistograms; i++) {
+        const MetricHistogram &h = _histograms[i];
+        if (i) n += out.print(',');
+        n += out.print('"'); n += out.print(h.name); n += out.print("\":{\"b\":[");
+        for (uint8_t b = 0; b < h.numBounds; b++) {
+            if (b) n += out.print(',');
+            n += out.print(h.bounds[b]);
+        }
+        n += out.print("],\"c\":[");
+        for (uint8_t b = 0; b <= h.numBounds; b++) {
+            if (b) n += out.print(',');
+            n += out.print(h.buckets[b]);
+        }
+        n += out.print("],\"n\":"); n += out.print(h.count);
+        n += out.print(",\"sum\":"); n += out.print(h.sum);
+        n += out.print(",\"max\":"); n += out.print(h.max);
+        n += out.print('}');
+    }
+    n += out.print("}}");
+    return n;
+}
+
+static size_t writeU32(Print &out, uint32_t v) {
+    uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    return out.write(b, sizeof(b));
+}
+
+static size_t writeName(Print &out, const char *name) {
+    uint8_t len = (uint8_t)min(strlen(name), (size_t)255);
+    size_t n = out.write(len);
+    return n + out.write((const uint8_t *)name, len);
+}
+
+size_t MetricsRegistry::writeBinary(Print &out) const {
+    size_t n = 0;
+    n += out.write((uint8_t)(METRICS_BIN_MAGIC & 0xFF));
+    n += out.write((uint8_t)(METRICS_BIN_MAGIC >> 8));
+    n += out.write((uint8_t)METRICS_BIN_VERSION);
+    n += writeU32(out, millis());
+
+    n += out.write(_numCounters);
+    for (uint8_t i = 0; i < _numCounters; i++) {
+        n += writeName(out, _counters[i].name);
+        n += writeU32(out, _counters[i].value);
+    }
+
+    n += out.write(_numGauges);
+    for (uint8_t i = 0; i < _numGauges; i++) {
+        n += writeName(out, _gauges[i].name);
+        n += writeU32(out, (uint32_t)_gauges[i].value);
+    }
+
+    n += out.write(_numHistograms);
+    for (uint8_t i = 0; i < _numHistograms; i++) {
+        const MetricHistogram &h = _histograms[i];
+        n += writeName(out, h.name);
+        n += out.write(h.numBounds);
+        for (uint8_t b = 0; b < h.numBounds; b++) n += writeU32(out, h.bounds[b]);
+        for (uint8_t b = 0; b <= h.numBounds; b++) n += writeU32(out, h.buckets[b]);
+        n += writeU32(out, h.count);
+        n += writeU32(out, h.sum);
+        n += writeU32(out, h.max);
+    }
+    return n;
+}
+
+// Print adapter over a fixed buffer; remembers if anything was dropped
+class BufferPrint : public Print {
+public:
+    BufferPrint(char *buf, size_t len) : _buf(buf), _len(len) {}
+    size_t write(uint8_t c) override {
+        if (_pos + 1 >= _len) { _overflow = true; return 0; }
+        _buf[_pos++] = (char)c;
+        return 1;
+    }
+    size_t length() const { return _pos; }
+    bool overflow() const { return _overflow; }
+private:
+    char *_buf;
+    size_t _len;
+    size_t _pos = 0;
+    bool _overflow = false;
+};
+
+size_t MetricsRegistry::snapshotJson(char *buf, size_t len) const {
+    if (!buf || len == 0) return 0;
+    BufferPrint out(buf, len);
+    writeJson(out);
+    if (out.overflow()) {
+        buf[0] = '\0';
+        return 0;
+    }
+    buf[out.length()] = '\0';
+    return out.length();
+}
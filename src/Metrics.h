@@ -0,0 +1,78 @@
+/**
+ * Metrics - lightweight runtime telemetry registry
+ * - Counters, gauges and fixed-bucket histograms held in a static arena
+ * - No heap use after boot; registration returns a stable handle
+ * - Snapshot as JSON or a compact binary record to any Print
+ *   (Serial, an SD File, or a buffer handed to the MQTT client)
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#define METRICS_MAX_COUNTERS    16
+#define METRICS_MAX_GAUGES      16
+#define METRICS_MAX_HISTOGRAMS  8
+#define METRICS_MAX_BUCKETS     12
+
+// Binary snapshot framing
+#define METRICS_BIN_MAGIC       0x4D54   // "MT"
+#define METRICS_BIN_VERSION     1
+
+struct MetricCounter {
+    const char *name;
+    uint32_t value;
+
+    void inc(uint32_t n = 1) { value += n; }
+};
+
+struct MetricGauge {
+    const char *name;
+    int32_t value;
+
+    void set(int32_t v) { value = v; }
+};
+
+struct MetricHistogram {
+    const char *name;
+    // Ascending upper bounds; samples above the last bound land in the
+    // overflow bucket at index numBounds
+    const uint32_t *bounds;
+    uint8_t numBounds;
+    uint32_t buckets[METRICS_MAX_BUCKETS + 1];
+    uint32_t count;
+    uint32_t sum;
+    uint32_t max;
+
+    void record(uint32_t sample);
+};
+
+class MetricsRegistry {
+public:
+    // Registration is expected at boot. Registering an existing name returns
+    // the same slot; a full arena returns a shared scratch slot so callers
+    // never have to null-check
+    MetricCounter   *counter(const char *name);
+    MetricGauge     *gauge(const char *name);
+    MetricHistogram *histogram(const char *name, const uint32_t *bounds, uint8_t numBounds);
+
+    void reset();
+
+    // {"uptime":..,"counters":{..},"gauges":{..},"histograms":{"x":{"b":[..],"c":[..],"n":..,"sum":..,"max":..}}}
+    size_t writeJson(Print &out) const;
+    // magic(2) version(1) uptime(4) then for each kind: n(1) entries, where
+    // an entry is name length(1), name, values (little endian)
+    size_t writeBinary(Print &out) const;
+    // JSON snapshot into a caller buffer (e.g. an MQTT payload);
+    // returns the length written, 0 if it did not fit
+    size_t snapshotJson(char *buf, size_t len) const;
+
+private:
+    MetricCounter   _counters[METRICS_MAX_COUNTERS];
+    MetricGauge     _gauges[METRICS_MAX_GAUGES];
+    MetricHistogram _histograms[METRICS_MAX_HISTOGRAMS];
+    uint8_t _numCounters = 0;
+    uint8_t _numGauges = 0;
+    uint8_t _numHistograms = 0;
+};
+
+extern MetricsRegistry metrics;
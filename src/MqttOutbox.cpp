@@ -0,0 +1,197 @@
+#include "MqttOutbox.h"
+#include <SD.h>
+
+bool MqttOutbox::begin(uint8_t *mem, size_t size, const char *spillPath) {
+    if (!mem || size <= OUTBOX_RECORD_HDR) return false;
+    _ring = mem;
+    _size = size;
+    _used = _tail = _head = 0;
+    _ringRecords = 0;
+    _spillPath = spillPath;
+    _spillReadPos = _spillAckPos = OUTBOX_SPILL_HDR;
+    _spillRecords = 0;
+
+    // Records spilled before a reboot and not delivered yet are still waiting
+    if (_spillPath && SD.exists(_spillPath)) {
+        File f = SD.open(_spillPath, FILE_READ);
+        if (f) {
+            uint8_t ack[OUTBOX_SPILL_HDR];
+            if (f.read(ack, sizeof(ack)) == sizeof(ack)) {
+                uint32_t pos = ack[0] | (ack[1] << 8) | ((uint32_t)ack[2] << 16) | ((uint32_t)ack[3] << 24);
+                if (pos >= OUTBOX_SPILL_HDR && f.seek(pos)) _spillReadPos = _spillAckPos = pos;
+            }
+            f.seek(_spillReadPos);
+            uint8_t hdr[OUTBOX_RECORD_HDR];
+            while (f.read(hdr, sizeof(hdr)) == sizeof(hdr)) {
+                uint16_t len = hdr[1] | (hdr[2] << 8);
+                if (!f.seek(f.position() + len)) break;
+                _spillRecords++;
+            }
+            f.close();
+        }
+        if (!_spillRecords) SD.remove(_spillPath);
+    }
+    return true;
+}
+
+int8_t MqttOutbox::addTopic(const char *topic, uint8_t qos, bool packable) {
+    if (_numTopics >= OUTBOX_MAX_TOPICS) return -1;
+    _topics[_numTopics].name = topic;
+    _topics[_numTopics].qos = qos;
+    _topics[_numTopics].packable = packable;
+    return _numTopics++;
+}
+
+bool MqttOutbox::enqueue(int8_t topicId, const uint8_t *data, size_t len) {
+    if (topicId < 0 || topicId >= _numTopics || len == 0 || len > OUTBOX_MAX_BATCH) {
+        _dropped++;
+        return false;
+    }
+    // Once anything sits in the spill file, new records follow it there so
+    // delivery order is preserved
+    if (_spillPath && (_spillRecords || freeSpace() < OUTBOX_RECORD_HDR + len)) {
+        if (spill(topicId, data, len)) return true;
+        _dropped++;
+        return false;
+    }
+    // Nowhere to overflow to: keep the newest records
+    if (OUTBOX_RECORD_HDR + len > _size) {
+        _dropped++;
+        return false;
+    }
+    while (freeSpace() < OUTBOX_RECORD_HDR + len) dropOldest();
+    uint8_t hdr[OUTBOX_RECORD_HDR] = { (uint8_t)topicId, (uint8_t)len, (uint8_t)(len >> 8) };
+    put(hdr, sizeof(hdr));
+    put(data, len);
+    _ringRecords++;
+    return true;
+}
+
+uint16_t MqttOutbox::flush(PublishFn publish, uint32_t budgetMs) {
+    uint16_t delivered = 0;
+    uint32_t start = millis();
+    refill();
+    while (_used && millis() - start < budgetMs) {
+        uint8_t topicId;
+        uint16_t len;
+        bool spilled;
+        recordAt(_tail, topicId, len, spilled);
+        const Topic &topic = _topics[topicId];
+
+        size_t pos = _tail;
+        size_t ringBytes = 0;
+        uint32_t spillBytes = 0;
+        size_t batchLen = 0;
+        uint16_t records = 0;
+        do {
+            if (records) _batch[batchLen++] = '\n';
+            copyOut(pos + OUTBOX_RECORD_HDR, _batch + batchLen, len);
+            batchLen += len;
+            records++;
+            ringBytes += OUTBOX_RECORD_HDR + len;
+            if (spilled) spillBytes += OUTBOX_RECORD_HDR + len;
+            pos = (pos + OUTBOX_RECORD_HDR + len) % _size;
+            if (!topic.packable || ringBytes == _used) break;
+            uint8_t nextTopic;
+            recordAt(pos, nextTopic, len, spilled);
+            if (nextTopic != topicId || batchLen + 1 + len > OUTBOX_MAX_BATCH) break;
+        } while (true);
+
+        // Not delivered: the records stay at the tail for the next flush
+        if (publish(topic.name, _batch, batchLen, topic.qos) != 0) break;
+
+        _tail = pos;
+        _used -= ringBytes;
+        _ringRecords -= records;
+        delivered++;
+        if (spillBytes) ackSpill(spillBytes);
+        refill();
+    }
+    return delivered;
+}
+
+void MqttOutbox::put(const uint8_t *src, size_t len) {
+    size_t first = min(len, _size - _head);
+    memcpy(_ring + _head, src, first);
+    memcpy(_ring, src + first, len - first);
+    _head = (_head + len) % _size;
+    _used += len;
+}
+
+void MqttOutbox::copyOut(size_t pos, uint8_t *dst, size_t len) const {
+    pos %= _size;
+    size_t first = min(len, _size - pos);
+    memcpy(dst, _ring + pos, first);
+    memcpy(dst + first, _ring, len - first);
+}
+
+void MqttOutbox::recordAt(size_t pos, uint8_t &topicId, uint16_t &len, bool &spilled) const {
+    uint8_t hdr[OUTBOX_RECORD_HDR];
+    copyOut(pos, hdr, sizeof(hdr));
+    topicId = hdr[0] & ~OUTBOX_FROM_SPILL;
+    spilled = hdr[0] & OUTBOX_FROM_SPILL;
+    len = hdr[1] | (hdr[2] << 8);
+}
+
+void MqttOutbox::dropOldest() {
+    uint8_t topicId;
+    uint16_t len;
+    bool spilled;
+    recordAt(_tail, topicId, len, spilled);
+    _tail = (_tail + OUTBOX_RECORD_HDR + len) % _size;
+    _used -= OUTBOX_RECORD_HDR + len;
+    _ringRecords--;
+    _dropped++;
+}
+
+bool MqttOutbox::spill(int8_t topicId, const uint8_t *data, size_t len) {
+    if (!_spillPath) return false;
+    File f = SD.open(_spillPath, FILE_APPEND);
+    if (!f) return false;
+    uint8_t ack[OUTBOX_SPILL_HDR] = { OUTBOX_SPILL_HDR, 0, 0, 0 };
+    uint8_t hdr[OUTBOX_RECORD_HDR] = { (uint8_t)topicId, (uint8_t)len, (uint8_t)(len >> 8) };
+    bool ok = (f.size() || f.write(ack, sizeof(ack)) == sizeof(ack)) &&
+              f.write(hdr, sizeof(hdr)) == sizeof(hdr) && f.write(data, len) == len;
+    f.close();
+    if (ok) _spillRecords++;
+    return ok;
+}
+
+// Move spilled records back into the ring as space frees up
+void MqttOutbox::refill() {
+    if (!_spillRecords || !_spillPath) return;
+    File f = SD.open(_spillPath, FILE_READ);
+    if (!f) return;
+    f.seek(_spillReadPos);
+    uint8_t hdr[OUTBOX_RECORD_HDR];
+    while (_spillRecords && f.read(hdr, sizeof(hdr)) == sizeof(hdr)) {
+        uint16_t len = hdr[1] | (hdr[2] << 8);
+        if (freeSpace() < (size_t)OUTBOX_RECORD_HDR + len) break;
+        if (f.read(_batch, len) != len) break;
+        // Still in the file until delivered, see ackSpill()
+        hdr[0] |= OUTBOX_FROM_SPILL;
+        put(hdr, sizeof(hdr));
+        put(_batch, len);
+        _ringRecords++;
+        _spillRecords--;
+        _spillReadPos = f.position();
+    }
+    f.close();
+}
+
+// Skip delivered records in the spill file header; once everything read
+// from the file is delivered, the file goes
+void MqttOutbox::ackSpill(uint32_t bytes) {
+    _spillAckPos += bytes;
+    if (!_spillRecords && _spillAckPos >= _spillReadPos) {
+        SD.remove(_spillPath);
+        _spillReadPos = _spillAckPos = OUTBOX_SPILL_HDR;
+        return;
+    }
+    File f = SD.open(_spillPath, "r+");
+    if (!f) return;
+    uint8_t ack[OUTBOX_SPILL_HDR] = { (uint8_t)_spillAckPos, (uint8_t)(_spillAckPos >> 8),
+                                      (uint8_t)(_spillAckPos >> 16), (uint8_t)(_spillAckPos >> 24) };
+    f.write(ack, sizeof(ack));
+    f.close();
+}
@@ -0,0 +1,84 @@
+/**
+ * MQTT Outbox - store-and-forward queue for telemetry
+ * - Records queue in a PSRAM ring and spill to an SD file when it fills,
+ *   so nothing produced while the link is down is lost; without a spill
+ *   file the oldest records are dropped instead
+ * - flush() sends when a connection is up; consecutive records of a
+ *   packable topic are joined into one publish (newline separated)
+ * - One publish at a time: the A76xx +CMQTTPUB result carries no message
+ *   id, so it can only be matched while a single publish is outstanding.
+ *   Records stay queued until their result is 0 and are re-sent otherwise
+ * - The spill file starts with the offset of its first undelivered record,
+ *   advanced as records read back from it are delivered, so a reboot only
+ *   resends what the broker has not acknowledged
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#define OUTBOX_MAX_TOPICS    4
+// Largest single publish; the A76xx accepts up to 10240 payload bytes
+#define OUTBOX_MAX_BATCH     4096
+#define OUTBOX_RECORD_HDR    3
+#define OUTBOX_SPILL_HDR     4
+// Topic id flag of ring records read back from the spill file
+#define OUTBOX_FROM_SPILL    0x80
+
+class MqttOutbox {
+public:
+    // Sends one payload and waits for the broker result: 0 = delivered,
+    // anything else (including no result) = not delivered
+    typedef int (*PublishFn)(const char *topic, const uint8_t *payload, size_t len, uint8_t qos);
+
+    // mem is the ring (typically PSRAM), spillPath an SD file used as
+    // overflow; with spillPath NULL a full ring drops its oldest records
+    bool begin(uint8_t *mem, size_t size, const char *spillPath);
+
+    // Returns a topic id, or -1 when the table is full
+    int8_t addTopic(const char *topic, uint8_t qos, bool packable);
+
+    bool enqueue(int8_t topicId, const uint8_t *data, size_t len);
+    bool enqueue(int8_t topicId, const char *text) { return enqueue(topicId, (const uint8_t *)text, strlen(text)); }
+
+    // Publishes queued records until none are left, a publish fails or
+    // budgetMs runs out; returns the number of publishes delivered
+    uint16_t flush(PublishFn publish, uint32_t budgetMs);
+
+    uint32_t pendingRecords() const { return _ringRecords + _spillRecords; }
+    uint32_t spilledRecords() const { return _spillRecords; }
+    uint32_t droppedRecords() const { return _dropped; }
+
+private:
+    struct Topic {
+        const char *name;
+        uint8_t qos;
+        bool packable;
+    };
+
+    size_t freeSpace() const { return _size - _used; }
+    void put(const uint8_t *src, size_t len);
+    void copyOut(size_t pos, uint8_t *dst, size_t len) const;
+    void recordAt(size_t pos, uint8_t &topicId, uint16_t &len, bool &spilled) const;
+    void dropOldest();
+    bool spill(int8_t topicId, const uint8_t *data, size_t len);
+    void refill();
+    void ackSpill(uint32_t bytes);
+
+    uint8_t *_ring = nullptr;
+    size_t _size = 0;
+    size_t _used = 0;       // queued bytes, _tail up to _head
+    size_t _tail = 0;       // oldest record, the next to publish
+    size_t _head = 0;       // write position
+    uint32_t _ringRecords = 0;
+
+    const char *_spillPath = nullptr;
+    uint32_t _spillReadPos = OUTBOX_SPILL_HDR;
+    uint32_t _spillAckPos = OUTBOX_SPILL_HDR;   // end of the delivered records
+    uint32_t _spillRecords = 0;
+    uint32_t _dropped = 0;
+
+    Topic _topics[OUTBOX_MAX_TOPICS];
+    uint8_t _numTopics = 0;
+
+    uint8_t _batch[OUTBOX_MAX_BATCH];
+};
@@ -0,0 +1,149 @@
+#include "UpdateScheduler.h"
+
+UpdateScheduler::UpdateScheduler(uint32_t intervalMs, uint8_t jitterPct)
+    : _intervalMs(intervalMs),
+      _jitterPct(jitterPct > 50 ? 50 : jitterPct),
+      _rng(1),
+      _nextDueMs(0),
+      _failures(0),
+      _windowDefers(0) {
+    memset(_hourlyBps, 0, sizeof(_hourlyBps));
+    memset(_hourlySamples, 0, sizeof(_hourlySamples));
+}
+
+void UpdateScheduler::begin(uint32_t seed, uint32_t nowMs) {
+    // xorshift32 must never be seeded with zero
+    _rng = seed ? seed : 0x9E3779B9UL;
+    // Random phase inside the first interval spreads the fleet out even
+    // when every unit powers up at the same moment after a site outage
+    scheduleIn(nextRandom() % _intervalMs, nowMs);
+}
+
+bool UpdateScheduler::due(uint32_t nowMs) const {
+    return (int32_t)(nowMs - _nextDueMs) >= 0;
+}
+
+uint32_t UpdateScheduler::msUntilDue(uint32_t nowMs) const {
+    return due(nowMs) ? 0 : _nextDueMs - nowMs;
+}
+
+UpdateScheduler::Verdict UpdateScheduler::admit(int16_t csq, int16_t rsrpDbm, int8_t hour, uint32_t nowMs) {
+    bool weak = (csq == 99 || csq < SCHED_MIN_CSQ);
+    if (rsrpDbm != 0) {
+        // RSRP is the better LTE metric; CSQ only reflects RSSI
+        weak = rsrpDbm < SCHED_MIN_RSRP_DBM;
+    }
+    if (weak) {
+        scheduleIn(jittered(SCHED_POSTPONE_MS), nowMs);
+        return WEAK_SIGNAL;
+    }
+
+    int8_t best = bestHour();
+    if (hour >= 0 && hour < 24 && best >= 0 && hour != best &&
+        _hourlySamples[hour] > 0 && _windowDefers < SCHED_MAX_WINDOW_DEFERS) {
+        uint32_t here = _hourlyBps[hour];
+        uint32_t top = _hourlyBps[best];
+        if (here * 100 < top * SCHED_SLOW_WINDOW_PCT) {
+            _windowDefers++;
+            scheduleIn(jittered(_intervalMs), nowMs);
+            return SLOW_WINDOW;
+        }
+    }
+
+    _windowDefers = 0;
+    return GO;
+}
+
+void UpdateScheduler::recordSuccess(uint32_t bytes, uint32_t elapsedMs, int8_t hour, uint32_t nowMs) {
+    _failures = 0;
+    if (hour >= 0 && hour < 24 && elapsedMs > 0) {
+        uint32_t bps = (uint32_t)(((uint64_t)bytes * 1000) / elapsedMs);
+        if (_hourlySamples[hour] == 0) {
+            _hourlyBps[hour] = bps;
+        } else {
+            // EWMA with alpha = 1/4
+            _hourlyBps[hour] = (_hourlyBps[hour] * 3 + bps) / 4;
+        }
+        if (_hourlySamples[hour] < 0xFFFF) _hourlySamples[hour]++;
+    }
+    scheduleIn(jittered(_intervalMs), nowMs);
+}
+
+void UpdateScheduler::recordFailure(uint32_t nowMs) {
+    if (_failures < 31) _failures++;
+    uint32_t delayMs = SCHED_BACKOFF_BASE_MS;
+    for (uint8_t i = 1; i < _failures && delayMs < SCHED_BACKOFF_MAX_MS; i++) {
+        delayMs <<= 1;
+    }
+    if (delayMs > SCHED_BACKOFF_MAX_MS) delayMs = SCHED_BACKOFF_MAX_MS;
+    scheduleIn(jittered(delayMs), nowMs);
+}
+
+uint32_t UpdateScheduler::hourlyThroughput(uint8_t hour) const {
+    return hour < 24 ? _hourlyBps[hour] : 0;
+}
+
+int8_t UpdateScheduler::bestHour() const {
+    int8_t best = -1;
+    for (uint8_t h = 0; h < 24; h++) {
+        if (_hourlySamples[h] == 0) continue;
+        if (best < 0 || _hourlyBps[h] > _hourlyBps[best]) best = h;
+    }
+    return best;
+}
+
+int16_t UpdateScheduler::parseLteRsrp(const String &cpsi) {
+    // LTE,Online,MCC-MNC,TAC,SCellID,PCellID,Band,EARFCN,DLBW,ULBW,RSRQ,RSRP,RSSI,RSSNR
+    // RSRQ/RSRP/RSSI are reported in 1/10 dB units
+    if (!cpsi.startsWith("LTE")) return 0;
+    int field = 0;
+    int start = 0;
+    for (int i = 0; i <= (int)cpsi.length(); i++) {
+        if (i == (int)cpsi.length() || cpsi[i] == ',') {
+            if (field == 11) {
+                int16_t rsrp = cpsi.substring(start, i).toInt() / 10;
+                return rsrp < 0 ? rsrp : 0;
+            }
+            field++;
+            start = i + 1;
+        }
+    }
+    return 0;
+}
+
+void UpdateScheduler::printStats(Print &out) const {
+    out.print("Scheduler: next in ");
+    out.print(msUntilDue(millis()) / 1000);
+    out.print("s, failures ");
+    out.print(_failures);
+    int8_t best = bestHour();
+    if (best >= 0) {
+        out.print(", best hour ");
+        out.print(best);
+        out.print(" (");
+        out.print(_hourlyBps[best] / 1024);
+        out.print(" KB/s)");
+    }
+    out.println();
+}
+
+void UpdateScheduler::scheduleIn(uint32_t delayMs, uint32_t nowMs) {
+    _nextDueMs = nowMs + delayMs;
+}
+
+uint32_t UpdateScheduler::jittered(uint32_t baseMs) {
+    if (_jitterPct == 0) return baseMs;
+    uint32_t span = (uint32_t)(((uint64_t)baseMs * _jitterPct) / 100);
+    if (span == 0) return baseMs;
+    // Uniform in [base - span, base + span]
+    return baseMs - span + (nextRandom() % (2 * span + 1));
+}
+
+uint32_t UpdateScheduler::nextRandom() {
+    uint32_t x = _rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    _rng = x;
+    return x;
+}
@@ -0,0 +1,84 @@
+/**
+ * Update Scheduler - decides when the device is allowed to fetch new audio
+ * - Per-device random phase and jitter so a site cluster does not wake in lockstep
+ * - Signal-quality gate (CSQ / LTE RSRP) that postpones downloads on a weak link
+ * - Exponential backoff after failed downloads
+ * - Per hour-of-day throughput history used to prefer the fastest windows
+ */
+#pragma once
+
+#include <Arduino.h>
+
+// CSQ below this is treated as "too weak to download" (99 = unknown)
+#define SCHED_MIN_CSQ            10
+// LTE RSRP below this (dBm) is treated as too weak when +CPSI? reports it
+#define SCHED_MIN_RSRP_DBM       (-110)
+// How long to wait before re-checking after a poor-signal postpone
+#define SCHED_POSTPONE_MS        (5UL * 60 * 1000)
+// Backoff limits after failed downloads
+#define SCHED_BACKOFF_BASE_MS    (2UL * 60 * 1000)
+#define SCHED_BACKOFF_MAX_MS     (4UL * 60 * 60 * 1000)
+// A slow hour is skipped when its learned throughput is below this
+// percentage of the best known hour, at most SCHED_MAX_WINDOW_DEFERS times
+#define SCHED_SLOW_WINDOW_PCT    50
+#define SCHED_MAX_WINDOW_DEFERS  2
+
+class UpdateScheduler {
+public:
+    enum Verdict {
+        GO = 0,           // link is fine, download now
+        WEAK_SIGNAL,      // postponed by the signal gate
+        SLOW_WINDOW,      // postponed because this hour is historically slow
+    };
+
+    // intervalMs is the nominal check period, jitterPct the +/- spread
+    // applied to each period (0..50)
+    UpdateScheduler(uint32_t intervalMs, uint8_t jitterPct = 10);
+
+    // Seeds the per-device phase; call once from setup() with something
+    // unique to the unit (e.g. a hash of the IMEI or esp_random())
+    void begin(uint32_t seed, uint32_t nowMs);
+
+    // True when the next attempt is due
+    bool due(uint32_t nowMs) const;
+
+    // Milliseconds until the next attempt (0 when due)
+    uint32_t msUntilDue(uint32_t nowMs) const;
+
+    // Pre-download gate. csq is the raw +CSQ value, rsrpDbm the LTE RSRP
+    // from +CPSI? (pass 0 if unknown), hour the local hour 0..23 (or -1).
+    // Anything but GO has already rescheduled the next attempt.
+    Verdict admit(int16_t csq, int16_t rsrpDbm, int8_t hour, uint32_t nowMs);
+
+    // Report the outcome of an admitted download
+    void recordSuccess(uint32_t bytes, uint32_t elapsedMs, int8_t hour, uint32_t nowMs);
+    void recordFailure(uint32_t nowMs);
+
+    // Learned average throughput for an hour in bytes/s (0 = no samples)
+    uint32_t hourlyThroughput(uint8_t hour) const;
+    // Hour with the highest learned throughput, or -1 when nothing is known yet
+    int8_t bestHour() const;
+
+    uint8_t consecutiveFailures() const { return _failures; }
+
+    // Extract RSRP (dBm) from a "+CPSI:" LTE line, 0 if not an LTE report
+    static int16_t parseLteRsrp(const String &cpsi);
+
+    void printStats(Print &out) const;
+
+private:
+    void scheduleIn(uint32_t delayMs, uint32_t nowMs);
+    uint32_t jittered(uint32_t baseMs);
+    uint32_t nextRandom();
+
+    uint32_t _intervalMs;
+    uint8_t  _jitterPct;
+    uint32_t _rng;
+    uint32_t _nextDueMs;
+    uint8_t  _failures;
+    uint8_t  _windowDefers;
+
+    // Exponentially weighted average throughput per hour, bytes/s
+    uint32_t _hourlyBps[24];
+    uint16_t _hourlySamples[24];
+};
@@ -5,30 +5,57 @@
  */
 
 #define TINY_GSM_RX_BUFFER 1024
+// Large I/O buffers (ours and TinyGSM's) come from one long-lived PSRAM arena
+#define TINY_GSM_USE_POOL
 // #define DUMP_AT_COMMANDS
+// Record AT traffic into a PSRAM ring instead of echoing it to Serial;
+// the ring is written to SD after each check (see lib/StreamDebugger/extras/replay)
+// #define CAPTURE_AT_COMMANDS
+
+// Feed AT command latency into the metrics registry
+void metricsAtSent();
+void metricsAtResponse(int8_t index);
+#define TINY_GSM_AT_SENT()          metricsAtSent()
+#define TINY_GSM_AT_RESPONSE(index) metricsAtResponse(index)
 
 #include "utilities.h"
 #include <TinyGsmClient.h>
 #include <SD.h>
 #include <SPI.h>
+#include "ff.h"
 #include "Audio.h"
+#include "UpdateScheduler.h"
+#include "Metrics.h"
+#include "MqttOutbox.h"
 
 // --- PSRAM Config ---
 #ifndef BOARD_HAS_PSRAM
     #error "Please enable PSRAM in Arduino IDE: Tools > PSRAM > Enabled"
 #endif
 #define LARGE_BUFFER_SIZE (2048 * 1024) 
+// Download buffer plus headroom for TinyGSM's HTTP/MQTT buffers
+#define IO_POOL_SIZE (LARGE_BUFFER_SIZE + 256 * 1024)
 
 // UPDATED: Set to 1024 to match modem firmware behavior
 #define MODEM_READ_SIZE 1024
 
-#ifdef DUMP_AT_COMMANDS
+// Used when the FAT cluster size cannot be read at startup
+#define SD_DEFAULT_CLUSTER_SIZE (32 * 1024)
+
+#if defined(DUMP_AT_COMMANDS)
 #include <StreamDebugger.h>
 StreamDebugger debugger(SerialAT, Serial);
-TinyGsm modem(debugger);
+Stream& modemStream = debugger;
+#elif defined(CAPTURE_AT_COMMANDS)
+#include <StreamTrace.h>
+#define AT_TRACE_SIZE (256 * 1024)
+StreamTraceBuffer traceBuf;
+StreamTracer tracer(SerialAT, traceBuf);
+Stream& modemStream = tracer;
 #else
-TinyGsm modem(SerialAT);
+Stream& modemStream = SerialAT;
 #endif
+TinyGsm modem(modemStream);
 
 // I2S Pins
 #define I2S_BCLK      21
@@ -38,12 +65,54 @@ TinyGsm modem(SerialAT);
 // Audio Settings
 #define AUDIO_FILE_URL "https://messagesonhold.com.au/uploads/client-audio-wavs/ritz.mp3" 
 #define AUDIO_FILE_PATH "/holdfdfad_mus.mp3"
+// Downloads land here and replace AUDIO_FILE_PATH only once complete
+#define AUDIO_TEMP_PATH "/holdfdfad_mus.tmp"
 #define DOWNLOAD_CHECK_INTERVAL_MS (30 * 60 * 1000) 
+#define DOWNLOAD_CHECK_JITTER_PCT  15
+#define METRICS_LOG_PATH "/metrics.log"
+
+// Telemetry is queued locally and published when the modem is next online
+// #define TELEMETRY_MQTT_SERVER "broker.example.com"
+#define TELEMETRY_MQTT_PORT    1883
+#define TELEMETRY_TOPIC        "moh/telemetry"
+#define TELEMETRY_QOS          1
+#define TELEMETRY_SEND_MS      30000UL
+#define OUTBOX_RING_SIZE       (64 * 1024)
+#define OUTBOX_SPILL_PATH      "/outbox.bin"
 
 Audio audio;
 bool fileReady = false;
-unsigned long lastDownloadCheck = 0;
+UpdateScheduler scheduler(DOWNLOAD_CHECK_INTERVAL_MS, DOWNLOAD_CHECK_JITTER_PCT);
 uint8_t* psramBuf = nullptr;
+long lastDownloadBytes = 0;
+uint32_t sdClusterSize = SD_DEFAULT_CLUSTER_SIZE;
+MqttOutbox outbox;
+int8_t telemetryTopic = -1;
+
+// --- Metrics ---
+static const uint32_t AT_LATENCY_BOUNDS[] = { 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+static const uint32_t SD_FLUSH_BOUNDS[]   = { 10, 25, 50, 100, 250, 500, 1000, 2500, 5000 };
+static const uint8_t AT_LATENCY_NUM_BOUNDS = sizeof(AT_LATENCY_BOUNDS) / sizeof(AT_LATENCY_BOUNDS[0]);
+static const uint8_t SD_FLUSH_NUM_BOUNDS   = sizeof(SD_FLUSH_BOUNDS) / sizeof(SD_FLUSH_BOUNDS[0]);
+static_assert(AT_LATENCY_NUM_BOUNDS <= METRICS_MAX_BUCKETS && SD_FLUSH_NUM_BOUNDS <= METRICS_MAX_BUCKETS,
+              "Metrics would drop the upper histogram bounds");
+MetricHistogram* mAtLatency;
+MetricHistogram* mSdFlush;
+MetricCounter*   mAtTimeouts;
+MetricCounter*   mDlBytes;
+MetricCounter*   mDlOk;
+MetricCounter*   mDlFail;
+MetricCounter*   mUnderruns;
+MetricCounter*   mAudioEof;
+MetricCounter*   mTelemetryDropped;
+MetricGauge*     mDlBps;
+MetricGauge*     mModemBootMs;
+MetricGauge*     mCsq;
+MetricGauge*     mRsrp;
+MetricGauge*     mPoolHighWater;
+MetricGauge*     mPoolLargestFree;
+MetricGauge*     mPoolFailures;
+uint32_t atSentAt = 0;
 
 // Forward declarations
 void shutdownModem();
@@ -51,10 +120,17 @@ bool powerOnModem();
 bool connectNetwork();
 void disconnectNetwork();
 bool downloadAudioFile();
-void checkForNewAudio();
+void checkForNewAudio(bool force = false);
+int8_t modemLocalHour();
+void registerMetrics();
+void logMetrics();
+void dumpAtTrace();
+uint32_t measureSdCluster();
+void sendTelemetry();
 
 void setup() {
     Serial.begin(115200);
+    registerMetrics();
     Serial.println("\n=== Music On Hold Device (1KB Chunk Version) ===\n");
 
     if (psramInit()) {
@@ -66,6 +142,18 @@ void setup() {
         while(1) delay(1000);
     }
 
+    // Reserve the I/O arena before anything else can fragment PSRAM
+    if (!TinyGsmPool::shared().begin(NULL, IO_POOL_SIZE)) {
+        Serial.println("I/O pool allocation failed, using heap");
+    }
+    TinyGsmPool::shared().report(Serial);
+
+#ifdef CAPTURE_AT_COMMANDS
+    uint8_t* traceMem = (uint8_t*)ps_malloc(AT_TRACE_SIZE);
+    if (traceMem) traceBuf.begin(traceMem, AT_TRACE_SIZE);
+    else Serial.println("AT trace buffer allocation failed, capture disabled");
+#endif
+
     pinMode(BOARD_POWERON_PIN, OUTPUT);
     digitalWrite(BOARD_POWERON_PIN, HIGH);
     delay(100);
@@ -77,6 +165,19 @@ void setup() {
         while(1) delay(1000);
     }
     Serial.println("SD card OK");
+    sdClusterSize = measureSdCluster();
+    Serial.print("SD cluster size: "); Serial.println(sdClusterSize);
+
+#ifdef TELEMETRY_MQTT_SERVER
+    const char* spillPath = OUTBOX_SPILL_PATH;
+#else
+    // Nothing will ever drain it, so keep only the newest snapshots in RAM
+    const char* spillPath = NULL;
+#endif
+    if (outbox.begin((uint8_t*)ps_malloc(OUTBOX_RING_SIZE), OUTBOX_RING_SIZE, spillPath)) {
+        telemetryTopic = outbox.addTopic(TELEMETRY_TOPIC, TELEMETRY_QOS, true);
+        Serial.print("Outbox pending: "); Serial.println(outbox.pendingRecords());
+    }
 
     Serial.println("Initializing I2S audio...");
     audio.setPinout(I2S_BCLK, I2S_LRC, I2S_DOUT);
@@ -88,7 +189,7 @@ void setup() {
         fileReady = true;
     } else {
         Serial.println("No audio file found, downloading...");
-        checkForNewAudio(); 
+        checkForNewAudio(true); 
     }
 
     if (fileReady) {
@@ -96,7 +197,8 @@ void setup() {
         audio.connecttoFS(SD, AUDIO_FILE_PATH);
     }
 
-    lastDownloadCheck = millis();
+    scheduler.begin(esp_random(), millis());
+    scheduler.printStats(Serial);
 }
 
 void loop() {
@@ -104,14 +206,23 @@ void loop() {
         audio.loop();
     }
 
-    if (millis() - lastDownloadCheck >= DOWNLOAD_CHECK_INTERVAL_MS) {
-        Serial.println("\n--- 30-minute check triggered ---");
+    if (scheduler.due(millis())) {
+        Serial.println("\n--- Scheduled check triggered ---");
         checkForNewAudio();
-        lastDownloadCheck = millis();
+        scheduler.printStats(Serial);
+        logMetrics();
+        dumpAtTrace();
+    }
+
+    // 'j' dumps a JSON metrics snapshot, 'b' the binary form
+    if (Serial.available()) {
+        int c = Serial.read();
+        if (c == 'j') { metrics.writeJson(Serial); Serial.println(); }
+        else if (c == 'b') { metrics.writeBinary(Serial); }
     }
 }
 
-void checkForNewAudio() {
+void checkForNewAudio(bool force) {
     bool wasPlaying = fileReady;
     
     if (wasPlaying) {
@@ -121,6 +232,7 @@ void checkForNewAudio() {
     if (!powerOnModem()) {
         Serial.println("Modem init failed");
         shutdownModem();
+        scheduler.recordFailure(millis());
         if (wasPlaying) audio.connecttoFS(SD, AUDIO_FILE_PATH);
         return;
     }
@@ -128,36 +240,73 @@ void checkForNewAudio() {
     if (!connectNetwork()) {
         Serial.println("Network connection failed");
         shutdownModem();
+        scheduler.recordFailure(millis());
         if (wasPlaying) audio.connecttoFS(SD, AUDIO_FILE_PATH);
         return;
     }
 
-    Serial.print("Allocating 512KB PSRAM buffer... ");
-    psramBuf = (uint8_t*)ps_malloc(LARGE_BUFFER_SIZE);
+    // Signal-quality gate: a download at CSQ 5 mostly times out, so wait
+    // for a better link instead of burning the modem awake
+    int16_t csq = modem.getSignalQuality();
+    String cpsi;
+    int16_t rsrp = modem.getSystemInformation(cpsi) ? UpdateScheduler::parseLteRsrp(cpsi) : 0;
+    int8_t hour = modemLocalHour();
+    mCsq->set(csq);
+    mRsrp->set(rsrp);
+    Serial.print("CSQ: "); Serial.print(csq);
+    Serial.print(" RSRP: "); Serial.print(rsrp);
+    Serial.print(" Hour: "); Serial.println(hour);
+
+    if (!force) {
+        UpdateScheduler::Verdict verdict = scheduler.admit(csq, rsrp, hour, millis());
+        if (verdict != UpdateScheduler::GO) {
+            Serial.println(verdict == UpdateScheduler::WEAK_SIGNAL ?
+                           "Signal too weak, postponing download" :
+                           "Slow time window, postponing download");
+            disconnectNetwork();
+            shutdownModem();
+            if (wasPlaying) audio.connecttoFS(SD, AUDIO_FILE_PATH);
+            return;
+        }
+    }
+
+    Serial.print("Allocating download buffer... ");
+    psramBuf = (uint8_t*)TINY_GSM_MALLOC(LARGE_BUFFER_SIZE);
     if (!psramBuf) {
         Serial.println("FAILED! Not enough PSRAM.");
         disconnectNetwork();
         shutdownModem();
+        scheduler.recordFailure(millis());
         if (wasPlaying) audio.connecttoFS(SD, AUDIO_FILE_PATH);
         return;
     }
     Serial.println("OK");
 
+    uint32_t downloadStart = millis();
     bool downloadSuccess = downloadAudioFile();
+    uint32_t downloadElapsed = millis() - downloadStart;
 
-    free(psramBuf);
+    TINY_GSM_FREE(psramBuf);
     psramBuf = nullptr;
 
+    sendTelemetry();
+
     disconnectNetwork();
     shutdownModem();
 
     if (downloadSuccess) {
+        scheduler.recordSuccess(lastDownloadBytes, downloadElapsed, hour, millis());
+        mDlOk->inc();
+        if (downloadElapsed) mDlBps->set((int32_t)(((uint64_t)lastDownloadBytes * 1000) / downloadElapsed));
         fileReady = true;
         Serial.println("Restarting playback with new file...");
         audio.connecttoFS(SD, AUDIO_FILE_PATH);
     } else {
+        scheduler.recordFailure(millis());
+        mDlFail->inc();
         Serial.println("Download failed, reverting to old file");
-        if (wasPlaying) audio.connecttoFS(SD, AUDIO_FILE_PATH);
+        // fileReady is cleared if the old file had to make room
+        if (wasPlaying && fileReady) audio.connecttoFS(SD, AUDIO_FILE_PATH);
     }
 }
 
@@ -193,11 +342,11 @@ bool downloadAudioFile() {
     }
 
     // Parse Status
-    SerialAT.readStringUntil(','); // Method
-    int status = SerialAT.parseInt(); // Status Code
-    SerialAT.readStringUntil(','); // Comma
-    long contentLength = SerialAT.parseInt(); // Length
-    SerialAT.readStringUntil('\n'); 
+    modemStream.readStringUntil(','); // Method
+    int status = modemStream.parseInt(); // Status Code
+    modemStream.readStringUntil(','); // Comma
+    long contentLength = modemStream.parseInt(); // Length
+    modemStream.readStringUntil('\n'); 
 
     Serial.print("Status: "); Serial.println(status);
     Serial.print("Size: "); Serial.println(contentLength);
@@ -208,14 +357,50 @@ bool downloadAudioFile() {
         return false;
     }
 
-    if (SD.exists(AUDIO_FILE_PATH)) SD.remove(AUDIO_FILE_PATH);
-    File file = SD.open(AUDIO_FILE_PATH, FILE_WRITE);
+    // The current file stays playable until the new one is complete; only
+    // give it up when the card cannot hold both
+    if (SD.exists(AUDIO_TEMP_PATH)) SD.remove(AUDIO_TEMP_PATH);
+    uint64_t freeBytes = SD.totalBytes() - SD.usedBytes();
+    if ((uint64_t)contentLength > freeBytes && SD.exists(AUDIO_FILE_PATH)) {
+        File old = SD.open(AUDIO_FILE_PATH, FILE_READ);
+        uint64_t oldSize = old ? old.size() : 0;
+        old.close();
+        if ((uint64_t)contentLength <= freeBytes + oldSize) {
+            Serial.println("Removing old file to make room");
+            SD.remove(AUDIO_FILE_PATH);
+            fileReady = false;
+            freeBytes += oldSize;
+        }
+    }
+    if ((uint64_t)contentLength > freeBytes) {
+        Serial.println("Not enough space on SD card");
+        modem.sendAT("+HTTPTERM");
+        return false;
+    }
+
+    File file = SD.open(AUDIO_TEMP_PATH, FILE_WRITE);
     if (!file) {
         Serial.println("SD Create Failed");
         modem.sendAT("+HTTPTERM");
         return false;
     }
 
+    // Pre-allocate the whole cluster chain in one go: seeking past EOF and
+    // writing the last byte makes FAT extend the file once, so the chain is
+    // laid out contiguously instead of being grown on every flush
+    if (!file.seek(contentLength - 1) || file.write((uint8_t)0) != 1 || !file.seek(0)) {
+        Serial.println("SD pre-allocation failed");
+        file.close();
+        SD.remove(AUDIO_TEMP_PATH);
+        modem.sendAT("+HTTPTERM");
+        return false;
+    }
+
+    // Flush in whole clusters; leave room for one more modem read so a short
+    // read can never push the buffer past its end
+    size_t flushThreshold = ((LARGE_BUFFER_SIZE - MODEM_READ_SIZE) / sdClusterSize) * sdClusterSize;
+    if (flushThreshold == 0) flushThreshold = LARGE_BUFFER_SIZE - MODEM_READ_SIZE;
+
     long totalDownloaded = 0;
     size_t bufferOffset = 0; 
 
@@ -234,21 +419,27 @@ bool downloadAudioFile() {
         // Loop to find the ACTUAL data header (skipping "OK" and phantom empty headers)
         while (len == 0 && millis() - loopStart < 5000) {
             if (modem.waitResponse(1000, GF("+HTTPREAD:")) == 1) {
-                len = SerialAT.parseInt();
-                SerialAT.readStringUntil('\n'); 
+                len = modemStream.parseInt();
+                modemStream.readStringUntil('\n'); 
             } else {
                 // Keep waiting or break if needed
             }
         }
 
+        if (len > (int)(LARGE_BUFFER_SIZE - bufferOffset)) {
+            Serial.println("Oversized read!");
+            break;
+        }
+
         if (len > 0) {
-            int bytesRecv = SerialAT.readBytes(psramBuf + bufferOffset, len);
+            int bytesRecv = modemStream.readBytes(psramBuf + bufferOffset, len);
             if (bytesRecv != len) {
                 Serial.println("Stream mismatch!");
                 break;
             }
             bufferOffset += len;
             totalDownloaded += len;
+            mDlBytes->inc(len);
         } else {
             Serial.println("Timeout waiting for data header");
             break;
@@ -259,30 +450,48 @@ bool downloadAudioFile() {
         modem.waitResponse(200, GF("+HTTPREAD: 0"));
 
         // Flush PSRAM to SD if full or finished
-        if (bufferOffset >= LARGE_BUFFER_SIZE || totalDownloaded == contentLength) {
-            Serial.print("Flushing "); Serial.print(bufferOffset); Serial.print(" bytes... ");
-            if (file.write(psramBuf, bufferOffset) != bufferOffset) {
+        if (bufferOffset >= flushThreshold || totalDownloaded == contentLength) {
+            // Only the final flush may end mid-cluster; a partial cluster
+            // is carried over to the front of the buffer
+            size_t flushLen = bufferOffset;
+            if (totalDownloaded != contentLength) flushLen -= bufferOffset % sdClusterSize;
+            Serial.print("Flushing "); Serial.print(flushLen); Serial.print(" bytes... ");
+            uint32_t flushStart = millis();
+            if (file.write(psramBuf, flushLen) != flushLen) {
                 Serial.println("SD Fail");
                 break;
             }
+            mSdFlush->record(millis() - flushStart);
             Serial.println("OK");
-            bufferOffset = 0;
+            memmove(psramBuf, psramBuf + flushLen, bufferOffset - flushLen);
+            bufferOffset -= flushLen;
             Serial.print("Progress: "); Serial.print(totalDownloaded);
             Serial.print("/"); Serial.println(contentLength);
         }
     }
 
+    bool complete = (totalDownloaded == contentLength);
     file.close();
     modem.sendAT("+HTTPTERM");
     modem.waitResponse();
 
-    Serial.println("\nDownload finished");
-    return (totalDownloaded == contentLength);
+    // A partial file is already full length (pre-allocated), so it must
+    // never take the place of the audio file
+    if (complete) {
+        if (SD.exists(AUDIO_FILE_PATH)) SD.remove(AUDIO_FILE_PATH);
+        complete = SD.rename(AUDIO_TEMP_PATH, AUDIO_FILE_PATH);
+    }
+    if (!complete) SD.remove(AUDIO_TEMP_PATH);
+
+    Serial.println(complete ? "\nDownload finished" : "\nDownload incomplete, discarded");
+    lastDownloadBytes = totalDownloaded;
+    return complete;
 }
 
 // --- Helper Functions ---
 bool powerOnModem() {
     Serial.println("\n--- Powering On Modem ---");
+    uint32_t bootStart = millis();
     SerialAT.begin(115200, SERIAL_8N1, MODEM_RX_PIN, MODEM_TX_PIN);
     pinMode(MODEM_DTR_PIN, OUTPUT); digitalWrite(MODEM_DTR_PIN, LOW);
     pinMode(BOARD_PWRKEY_PIN, OUTPUT); digitalWrite(BOARD_PWRKEY_PIN, LOW);
@@ -317,6 +526,9 @@ bool powerOnModem() {
     delay(100);
     SerialAT.updateBaudRate(921600);
     delay(100);
+    // Fresh modem boot: SSL contexts have to be bound again
+    modem.cert_forget();
+    mModemBootMs->set(millis() - bootStart);
     return true;
 }
 
@@ -333,12 +545,144 @@ void disconnectNetwork() {
     modem.sendAT("+NETCLOSE"); modem.waitResponse(5000);
 }
 
+// Local hour from the network clock (+CCLK), -1 if the modem has no time yet
+int8_t modemLocalHour() {
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    float timezone = 0;
+    if (!modem.getNetworkTime(&year, &month, &day, &hour, &minute, &second, &timezone)) return -1;
+    // The modem reports 1970/2070 until NITZ has been received
+    if (year < 2024 || year >= 2070) return -1;
+    return (int8_t)hour;
+}
+
+void registerMetrics() {
+    mAtLatency   = metrics.histogram("at_latency_ms", AT_LATENCY_BOUNDS, AT_LATENCY_NUM_BOUNDS);
+    mSdFlush     = metrics.histogram("sd_flush_ms", SD_FLUSH_BOUNDS, SD_FLUSH_NUM_BOUNDS);
+    mAtTimeouts  = metrics.counter("at_timeouts");
+    mDlBytes     = metrics.counter("dl_bytes");
+    mDlOk        = metrics.counter("dl_ok");
+    mDlFail      = metrics.counter("dl_fail");
+    mUnderruns   = metrics.counter("audio_underruns");
+    mAudioEof    = metrics.counter("audio_eof");
+    mTelemetryDropped = metrics.counter("telemetry_dropped");
+    mDlBps       = metrics.gauge("dl_bps");
+    mModemBootMs = metrics.gauge("modem_boot_ms");
+    mCsq         = metrics.gauge("csq");
+    mRsrp        = metrics.gauge("rsrp_dbm");
+    mPoolHighWater   = metrics.gauge("pool_high_water");
+    mPoolLargestFree = metrics.gauge("pool_largest_free");
+    mPoolFailures    = metrics.gauge("pool_failures");
+}
+
+void metricsAtSent() {
+    atSentAt = millis();
+    if (atSentAt == 0) atSentAt = 1;
+}
+
+// Only the first response after a command counts; later waits are for URCs
+void metricsAtResponse(int8_t index) {
+    if (!atSentAt) return;
+    if (index == 0) mAtTimeouts->inc();
+    else mAtLatency->record(millis() - atSentAt);
+    atSentAt = 0;
+}
+
+// Append one JSON line per check to the SD log
+void logMetrics() {
+    TinyGsmPool& pool = TinyGsmPool::shared();
+    pool.report(Serial);
+    mPoolHighWater->set(pool.highWater());
+    mPoolLargestFree->set(pool.largestFree());
+    mPoolFailures->set(pool.failures());
+
+    File log = SD.open(METRICS_LOG_PATH, FILE_APPEND);
+    if (!log) return;
+    metrics.writeJson(log);
+    log.println();
+    log.close();
+
+    // Same snapshot goes out over MQTT on the next connection; the buffer
+    // matches the largest record the outbox takes
+    static char snapshot[OUTBOX_MAX_BATCH + 1];
+    if (!metrics.snapshotJson(snapshot, sizeof(snapshot))) {
+        Serial.println("Metrics snapshot too large for telemetry, not queued");
+        mTelemetryDropped->inc();
+    } else if (!outbox.enqueue(telemetryTopic, snapshot)) {
+        Serial.println("Telemetry snapshot could not be queued");
+        mTelemetryDropped->inc();
+    }
+}
+
+#ifdef TELEMETRY_MQTT_SERVER
+int publishTelemetry(const char* topic, const uint8_t* payload, size_t len, uint8_t qos) {
+    return modem.mqtt_publish_wait(0, topic, payload, len, qos);
+}
+#endif
+
+// Drain the outbox in one burst while the modem is already awake
+void sendTelemetry() {
+#ifdef TELEMETRY_MQTT_SERVER
+    if (!outbox.pendingRecords()) return;
+    Serial.print("Sending telemetry, queued records: "); Serial.println(outbox.pendingRecords());
+    if (!modem.mqtt_begin(false)) return;
+    String clientId = "moh-" + modem.getIMEI();
+    if (modem.mqtt_connect(0, TELEMETRY_MQTT_SERVER, TELEMETRY_MQTT_PORT, clientId.c_str())) {
+        // Anything not acknowledged stays queued for next time
+        outbox.flush(publishTelemetry, TELEMETRY_SEND_MS);
+        modem.mqtt_disconnect(0);
+    } else {
+        Serial.println("MQTT connect failed");
+    }
+    modem.mqtt_end();
+    Serial.print("Telemetry left queued: "); Serial.println(outbox.pendingRecords());
+#endif
+}
+
+// FAT cluster size of the mounted card, the natural unit for SD writes.
+// SD doesn't say which FatFs drive it mounted, so pick the volume whose
+// size matches SD.totalBytes() (computed the same way by the SD library)
+uint32_t measureSdCluster() {
+    for (uint8_t pdrv = 0; pdrv < FF_VOLUMES; pdrv++) {
+        char drv[3] = { (char)('0' + pdrv), ':', 0 };
+        FATFS* fs = nullptr;
+        DWORD freeClusters = 0;
+        if (f_getfree(drv, &freeClusters, &fs) != FR_OK || !fs || !fs->csize) continue;
+#if FF_MAX_SS != FF_MIN_SS
+        uint32_t cluster = (uint32_t)fs->csize * fs->ssize;
+#else
+        uint32_t cluster = (uint32_t)fs->csize * FF_MAX_SS;
+#endif
+        if ((uint64_t)cluster * (fs->n_fatent - 2) == SD.totalBytes()) return cluster;
+    }
+    return SD_DEFAULT_CLUSTER_SIZE;
+}
+
+// Write the captured AT session to its own file; a no-op without CAPTURE_AT_COMMANDS
+void dumpAtTrace() {
+#ifdef CAPTURE_AT_COMMANDS
+    if (!traceBuf.used()) return;
+    char path[32];
+    snprintf(path, sizeof(path), "/at_%lu.trc", millis());
+    File trc = SD.open(path, FILE_WRITE);
+    if (!trc) return;
+    Serial.print("AT trace: "); Serial.print(traceBuf.used());
+    Serial.print(" bytes, dropped records: "); Serial.print(traceBuf.dropped());
+    Serial.print(" -> "); Serial.println(path);
+    traceBuf.dump(trc);
+    trc.close();
+#endif
+}
+
 void shutdownModem() {
     digitalWrite(BOARD_PWRKEY_PIN, LOW); delay(100);
     digitalWrite(BOARD_PWRKEY_PIN, HIGH); delay(3000);
     digitalWrite(BOARD_PWRKEY_PIN, LOW); delay(1000);
 }
 
-void audio_eof_mp3(const char *info) { audio.connecttoFS(SD, AUDIO_FILE_PATH); }
-void audio_eof_speech(const char *info) { audio.connecttoFS(SD, AUDIO_FILE_PATH); }
-void audio_info(const char *info) { Serial.print("Audio: "); Serial.println(info); }
\ No newline at end of file
+void audio_eof_mp3(const char *info) { mAudioEof->inc(); audio.connecttoFS(SD, AUDIO_FILE_PATH); }
+void audio_eof_speech(const char *info) { mAudioEof->inc(); audio.connecttoFS(SD, AUDIO_FILE_PATH); }
+void audio_info(const char *info) {
+    // The decoder reports starvation as "slow stream, dropouts are possible"
+    if (strstr(info, "slow stream") || strstr(info, "dropout")) mUnderruns->inc();
+    Serial.print("Audio: "); Serial.println(info);
+}
\ No newline at end of file